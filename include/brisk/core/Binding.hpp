@@ -74,9 +74,9 @@ struct BindingAddress {
     constexpr bool operator==(const BindingAddress&) const noexcept = default;
 
     friend BindingAddress mergeAddresses(std::convertible_to<BindingAddress> auto... addresses) {
-        size_t sum         = (addresses->size + ...);
-        const uint8_t* min = std::min({ addresses->min()... });
-        const uint8_t* max = std::max({ addresses->max()... });
+        size_t sum         = (BindingAddress(addresses).size + ...);
+        const uint8_t* min = std::min({ BindingAddress(addresses).min()... });
+        const uint8_t* max = std::max({ BindingAddress(addresses).max()... });
         if (max - min == sum) {
             return { min, sum };
         }
@@ -2090,7 +2090,26 @@ public:
     }
 
     static void* operator new(size_t sz) {
-        void* ptr = alignedAlloc(sz, cacheAlignment);
+        return registerInstance(alignedAlloc(sz, cacheAlignment), sz);
+    }
+
+    static void operator delete(void* ptr) {
+        unregisterInstance(ptr);
+        alignedFree(ptr);
+    }
+
+    BindingLifetime lifetime() const noexcept {
+        return lifetimeOf(this);
+    }
+
+protected:
+    /**
+     * @brief Registers the memory of a new instance as a binding region.
+     *
+     * Derived classes that replace operator new call this for the memory they allocate.
+     * @return ptr
+     */
+    static void* registerInstance(void* ptr, size_t sz) {
         Rc<Scheduler> sched;
         BRISK_CLANG_PRAGMA(GCC diagnostic push)
         BRISK_CLANG_PRAGMA(GCC diagnostic ignored "-Wpointer-bool-conversion")
@@ -2102,13 +2121,11 @@ public:
         return ptr;
     }
 
-    static void operator delete(void* ptr) {
+    /**
+     * @brief Unregisters the region registered by registerInstance.
+     */
+    static void unregisterInstance(void* ptr) {
         bindings->unregisterRegion(reinterpret_cast<uint8_t*>(ptr));
-        alignedFree(ptr);
-    }
-
-    BindingLifetime lifetime() const noexcept {
-        return lifetimeOf(this);
     }
 };
 
@@ -223,6 +223,15 @@ inline std::u16string utf32ToUtf16(U32StringView text, UtfPolicy policy = UtfPol
     return utfToUtf<char16_t, char32_t>(text, policy);
 }
 
+/**
+ * @brief Converts UTF-32 text to UTF-16, reusing the storage of an existing string.
+ *
+ * @param result The string that receives the converted text. Its previous content is replaced.
+ * @param text A UTF-32 encoded string view.
+ * @param policy The policy to handle invalid characters.
+ */
+void utf32ToUtf16(std::u16string& result, U32StringView text, UtfPolicy policy = UtfPolicy::Default);
+
 /**
  * @brief Converts wide character string (wchar_t) to UTF-8.
  *
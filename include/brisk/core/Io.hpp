@@ -265,6 +265,45 @@ constexpr inline bool isBitFlags<OpenFileMode> = true;
  */
 [[nodiscard]] expected<Bytes, IoError> readBytes(const fs::path& file_name);
 
+/**
+ * @brief Read-only view of a file mapped into memory.
+ *
+ * Pages are loaded by the OS on first access, so mapping a large file costs
+ * nothing until its contents are read, and mappings of the same file share
+ * physical memory between processes. The view remains valid for the lifetime
+ * of the object.
+ */
+class MappedFile {
+public:
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /**
+     * @brief Returns the contents of the file.
+     */
+    BytesView data() const noexcept {
+        return m_data;
+    }
+
+private:
+    friend expected<Rc<MappedFile>, IoError> mapFile(const fs::path& file_name);
+    MappedFile() = default;
+    BytesView m_data;
+    void* m_handle = nullptr;
+};
+
+/**
+ * @brief Maps the entire file into memory for reading.
+ *
+ * Unlike `readBytes`, the file is not copied. Mapping an empty file succeeds
+ * and yields an empty view.
+ *
+ * @param file_name The path to the file to be mapped.
+ * @return An `expected` object containing the mapping or an I/O error.
+ */
+[[nodiscard]] expected<Rc<MappedFile>, IoError> mapFile(const fs::path& file_name);
+
 /**
  * @brief Reads the entire file as a UTF-8 encoded string.
  *
@@ -414,6 +453,9 @@ enum class DefaultFolder {
     AppUserData,   ///< App-specific folder inside the User Data folder.
     AppSystemData, ///< App-specific folder inside the System Data folder.
     AppHome,       ///< App-specific folder inside user's Home folder.
+
+    Cache,    ///< The user's cache folder. Its contents may be deleted by the OS or the user.
+    AppCache, ///< App-specific folder inside the Cache folder.
 };
 
 constexpr auto operator+(DefaultFolder value) noexcept {
@@ -46,7 +46,12 @@ namespace Internal {
 struct RcNew {
     template <typename T>
     Rc<T> operator*(T* rawPtr) const {
-        return Rc<T>(rawPtr);
+        if constexpr (requires { typename T::RcAllocator; }) {
+            // Lets the type place the control block alongside the instance
+            return Rc<T>(rawPtr, std::default_delete<T>{}, typename T::RcAllocator{ rawPtr });
+        } else {
+            return Rc<T>(rawPtr);
+        }
     }
 };
 
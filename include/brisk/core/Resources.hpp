@@ -21,6 +21,7 @@
 #pragma once
 
 #include <map>
+#include <optional>
 #include <brisk/core/BasicTypes.hpp>
 #include <brisk/core/Compression.hpp>
 #include <brisk/core/internal/Resources.h>
@@ -110,6 +111,19 @@ public:
             BytesView((const std::byte*)rsrc->data, (const std::byte*)rsrc->data + *rsrc->size));
     }
 
+    /**
+     * @brief Returns a view of a resource that is stored uncompressed.
+     * @param name The name of the resource.
+     * @return A view of the embedded data without copying, or `std::nullopt` if the resource
+     * is missing or compressed.
+     */
+    static std::optional<BytesView> view(std::string_view name) {
+        const Internal::ResourceEntry* rsrc = Internal::lookupResource(name);
+        if (!rsrc || rsrc->compression != Internal::ResourceCompression::None)
+            return std::nullopt;
+        return BytesView((const std::byte*)rsrc->data, (const std::byte*)rsrc->data + *rsrc->size);
+    }
+
     /**
      * @brief Loads a resource as raw bytes with caching.
      * @param name The name of the resource to load.
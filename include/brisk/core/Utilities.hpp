@@ -847,6 +847,71 @@ struct ClonablePtr {
     T* m_ptr;
 };
 
+/**
+ * @brief Owning pointer that may be null and copies the object when copied.
+ *
+ * Used for state that most owners never need, so that it takes a single pointer until allocated.
+ */
+template <typename T>
+struct OptionalClonablePtr {
+    OptionalClonablePtr() noexcept = default;
+
+    OptionalClonablePtr(OptionalClonablePtr&&) noexcept = default;
+
+    OptionalClonablePtr(const OptionalClonablePtr& ptr)
+        : m_ptr(ptr.m_ptr ? std::make_unique<T>(*ptr.m_ptr) : nullptr) {}
+
+    OptionalClonablePtr& operator=(OptionalClonablePtr&&) noexcept = default;
+
+    OptionalClonablePtr& operator=(const OptionalClonablePtr& ptr) {
+        if (this != &ptr)
+            m_ptr = ptr.m_ptr ? std::make_unique<T>(*ptr.m_ptr) : nullptr;
+        return *this;
+    }
+
+    explicit operator bool() const noexcept {
+        return m_ptr != nullptr;
+    }
+
+    /// @brief Returns the object, creating it if needed.
+    T& emplace() {
+        if (!m_ptr)
+            m_ptr = std::make_unique<T>();
+        return *m_ptr;
+    }
+
+    void reset() noexcept {
+        m_ptr.reset();
+    }
+
+    const T& operator*() const noexcept {
+        return *m_ptr;
+    }
+
+    T& operator*() noexcept {
+        return *m_ptr;
+    }
+
+    const T* operator->() const noexcept {
+        return m_ptr.get();
+    }
+
+    T* operator->() noexcept {
+        return m_ptr.get();
+    }
+
+    const T* get() const noexcept {
+        return m_ptr.get();
+    }
+
+    T* get() noexcept {
+        return m_ptr.get();
+    }
+
+private:
+    std::unique_ptr<T> m_ptr;
+};
+
 /**
  * @class ENullDeref
  * @brief Exception thrown when attempting to dereference a null pointer.
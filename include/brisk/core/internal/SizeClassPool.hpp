@@ -0,0 +1,93 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#pragma once
+
+#include <brisk/core/Memory.hpp>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace Brisk {
+
+namespace Internal {
+
+/**
+ * @brief Statistics of a SizeClassPool.
+ */
+struct SizeClassPoolStat {
+    size_t numBlocks;     ///< Number of blocks currently handed out.
+    size_t retainedBytes; ///< Total size of the freed blocks kept for reuse.
+    bool operator==(const SizeClassPoolStat&) const noexcept = default;
+};
+
+/**
+ * @brief Thread-safe free lists of memory blocks grouped by size class.
+ *
+ * Sizes are rounded up to a multiple of `granularity`, which is also the alignment of every block. A
+ * freed block goes to the free list of its class and is handed out again by the next allocation of the
+ * same class. At most `maxRetained` bytes are kept in the free lists, blocks freed beyond that are
+ * returned to the system, so a burst of allocations does not pin its peak memory. Sizes larger than
+ * `granularity * numClasses` bypass the free lists.
+ */
+class SizeClassPool {
+public:
+    SizeClassPool(size_t granularity, size_t numClasses, size_t maxRetained);
+    ~SizeClassPool();
+
+    SizeClassPool(const SizeClassPool&)            = delete;
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    /**
+     * @brief Allocates a block of at least `size` bytes aligned to the pool's granularity.
+     */
+    [[nodiscard]] void* allocate(size_t size);
+
+    /**
+     * @brief Returns a block to the pool.
+     * @param size The size passed to `allocate`.
+     */
+    void deallocate(void* ptr, size_t size) noexcept;
+
+    /**
+     * @brief Returns all retained blocks to the system.
+     */
+    void trim() noexcept;
+
+    SizeClassPoolStat stat() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    const size_t m_granularity;
+    const size_t m_maxRetained;
+    mutable std::mutex m_mutex;
+    std::vector<FreeBlock*> m_freeLists;
+    size_t m_numBlocks     = 0;
+    size_t m_retainedBytes = 0;
+
+    size_t classIndex(size_t size) const noexcept;
+};
+
+} // namespace Internal
+
+} // namespace Brisk
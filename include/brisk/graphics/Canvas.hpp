@@ -994,6 +994,8 @@ private:
                          RenderStateExArgs args);
     void drawColorSprites(SpriteResources sprites, std::span<const GeometryGlyph> glyphs,
                           RenderStateExArgs args);
+    void drawSdfTextSprites(SpriteResources sprites, std::span<const GeometryGlyph> glyphs,
+                            RenderStateExArgs args);
 };
 
 } // namespace Brisk
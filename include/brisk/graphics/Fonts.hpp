@@ -24,6 +24,8 @@
 #include <brisk/core/Stream.hpp>
 #include <brisk/core/Hash.hpp>
 #include <mutex>
+#include <atomic>
+#include <bitset>
 #include "Color.hpp"
 #include <brisk/core/internal/SmallVector.hpp>
 #include "internal/OpenType.hpp"
@@ -201,6 +203,21 @@ namespace Internal {
 struct FontFace;
 struct GlyphData;
 struct TextRun;
+struct TextGeometryCache;
+struct GlyphRasterizer;
+struct ColorGlyphCache;
+
+/**
+ * @brief Font size at which signed distance field glyphs are rasterized.
+ */
+constexpr inline float sdfReferenceSize = 48.f;
+
+/**
+ * @brief Distance, in pixels at `sdfReferenceSize`, covered by the SDF value range.
+ *
+ * Must match `sdfSpread` in the shaders.
+ */
+constexpr inline int sdfSpread = 8;
 
 /**
  * @brief Represents a segment of text with uniform properties such as direction and font face.
@@ -424,6 +441,13 @@ struct GlyphData {
      * whitespace.
      */
     float advance_x;
+
+    /**
+     * @brief Scale at which the sprite is drawn.
+     *
+     * Color glyphs are rasterized at a quantized font size and scaled to the requested one.
+     */
+    float scale = 1.f;
 };
 
 using GlyphList = SmallVector<Glyph, 1>;
@@ -556,6 +580,20 @@ struct GlyphRun {
     int hscale() const noexcept;
     bool hasColor() const noexcept;
 
+    /**
+     * @brief Indicates whether glyphs of this run are rendered from signed distance fields.
+     *
+     * Decided when the run is shaped, so FontManager::setSdfGlyphs does not affect existing runs.
+     */
+    bool sdf = false;
+
+    /**
+     * @brief Checks whether glyphs of this run are rendered from signed distance fields.
+     *
+     * SDF glyphs are rasterized once at `Internal::sdfReferenceSize` and scaled to `fontSize` when drawn.
+     */
+    bool isSdf() const noexcept;
+
     /**
      * @brief Returns the bounds of the glyph run.
      *
@@ -650,15 +688,16 @@ struct PreparedText {
      * @brief The caret positions for each grapheme boundary.
      *
      * This vector is populated by `updateCaretData` and contains one entry per grapheme boundary.
+     * It is computed on first use by `caretToGrapheme`, `graphemeToCaret` and `graphemeToLine`.
      */
-    std::vector<float> caretPositions;
+    mutable std::vector<float> caretPositions;
 
     /**
      * @brief The ranges of horizontal positions for each grapheme.
      *
      * This vector is populated by `updateCaretData` and contains one entry per grapheme.
      */
-    std::vector<InclusiveRange<float>> ranges;
+    mutable std::vector<InclusiveRange<float>> ranges;
 
     bool hasCaretData() const noexcept;
 
@@ -704,6 +743,13 @@ struct PreparedText {
         bool empty() const noexcept {
             return runRange.empty();
         }
+
+        /**
+         * @brief Returns the vertical extent of the line, relative to the baseline of the first line.
+         */
+        Range<float> verticalRange() const noexcept {
+            return { baseline - ascDesc.ascender, baseline + ascDesc.descender };
+        }
     };
 
     /**
@@ -711,13 +757,44 @@ struct PreparedText {
      */
     std::vector<GlyphLine> lines;
 
+    /**
+     * @brief Glyph geometry and sprites built by `Canvas::fillText`, reused while the text is unchanged.
+     *
+     * Reset by member functions that move glyphs. Call `invalidateGeometry` after modifying
+     * `runs` directly.
+     */
+    mutable Rc<Internal::TextGeometryCache> geometryCache;
+
+    /**
+     * @brief Horizontal alignment factor last applied by `alignLines`, NaN if the lines were not aligned.
+     */
+    float alignedX = std::numeric_limits<float>::quiet_NaN();
+
+    /**
+     * @brief Drops the cached glyph geometry and forgets the applied alignment.
+     */
+    void invalidateGeometry() noexcept {
+        geometryCache.reset();
+        alignedX = std::numeric_limits<float>::quiet_NaN();
+    }
+
     /**
      * @brief Updates the caret positions and horizontal ranges for graphemes.
      *
      * This function calculates and fills the `caretPositions` and `ranges` fields based on the current text
-     * properties.
+     * properties. Calling it is optional: caret queries compute the data on demand.
+     */
+    void updateCaretData() const;
+
+    /**
+     * @brief Computes the caret data if it has not been computed yet.
      */
-    void updateCaretData();
+    void ensureCaretData() const;
+
+    /**
+     * @brief Drops the caret data so that it is recomputed on next use.
+     */
+    void invalidateCaretData() noexcept;
 
     /**
      * @brief Maps a point to the nearest grapheme boundary.
@@ -743,6 +820,14 @@ struct PreparedText {
 
     uint32_t graphemeToLine(uint32_t graphemeIndex) const;
 
+    /**
+     * @brief Returns the range of lines whose vertical extent intersects `[top, bottom)`.
+     *
+     * Coordinates are relative to the baseline of the first line. Lines are laid out top to bottom,
+     * so the range is found by binary search.
+     */
+    Range<uint32_t> linesInRange(float top, float bottom) const;
+
     /**
      * @brief Maps a vertical position to the nearest text line.
      *
@@ -810,6 +895,9 @@ struct PreparedText {
      * horizontal and vertical offsets. Apply the returned offset when painting PreparedText for proper
      * vertical alignment.
      *
+     * Realigning with the same factors leaves the glyphs in place and keeps the cached geometry. Caret data
+     * computed before the runs move is updated.
+     *
      * @param alignment_x Horizontal alignment factor (0: left, 0.5: center, 1: right).
      * @param alignment_y Vertical alignment factor (0: top, 0.5: center, 1: bottom).
      * @return PointF Offsets for alignment.
@@ -1048,6 +1136,7 @@ enum class FontFlags {
     DisableHinting   = 2,
     DisableLigatures = 4,
     EnableColor      = 8,
+    SdfGlyphs        = 16, ///< Render glyphs from signed distance fields (see FontManager::setSdfGlyphs)
 };
 
 template <>
@@ -1119,22 +1208,44 @@ public:
 
     /**
      * @brief Adds a font from a file.
+     *
+     * The file is memory-mapped rather than read, and the mapping is shared by all faces
+     * loaded from the same file.
      * @param fontFamily The font family name.
      * @param style The font style.
      * @param weight The font weight.
      * @param path Filesystem path to the font file.
+     * @param faceIndex Index of the face within a font collection (.ttc).
      * @return Status indicating success or an IoError on failure.
      */
     [[nodiscard]] status<IoError> addFontFromFile(std::string fontFamily, FontStyle style, FontWeight weight,
-                                                  const fs::path& path);
+                                                  const fs::path& path, uint32_t faceIndex = 0);
 
     /**
      * @brief Retrieves a list of installed system fonts.
+     *
+     * Font files are read in the thread pool and the results are stored in an index file,
+     * so later scans only read files whose size or modification time changed.
+     * @note The first scan writes the index to `defaultFontIndexPath()` unless another path was set with
+     * `setFontIndexPath`. Set an empty path to keep the index in memory only.
      * @param rescan Whether to rescan the system for fonts (default: false).
      * @return Vector of OsFont objects representing installed fonts.
      */
     [[nodiscard]] std::vector<OsFont> installedFonts(bool rescan = false) const;
 
+    /**
+     * @brief Sets the file used to cache the results of `installedFonts`.
+     *
+     * Defaults to `defaultFontIndexPath()`. Takes effect on the next scan.
+     * @param path Path to the index file, or an empty path to disable the index.
+     */
+    void setFontIndexPath(fs::path path);
+
+    /**
+     * @brief Returns the default font index file inside `DefaultFolder::AppCache`.
+     */
+    static fs::path defaultFontIndexPath();
+
     /**
      * @brief Gets available styles and weights for a font family.
      * @param fontFamily The font family to query.
@@ -1169,6 +1280,10 @@ public:
 
     /**
      * @brief Calculates the bounding rectangle for text with a single font.
+     *
+     * Simple text is measured from cached advances without building glyph runs. Results are
+     * memoized per font and text, so repeated measurement (e.g. when auto-sizing labels) is cheap.
+     *
      * @param font The font to use.
      * @param text Text with rendering options.
      * @param boundsType Type of bounds to calculate (default: GlyphRunBounds::Alignment).
@@ -1214,6 +1329,78 @@ public:
         return m_hscale;
     }
 
+    /**
+     * @brief Enables or disables signed distance field glyphs for all scalable fonts.
+     *
+     * When enabled, each glyph is rasterized once as a distance field and drawn at any size
+     * from that single sprite instead of being rasterized again for every font size.
+     * This suits animated or zoomed text; small static text looks sharper with the default mode.
+     * SDF glyphs can also be enabled per font face with `FontFlags::SdfGlyphs`.
+     * Has no effect if the FreeType build lacks the `sdf` module.
+     */
+    void setSdfGlyphs(bool enable);
+
+    /**
+     * @brief Returns whether signed distance field glyphs are enabled globally.
+     */
+    bool sdfGlyphs() const;
+
+    /**
+     * @brief Enables or disables rasterization of color glyphs on a background thread.
+     *
+     * Color (SVG) glyphs are slow to render. When enabled, a glyph that is not cached yet is drawn as a
+     * translucent placeholder box while a worker thread rasterizes it; `glyphGeneration` is incremented once
+     * it becomes available. Disabled by default so that offscreen rendering stays deterministic.
+     */
+    void setAsyncColorGlyphs(bool enable);
+
+    /**
+     * @brief Returns a counter that is incremented whenever glyphs rasterized in the background are added
+     * to the cache.
+     *
+     * Anything painted with placeholder glyphs must be repainted when the counter changes.
+     */
+    uint32_t glyphGeneration() const noexcept {
+        return m_glyphGeneration.load(std::memory_order::relaxed);
+    }
+
+    /**
+     * @brief Shapes the text and rasterizes its glyphs ahead of the first frame.
+     *
+     * Useful for populating the glyph cache before calling `saveGlyphCache`.
+     * @param font The font to use.
+     * @param text The text whose glyphs should be rasterized.
+     */
+    void prewarmGlyphs(const Font& font, std::u32string_view text) const;
+
+    /**
+     * @brief Writes the rasterized glyphs of all loaded fonts to a cache file.
+     *
+     * Glyphs are keyed by a hash of the font data, the font size and the rendering flags
+     * (hinting, oversampling, SDF), so the file stays valid when fonts are updated or a different
+     * set of fonts is loaded. Glyphs from a previously loaded cache file are carried over while their
+     * fonts are loaded. The file is replaced atomically and then mapped as if by `loadGlyphCache`.
+     * @param path Path to the cache file.
+     * @return Status indicating success or an IoError on failure.
+     */
+    [[nodiscard]] status<IoError> saveGlyphCache(const fs::path& path = defaultGlyphCachePath());
+
+    /**
+     * @brief Maps a glyph cache file written by `saveGlyphCache`.
+     *
+     * Nothing is read up front: a glyph is copied out of the mapping the first time it is needed
+     * instead of being rasterized by FreeType.
+     * @param path Path to the cache file.
+     * @return Status indicating success, or IoError::UnsupportedFormat if the file was written by
+     * an incompatible version.
+     */
+    [[nodiscard]] status<IoError> loadGlyphCache(const fs::path& path = defaultGlyphCachePath());
+
+    /**
+     * @brief Returns the default glyph cache file inside `DefaultFolder::AppCache`.
+     */
+    static fs::path defaultGlyphCachePath();
+
     // Internal use only
     void garbageCollectCache();
 
@@ -1231,16 +1418,71 @@ private:
 
     mutable std::unordered_map<Internal::ShapingCacheKey, ShapeCacheEntry, FastHash> m_shapeCache;
     mutable uint64_t m_cacheCounter = 0;
+
+    // Text, alignment and printable bounds of measured text
+    struct TextExtents {
+        RectangleF text;
+        RectangleF alignment;
+        RectangleF printable;
+        RectangleF bounds(GlyphRunBounds boundsType) const;
+    };
+
+    struct MeasureCacheEntry {
+        TextExtents extents;
+        uint64_t counter;
+    };
+
+    mutable std::unordered_map<Internal::ShapingCacheKey, MeasureCacheEntry, FastHash> m_measureCache;
+    mutable uint64_t m_measureCounter = 0;
     int m_hscale;
+    std::atomic_bool m_sdfGlyphs{ false };
+    bool m_sdfSupported = false;
     uint32_t m_cacheTimeMs;
+    Rc<MappedFile> m_glyphCacheFile;
+    fs::path m_glyphCacheFilePath;
+    std::map<fs::path, std::weak_ptr<MappedFile>> m_mappedFiles;
+    mutable std::optional<fs::path> m_fontIndexPath; // Default is resolved on first use
+    std::unique_ptr<Internal::GlyphRasterizer> m_rasterizer;
+    std::atomic<uint32_t> m_glyphGeneration{ 0 };
+    std::unique_ptr<Internal::ColorGlyphCache> m_colorGlyphs;
+    void evictColorGlyphs(size_t maxBytes);
     std::vector<std::string_view> fontList(std::string_view ff) const;
     mutable std::vector<OsFont> m_osFonts;
+
+    // Codepoint to (face, glyph) resolution for 256 consecutive codepoints
+    struct CodepointBlock {
+        static constexpr uint8_t noFace = UINT8_MAX;
+        std::bitset<256> resolved;
+        std::array<uint8_t, 256> faceIndex;
+        std::array<GlyphId, 256> glyph;
+    };
+
+    // Font family list resolved to faces for one (family, style, weight) combination
+    struct FontChain {
+        std::vector<Internal::FontFace*> faces;
+        Internal::FontFace* primary = nullptr;
+        std::unordered_map<uint32_t, std::unique_ptr<CodepointBlock>> blocks;
+    };
+
+    mutable std::map<FontKey, FontChain, std::less<>> m_fontChains;
+    FontChain& fontChain(const Font& font) const;
+    void addFontFace(std::string fontFamily, FontStyle style, FontWeight weight,
+                     Rc<Internal::FontFace> fontFace);
+    void invalidateFontChains();
     Internal::FontFace* lookup(const Font& font) const;
     Internal::FontFace* findFontByKey(FontKey fontKey) const;
     std::pair<Internal::FontFace*, GlyphId> lookupCodepoint(const Font& font, char32_t codepoint,
                                                             bool fallbackToUndef) const;
+    std::pair<Internal::FontFace*, GlyphId> lookupCodepoint(FontChain& chain, char32_t codepoint,
+                                                            bool fallbackToUndef) const;
     FontMetrics getMetrics(const Font& font) const;
     static RectangleF glyphBounds(const Internal::Glyph& g, const Internal::GlyphData& d);
+    Internal::FontFace* simpleTextFace(const TextWithOptions& text, const Font& font, bool& latin) const;
+    std::optional<PreparedText> shapeSimpleText(const TextWithOptions& text,
+                                                const FontAndColor& fontAndColor) const;
+    std::optional<TextExtents> measureSimpleText(const TextWithOptions& text, const Font& font) const;
+    TextExtents doMeasure(const TextWithOptions& text, std::span<const FontAndColor> fonts,
+                          std::span<const uint32_t> offsets) const;
     PreparedText shapeRuns(const TextWithOptions& text, std::span<const FontAndColor> fonts,
                            std::span<const uint32_t> offsets,
                            const std::vector<Internal::TextRun>& textRuns) const;
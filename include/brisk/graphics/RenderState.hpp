@@ -239,7 +239,7 @@ public:
 
     BlendingCompositionMode mode = BlendingCompositionMode::Normal;
     bool hasBackTexture          = false;
-    uint8_t padding1             = 0;
+    bool sdfText                 = false; ///< Text sprites are signed distance fields
 
     uint32_t packed3             = 0;
 
@@ -23,6 +23,7 @@
 #include <brisk/core/Utilities.hpp>
 #include <brisk/core/internal/Debug.hpp>
 #include <brisk/core/Rc.hpp>
+#include <brisk/core/internal/SizeClassPool.hpp>
 #include <brisk/graphics/Geometry.hpp>
 #include <cstdint>
 
@@ -31,12 +32,16 @@ namespace Brisk {
 struct SpriteResource {
     uint64_t id;
     Size size;
+    const std::byte* external = nullptr; ///< Read-only pixels owned elsewhere, see makeSpriteView.
 
     std::byte* data() noexcept {
+        BRISK_ASSERT(!external);
         return std::launder(reinterpret_cast<std::byte*>(this)) + sizeof(SpriteResource);
     }
 
     const std::byte* data() const noexcept {
+        if (external)
+            return external;
         return std::launder(reinterpret_cast<const std::byte*>(this)) + sizeof(SpriteResource);
     }
 
@@ -49,12 +54,73 @@ struct SpriteResource {
     }
 };
 
+namespace Internal {
+
+/**
+ * @brief Returns the pool that sprites and their reference counters are allocated from.
+ *
+ * Glyph sprites are small and created in bursts, a new page of CJK text can bring thousands of them, so
+ * they are recycled through the pool instead of going to `malloc` one by one.
+ */
+SizeClassPool& spritePool();
+
+/**
+ * @brief Standard allocator that takes memory from `spritePool()`.
+ *
+ * Passed to `std::shared_ptr` so that control blocks of sprites are pooled too.
+ */
+template <typename T>
+struct SpritePoolAllocator {
+    using value_type = T;
+
+    SpritePoolAllocator() noexcept = default;
+
+    template <typename U>
+    SpritePoolAllocator(const SpritePoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(spritePool().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        spritePool().deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const SpritePoolAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+struct SpriteDeleter {
+    void operator()(SpriteResource* ptr) const noexcept {
+        const size_t size = sizeof(SpriteResource) + ptr->size.area();
+        ptr->~SpriteResource();
+        spritePool().deallocate(ptr, size);
+    }
+};
+
+struct SpriteViewDeleter {
+    Rc<const void> owner;
+
+    void operator()(SpriteResource* ptr) const noexcept {
+        ptr->~SpriteResource();
+        spritePool().deallocate(ptr, sizeof(SpriteResource));
+    }
+};
+
+} // namespace Internal
+
+/**
+ * @brief Allocates an uninitialized sprite of the given size.
+ *
+ * Both the sprite and its reference counter are allocated from `Internal::spritePool()`.
+ */
 inline Rc<SpriteResource> makeSprite(Size size) {
-    std::byte* ptr         = (std::byte*)::malloc(sizeof(SpriteResource) + size.area());
+    void* ptr              = Internal::spritePool().allocate(sizeof(SpriteResource) + size.area());
     SpriteResource* sprite = new (ptr) SpriteResource{ autoincremented<SpriteResource, uint64_t>(), size };
-    return std::shared_ptr<SpriteResource>(sprite, [](SpriteResource* ptr) {
-        ::free(reinterpret_cast<std::byte*>(ptr));
-    });
+    return std::shared_ptr<SpriteResource>(sprite, Internal::SpriteDeleter{},
+                                           Internal::SpritePoolAllocator<SpriteResource>{});
 }
 
 inline Rc<SpriteResource> makeSprite(Size size, BytesView bytes) {
@@ -64,4 +130,18 @@ inline Rc<SpriteResource> makeSprite(Size size, BytesView bytes) {
     return result;
 }
 
+/**
+ * @brief Creates a sprite that refers to pixels owned by `owner` instead of copying them.
+ *
+ * The sprite keeps `owner` alive. Its pixels are read-only and are copied only once, into the atlas.
+ */
+inline Rc<SpriteResource> makeSpriteView(Size size, BytesView bytes, Rc<const void> owner) {
+    BRISK_ASSERT(size.area() == bytes.size());
+    void* ptr              = Internal::spritePool().allocate(sizeof(SpriteResource));
+    SpriteResource* sprite = new (ptr)
+        SpriteResource{ autoincremented<SpriteResource, uint64_t>(), size, bytes.data() };
+    return std::shared_ptr<SpriteResource>(sprite, Internal::SpriteViewDeleter{ std::move(owner) },
+                                           Internal::SpritePoolAllocator<SpriteResource>{});
+}
+
 } // namespace Brisk
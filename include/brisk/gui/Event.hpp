@@ -98,8 +98,13 @@ struct EventMouseButton : public EventMouse {
 
 /**
  * @brief Struct representing a mouse moved event.
+ *
+ * Consecutive mouse moves are merged before dispatch. Positions of the merged moves are kept in
+ * `coalesced` for widgets that need every sample, such as drawing tools.
  */
-struct EventMouseMoved : public EventMouse {};
+struct EventMouseMoved : public EventMouse {
+    std::vector<PointF> coalesced; ///< Earlier positions merged into this event, oldest first.
+};
 
 /**
  * @brief Struct representing a mouse wheel event.
@@ -403,9 +408,15 @@ struct Event : public EventVariant {
 
 /**
  * @brief Struct for managing hit test information for widgets.
+ *
+ * Entries are looked up through a uniform grid built over their clipped bounds, so a lookup tests
+ * only the entries overlapping the grid cell containing the point.
  */
 struct HitTestMap {
-    void add(std::shared_ptr<Widget> w, InputShape rect, bool anywhere, int zindex);
+    /**
+     * @brief Adds an entry for the widget. Returns false if the shape is empty and nothing was added.
+     */
+    bool add(std::shared_ptr<Widget> w, InputShape rect, bool anywhere, int zindex);
 
     struct HitTestEntry {
         std::weak_ptr<Widget> widget; ///< The widget involved in the hit test.
@@ -414,7 +425,31 @@ struct HitTestMap {
         bool anywhere;                ///< Indicates if the widget is valid anywhere.
     };
 
-    std::vector<HitTestEntry> list; ///< List of hit test entries.
+    std::vector<HitTestEntry> list; ///< List of hit test entries in the order they were added.
+
+    /**
+     * @brief Returns the number of entries.
+     */
+    size_t size() const noexcept {
+        return list.size();
+    }
+
+    /**
+     * @brief Returns the entry at the specified position in hit test order.
+     *
+     * Entries are ordered by z-index. Entries with equal z-index are ordered from the last added
+     * to the first added, so children come before their parents.
+     */
+    const HitTestEntry& at(size_t position) const;
+
+    /**
+     * @brief Finds the first entry at or after the specified position that contains the point.
+     * @param pt The point to test.
+     * @param from Position in hit test order to start from.
+     * @param respect_anywhere Whether to respect the "anywhere" flag.
+     * @return The position of the entry in hit test order or size() if there is no such entry.
+     */
+    size_t find(Point pt, size_t from, bool respect_anywhere) const;
 
     /**
      * @brief Retrieves the widget at the specified coordinates.
@@ -429,6 +464,14 @@ struct HitTestMap {
         return get(p.x, p.y, respect_anywhere);
     }
 
+    /**
+     * @brief Builds the lookup index if entries have been added since it was last built.
+     *
+     * Lookups build the index on demand, calling this after adding entries moves the cost out of
+     * event handling.
+     */
+    void build() const;
+
     /**
      * @brief Clears all hit test entries.
      */
@@ -442,6 +485,21 @@ struct HitTestMap {
     };
 
     int tabGroupId = 0;
+
+private:
+    struct Index {
+        std::vector<uint32_t> order;       // list indices in hit test order
+        std::vector<uint32_t> cellStart;   // offsets into cellEntries, one per cell plus one
+        std::vector<uint32_t> cellEntries; // positions overlapping each cell, ascending
+        std::vector<uint32_t> large;       // positions of entries covering a large part of the grid
+        std::vector<uint32_t> anywhere;    // positions of entries with the anywhere flag
+        Rectangle bounds{};
+        Size cells{};
+        int cellSize = 1;
+    };
+
+    mutable Index m_index;
+    mutable bool m_indexValid = true;
 };
 
 /**
@@ -453,6 +511,7 @@ struct InputQueue {
     std::weak_ptr<const Widget> activeHint;
     std::vector<std::weak_ptr<Widget>> capturingMouse; ///< List of widgets capturing the mouse input.
     std::vector<std::weak_ptr<Widget>> capturingKeys;  ///< List of widgets capturing keyboard input.
+    std::vector<std::weak_ptr<Widget>> hovered;        ///< Widgets in hover state, children first.
     std::vector<std::weak_ptr<Widget>> tabList;
     std::weak_ptr<Widget> autoFocus;
     std::weak_ptr<Widget> dragSource;
@@ -680,6 +739,7 @@ struct InputQueue {
 
     /**
      * Adds an event to the queue to be processed in the next call to processEvent.
+     * A mouse move directly following another one replaces it, and wheel events are summed.
      * @param event The event to add.
      */
     void addEvent(Event event);
@@ -38,6 +38,7 @@ BRISK_CLANG_PRAGMA(clang diagnostic ignored "-Wc++2a-extensions")
 #include <brisk/core/Utilities.hpp>
 #include <brisk/core/MetaClass.hpp>
 #include <brisk/core/internal/cityhash.hpp>
+#include <brisk/core/internal/SizeClassPool.hpp>
 #include <brisk/window/Types.hpp>
 #include <brisk/window/Window.hpp>
 #include <brisk/core/Compression.hpp>
@@ -371,6 +372,166 @@ using StyleVarType = std::variant<std::monostate, ColorW, EdgesL, float, int>;
 
 namespace Internal {
 
+/**
+ * @brief Set of property ids kept sorted in a single vector.
+ *
+ * Widgets track only a few properties each, so this is smaller and faster than a node-based set.
+ */
+class PropertySet {
+public:
+    PropertySet() noexcept = default;
+
+    PropertySet(std::initializer_list<PropertyId> ids) : m_ids(ids) {
+        std::sort(m_ids.begin(), m_ids.end());
+        m_ids.erase(std::unique(m_ids.begin(), m_ids.end()), m_ids.end());
+    }
+
+    bool contains(PropertyId id) const noexcept {
+        return std::binary_search(m_ids.begin(), m_ids.end(), id);
+    }
+
+    void insert(PropertyId id) {
+        auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+        if (it == m_ids.end() || *it != id)
+            m_ids.insert(it, id);
+    }
+
+    void erase(PropertyId id) noexcept {
+        auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+        if (it != m_ids.end() && *it == id)
+            m_ids.erase(it);
+    }
+
+private:
+    std::vector<PropertyId> m_ids;
+};
+
+/**
+ * @brief Side table holding the values of rarely set widget properties, keyed by PropertyId.
+ *
+ * A property gets an entry the first time it is set to something other than its initial value; until
+ * then reads return the initial value, so a default widget carries no storage for these properties.
+ * Each value is allocated separately, so references to it stay valid while other entries are added.
+ */
+class SparseProperties {
+public:
+    /// @brief Number of binding addresses reserved for sparse properties, see address().
+    constexpr static size_t maxKeys = 16;
+
+    SparseProperties() noexcept                              = default;
+    SparseProperties(SparseProperties&&) noexcept            = default;
+    SparseProperties& operator=(SparseProperties&&) noexcept = default;
+
+    SparseProperties(const SparseProperties& other) {
+        m_entries.reserve(other.m_entries.size());
+        for (const Entry& entry : other.m_entries)
+            m_entries.push_back(Entry{ entry.id, entry.value->clone() });
+    }
+
+    SparseProperties& operator=(const SparseProperties& other) {
+        if (this != &other)
+            *this = SparseProperties(other);
+        return *this;
+    }
+
+    /** @brief Returns the value stored for @p id, or nullptr if the property has no entry. */
+    template <typename T>
+    const T* find(PropertyId id) const noexcept {
+        auto it = lowerBound(id);
+        if (it == m_entries.end() || it->id != id)
+            return nullptr;
+        return &static_cast<const Value<T>*>(it->value.get())->value;
+    }
+
+    template <typename T>
+    T* find(PropertyId id) noexcept {
+        return const_cast<T*>(static_cast<const SparseProperties*>(this)->template find<T>(id));
+    }
+
+    /** @brief Returns the value stored for @p id, creating it from `init()` if it has no entry. */
+    template <typename T, typename Fn>
+    T& obtain(PropertyId id, Fn&& init) {
+        auto it = lowerBound(id);
+        if (it == m_entries.end() || it->id != id)
+            it = m_entries.insert(it, Entry{ id, std::make_unique<Value<T>>(init()) });
+        return static_cast<Value<T>*>(it->value.get())->value;
+    }
+
+    /**
+     * @brief Returns the binding address used for the property stored under @p key.
+     *
+     * Values are allocated on demand, so bindings address a byte reserved for the key instead. The bytes
+     * lie inside the widget's registered binding region and are never used for anything else.
+     */
+    BindingAddress address(uint8_t key) const noexcept {
+        BRISK_ASSERT(key < maxKeys);
+        return { reinterpret_cast<const uint8_t*>(m_addresses) + key, 1 };
+    }
+
+    size_t size() const noexcept {
+        return m_entries.size();
+    }
+
+private:
+    struct ValueBase {
+        virtual ~ValueBase()                             = default;
+        virtual std::unique_ptr<ValueBase> clone() const = 0;
+    };
+
+    template <typename T>
+    struct Value final : ValueBase {
+        explicit Value(T value) : value(std::move(value)) {}
+
+        std::unique_ptr<ValueBase> clone() const override {
+            return std::make_unique<Value>(value);
+        }
+
+        T value;
+    };
+
+    struct Entry {
+        PropertyId id;
+        std::unique_ptr<ValueBase> value;
+    };
+
+    std::vector<Entry>::iterator lowerBound(PropertyId id) noexcept {
+        return std::lower_bound(m_entries.begin(), m_entries.end(), id,
+                                [](const Entry& entry, PropertyId id) {
+                                    return entry.id < id;
+                                });
+    }
+
+    std::vector<Entry>::const_iterator lowerBound(PropertyId id) const noexcept {
+        return const_cast<SparseProperties*>(this)->lowerBound(id);
+    }
+
+    std::vector<Entry> m_entries; // Sorted by id
+    char m_addresses[maxKeys]{};  // Binding addresses of the properties, never read or written
+};
+
+/**
+ * @brief Storage of a widget property: either a data member or an entry in the widget's SparseProperties.
+ */
+template <typename WidgetClass, typename ValueType>
+struct GuiField {
+    constexpr GuiField(ValueType(WidgetClass::* member)) noexcept : member(member) {}
+
+    constexpr explicit GuiField(uint8_t sparseKey) noexcept : sparseKey(sparseKey) {}
+
+    ValueType(WidgetClass::* member) = nullptr;
+    uint8_t sparseKey                = 0; // Binding address offset, unique among sparse properties
+};
+
+/**
+ * @brief Places a Widget property in the sparse side table under @p key.
+ * @details Sub-properties of a compound property need consecutive keys so their addresses can be merged.
+ */
+template <typename ValueType, uint8_t key>
+constexpr GuiField<Widget, ValueType> sparseField() noexcept {
+    static_assert(key < SparseProperties::maxKeys);
+    return GuiField<Widget, ValueType>(key);
+}
+
 template <typename T>
 struct IsConstexprCompatible {
     constexpr static bool value = true;
@@ -383,7 +544,7 @@ struct IsConstexprCompatible<std::basic_string<T, Tr, A>> {
 
 template <typename WidgetClass, typename ValueType>
 struct GuiProp {
-    ValueType(WidgetClass::* field);
+    GuiField<WidgetClass, ValueType> field;
     std::conditional_t<IsConstexprCompatible<ValueType>::value, ValueType, ValueType (*)()> initialValue;
     PropFlags flags;
     const char* name = nullptr;
@@ -404,8 +565,28 @@ struct GuiProp {
         }
     }
 
+    // Returns the stored value, or nullptr for a sparse property that has not been set
+    const ValueType* find(const WidgetClass* self) const noexcept {
+        if (field.member)
+            return &(self->*field.member);
+        return static_cast<const Widget*>(self)->m_sparseProperties.template find<ValueType>(id());
+    }
+
+    ValueType* find(WidgetClass* self) const noexcept {
+        return const_cast<ValueType*>(find(static_cast<const WidgetClass*>(self)));
+    }
+
+    ValueType& ref(WidgetClass* self) const {
+        if (field.member)
+            return self->*field.member;
+        return static_cast<Widget*>(self)->m_sparseProperties.template obtain<ValueType>(id(), [this]() {
+            return getInitialValue();
+        });
+    }
+
     void initialize(WidgetClass* self) const {
-        (self->*field) = getInitialValue();
+        if (field.member)
+            (self->*field.member) = getInitialValue();
     }
 
     void reset(WidgetClass* self) const {
@@ -415,17 +596,18 @@ struct GuiProp {
     void set(WidgetClass* self, ValueType value, bool inherit = false, bool override = true) const {
         if (!self->propChanging(this, inherit, override))
             return;
-        if (self->*field == value) {
+        if (get(self) == value) {
             return;
         }
-        bindings->assign(self->*field, std::move(value));
+        ref(self) = std::move(value);
+        bindings->notifyRange(address(self));
         self->propChanged(this);
     }
 
     void set(WidgetClass* self, Inherit, bool override = true) const {
         if constexpr (std::is_same_v<WidgetClass, Widget>) {
             if (Widget* parent = self->parent()) {
-                set(self, parent->*field, true, override);
+                set(self, get(parent), true, override);
             } else {
                 set(self, getInitialValue(), true, override);
             }
@@ -447,15 +629,26 @@ struct GuiProp {
     }
 
     ValueOrConstRef<ValueType> get(const WidgetClass* self) const noexcept {
-        return (self->*field);
+        if (const ValueType* value = find(self))
+            return *value;
+        if constexpr (IsConstexprCompatible<ValueType>::value) {
+            return initialValue;
+        } else {
+            // Unset sparse properties of these types have no initial value function, see
+            // sparseInitialValueSupported
+            static const ValueType empty{};
+            return empty;
+        }
     }
 
     ValueOrConstRef<ValueType> current(const WidgetClass* self) const noexcept {
-        return (self->*field);
+        return get(self);
     }
 
     BindingAddress address(const WidgetClass* self) const noexcept {
-        return toBindingAddress(&(self->*field));
+        if (field.member)
+            return toBindingAddress(&(self->*field.member));
+        return static_cast<const Widget*>(self)->m_sparseProperties.address(field.sparseKey);
     }
 };
 
@@ -463,9 +656,15 @@ template <typename WidgetClass, typename ValueType>
 GuiProp(ValueType(WidgetClass::*), std::type_identity_t<ValueType>, PropFlags, const char* = nullptr)
     -> GuiProp<WidgetClass, ValueType>;
 
+template <typename WidgetClass, typename ValueType>
+GuiProp(GuiField<WidgetClass, ValueType>, std::type_identity_t<ValueType>, PropFlags, const char* = nullptr)
+    -> GuiProp<WidgetClass, ValueType>;
+
 template <typename WidgetClass, typename ValueType, typename AnimatedType>
 struct GuiProp<WidgetClass, Animated<ValueType, AnimatedType>> {
-    Animated<ValueType, AnimatedType>(WidgetClass::* field);
+    using AnimatedT = Animated<ValueType, AnimatedType>;
+
+    GuiField<WidgetClass, AnimatedT> field;
     ValueType initialValue;
     PropFlags flags;
     const char* name = nullptr;
@@ -474,10 +673,32 @@ struct GuiProp<WidgetClass, Animated<ValueType, AnimatedType>> {
         return { this };
     }
 
+    // Returns the stored value, or nullptr for a sparse property that has not been set
+    const AnimatedT* find(const WidgetClass* self) const noexcept {
+        if (field.member)
+            return &(self->*field.member);
+        return static_cast<const Widget*>(self)->m_sparseProperties.template find<AnimatedT>(id());
+    }
+
+    AnimatedT* find(WidgetClass* self) const noexcept {
+        return const_cast<AnimatedT*>(find(static_cast<const WidgetClass*>(self)));
+    }
+
+    AnimatedT& ref(WidgetClass* self) const {
+        if (field.member)
+            return self->*field.member;
+        Internal::SparseProperties& sparse = static_cast<Widget*>(self)->m_sparseProperties;
+        return sparse.template obtain<AnimatedT>(id(), [self, this]() {
+            return AnimatedT{ initialValue, self->propResolve(this, initialValue) };
+        });
+    }
+
     void initialize(WidgetClass* self) const {
-        (self->*field).value   = initialValue;
-        AnimatedType resolved  = self->propResolve(this, initialValue);
-        (self->*field).current = resolved;
+        if (!field.member)
+            return;
+        (self->*field.member).value   = initialValue;
+        AnimatedType resolved         = self->propResolve(this, initialValue);
+        (self->*field.member).current = resolved;
     }
 
     void reset(WidgetClass* self) const {
@@ -488,12 +709,14 @@ struct GuiProp<WidgetClass, Animated<ValueType, AnimatedType>> {
         if (!self->propChanging(this, inherit, override)) {
             return;
         }
-        if ((self->*field).value == value) {
+        if (get(self) == value) {
             return;
         }
         PropertyAnimations& anim = self->animations();
         AnimatedType resolved    = self->propResolve(this, value);
-        bindings->assign((self->*field).value, value);
+        AnimatedT& stored        = ref(self);
+        stored.value             = value;
+        bindings->notifyRange(address(self));
         std::function<void()> changed;
         using enum PropFlags;
         if (flags && (AffectLayout | AffectStyle | AffectFont | AffectVisibility | AffectHint)) {
@@ -502,10 +725,10 @@ struct GuiProp<WidgetClass, Animated<ValueType, AnimatedType>> {
             };
         }
         if (self->transitionAllowed() &&
-            anim.startTransition((self->*field).current, resolved, id(), std::move(changed))) {
+            anim.startTransition(stored.current, resolved, id(), std::move(changed))) {
             self->requestAnimationFrame();
         } else {
-            (self->*field).current = resolved;
+            stored.current = resolved;
         }
         self->propChanged(this);
     }
@@ -513,7 +736,7 @@ struct GuiProp<WidgetClass, Animated<ValueType, AnimatedType>> {
     void set(WidgetClass* self, Inherit, bool override = true) const {
         if constexpr (std::is_same_v<WidgetClass, Widget>) {
             if (Widget* parent = self->parent()) {
-                set(self, (parent->*field).value, true, override);
+                set(self, get(parent), true, override);
             } else {
                 set(self, initialValue, true, override);
             }
@@ -535,15 +758,21 @@ struct GuiProp<WidgetClass, Animated<ValueType, AnimatedType>> {
     }
 
     ValueOrConstRef<ValueType> get(const WidgetClass* self) const noexcept {
-        return (self->*field).value;
+        if (const AnimatedT* value = find(self))
+            return value->value;
+        return initialValue;
     }
 
     AnimatedType current(const WidgetClass* self) const noexcept {
-        return (self->*field).current;
+        if (const AnimatedT* value = find(self))
+            return value->current;
+        return self->propResolve(this, initialValue);
     }
 
     BindingAddress address(const WidgetClass* self) const noexcept {
-        return toBindingAddress(&(self->*field).value);
+        if (field.member)
+            return toBindingAddress(&(self->*field.member).value);
+        return static_cast<const Widget*>(self)->m_sparseProperties.address(field.sparseKey);
     }
 };
 
@@ -551,6 +780,27 @@ template <typename WidgetClass, typename ValueType, typename AnimatedType>
 GuiProp(Animated<ValueType, AnimatedType>(WidgetClass::*), std::type_identity_t<ValueType>, PropFlags,
         const char* = nullptr) -> GuiProp<WidgetClass, Animated<ValueType, AnimatedType>>;
 
+template <typename WidgetClass, typename ValueType, typename AnimatedType>
+GuiProp(GuiField<WidgetClass, Animated<ValueType, AnimatedType>>, std::type_identity_t<ValueType>, PropFlags,
+        const char* = nullptr) -> GuiProp<WidgetClass, Animated<ValueType, AnimatedType>>;
+
+template <typename Prop>
+constexpr bool sparseInitialValueSupported(const Prop&) noexcept {
+    return true;
+}
+
+/**
+ * @brief Returns false for a sparse property that has an initial value function.
+ * @details Unset sparse properties of non-constexpr types read as a default-constructed value.
+ */
+template <typename WidgetClass, typename ValueType>
+constexpr bool sparseInitialValueSupported(const GuiProp<WidgetClass, ValueType>& prop) noexcept {
+    if constexpr (IsConstexprCompatible<ValueType>::value)
+        return true;
+    else
+        return prop.field.member || !prop.initialValue;
+}
+
 template <typename WidgetClass, template <typename T> typename TypeTemplate, typename SubType,
           typename CurrentSubType, PropertyIndex index0, PropertyIndex... indices>
 struct GuiPropCompound {
@@ -615,6 +865,70 @@ struct GuiPropCompound {
         return mergeAddresses(traits<index0>().address(self), traits<indices>().address(self)...);
     }
 };
+
+/**
+ * @brief Creates a pool for widgets, their layout nodes and control blocks.
+ */
+Rc<SizeClassPool> makeWidgetPool();
+
+/**
+ * @brief Makes widgets created on this thread come from the given pool while the scope is alive.
+ *
+ * WidgetTree opens a scope for its own pool in update(), so rebuilds and event handlers reuse the memory
+ * of the widgets the tree has released. Widgets created outside of any scope use a process-wide pool.
+ */
+class WidgetPoolScope {
+public:
+    explicit WidgetPoolScope(Rc<SizeClassPool> pool) noexcept;
+    ~WidgetPoolScope();
+
+    WidgetPoolScope(const WidgetPoolScope&)            = delete;
+    WidgetPoolScope& operator=(const WidgetPoolScope&) = delete;
+
+private:
+    Rc<SizeClassPool> m_previous;
+};
+
+/**
+ * @brief Allocates the control block of an Rc<Widget>.
+ *
+ * The control block is placed in the block allocated by Widget::operator new for the widget at `owner`
+ * if it fits there, otherwise it gets its own allocation.
+ */
+[[nodiscard]] void* controlBlockAlloc(const void* owner, size_t size);
+
+/**
+ * @brief Frees memory obtained from controlBlockAlloc. Size must match the allocation.
+ */
+void controlBlockFree(void* ptr, size_t size) noexcept;
+
+/**
+ * @brief Allocator for the control blocks of Rc<Widget>, see controlBlockAlloc.
+ */
+template <typename T>
+struct WidgetAllocator {
+    using value_type = T;
+
+    constexpr explicit WidgetAllocator(const void* owner) noexcept : owner(owner) {}
+
+    template <typename U>
+    constexpr WidgetAllocator(const WidgetAllocator<U>& other) noexcept : owner(other.owner) {}
+
+    [[nodiscard]] T* allocate(size_t n) {
+        return static_cast<T*>(controlBlockAlloc(owner, n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        controlBlockFree(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    constexpr bool operator==(const WidgetAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    const void* owner;
+};
 } // namespace Internal
 
 class WIDGET Widget : public BindableObject<Widget, &uiScheduler> {
@@ -629,6 +943,12 @@ public:
         return uiScheduler;
     }
 
+    /// @brief Control blocks created by rcnew share the memory block of the widget.
+    using RcAllocator = Internal::WidgetAllocator<Widget>;
+
+    static void* operator new(size_t sz);
+    static void operator delete(void* ptr, size_t sz);
+
     Widget& operator=(const Widget&) = delete;
     Widget& operator=(Widget&&)      = delete;
 
@@ -1115,12 +1435,11 @@ protected:
     Trigger<> m_onClick;
     Trigger<> m_onDoubleClick;
 
-    function<void(Widget*)> m_reapplyStyle;
+    function<void(Widget*, WidgetState)> m_reapplyStyle; // receives the state bits that have changed
 
     // strings
     std::string m_type;
     std::string m_id;
-    std::string m_hint;
     std::string_view m_role;
     Classes m_classes;
 
@@ -1128,26 +1447,23 @@ protected:
     Rectangle m_clientRect{ 0, 0, 0, 0 };
     Rectangle m_subtreeRect{ 0, 0, 0, 0 };
     Rectangle m_clipRect{ 0, 0, 0, 0 };
-    Rectangle m_hintRect{ 0, 0, 0, 0 };
     EdgesF m_computedMargin{ 0, 0, 0, 0 };
     EdgesF m_computedPadding{ 0, 0, 0, 0 };
     EdgesF m_computedBorderWidth{ 0, 0, 0, 0 };
     Size m_contentSize{ 0, 0 };
-    Point m_hintTextOffset{ 0, 0 };
-    PreparedText m_hintPrepared;
+    struct HintLayout {
+        PreparedText prepared;
+        Rectangle rect{ 0, 0, 0, 0 };
+        Point textOffset{ 0, 0 };
+    };
+
+    OptionalClonablePtr<HintLayout> m_hintLayout; // allocated for widgets with a hint only
 
     Animated<ColorW> m_backgroundColor;
     Animated<ColorW> m_borderColor;
     Animated<ColorW> m_color;
-    Animated<ColorW> m_shadowColor;
     Animated<ColorW> m_scrollBarColor;
 
-    // point/size
-    PointL m_absolutePosition; // for popup only
-    PointL m_anchor;           // for popup only
-    PointL m_translate;        // translation relative to own size
-    Animated<PointF> m_shadowOffset;
-
     // pointers
     Widget* m_parent = nullptr;
     EventDelegate* m_delegate;
@@ -1160,15 +1476,12 @@ protected:
     OptFloat m_flexShrink;
     OptFloat m_aspect;
     Animated<float> m_opacity;
-    Animated<float> m_shadowSpread;
 
     // int
     Cursor m_cursor;
     int m_tabGroupId = -1;
 
-    Internal::Resolve m_shadowSize;
     Internal::Resolve m_fontSize;
-    Internal::Resolve m_tabSize;
     Internal::Resolve m_letterSpacing;
     Internal::Resolve m_wordSpacing;
     Internal::Resolve m_scrollBarThickness;
@@ -1178,6 +1491,9 @@ protected:
     Internal::Resolve m_borderRadiusBottomLeft;
     Internal::Resolve m_borderRadiusBottomRight;
 
+    // hint, shadow, tab size and popup placement; the default theme leaves them unset on most widgets
+    Internal::SparseProperties m_sparseProperties;
+
     CornersL getBorderRadius() const noexcept {
         return { m_borderRadiusTopLeft.value, m_borderRadiusTopRight.value, m_borderRadiusBottomLeft.value,
                  m_borderRadiusBottomRight.value };
@@ -1309,8 +1625,8 @@ protected:
 
     void updateScrollAxes();
 
-    std::set<PropertyId> m_overriddenProperties;
-    std::set<PropertyId> m_inheritedProperties;
+    Internal::PropertySet m_overriddenProperties;
+    Internal::PropertySet m_inheritedProperties;
 
     std::map<uint64_t, StyleVarType> m_styleVars;
 
@@ -1360,7 +1676,7 @@ protected:
     void toggleState(WidgetState mask, bool on);
     void setState(WidgetState newState);
     void requestRestyle();
-    void requestStateRestyle();
+    void requestStateRestyle(WidgetState changed);
     ///////////////////////////////////////////////////////////////////////////////
 
     void doPaint(Canvas& canvas) const;
@@ -1431,19 +1747,20 @@ private:
     bool m_hasLayout : 1 { false };
     bool m_previouslyHasLayout : 1 { false };
     bool m_pendingAnimationRequest : 1 { false };
+    bool m_hitTestable : 1 { false }; // added to the hit test map by the last updateGeometry
 
     Trigger<> m_rebuildTrigger{};
 
     WidgetPtrs m_widgets;
     std::vector<BuilderData> m_builders;
-    std::set<WidgetGroup*> m_groups;
+    std::vector<WidgetGroup*> m_groups;
     std::vector<function<void(Widget*)>> m_onParentSet;
 
     friend struct WidgetGroup;
 
     explicit Widget(Construction construction);
     void childAdded(Widget* w);
-    int32_t applyLayoutRecursively(RectangleF rectangle);
+    int32_t applyLayoutRecursively(RectangleF rectangle, LayoutStat& stat);
     void computeClipRect();
     void prepareHint();
     void computeHintRect();
@@ -1467,7 +1784,8 @@ private:
 
     float resolveFontHeight() const;
     void updateLayout(Rectangle rectangle, bool viewportChanged);
-    void markTreeDirty();
+    bool dependsOnViewport() const noexcept;
+    void markViewportDependentDirty();
 
     void layoutSet();
     void layoutResetRecursively();
@@ -87,6 +87,7 @@ private:
     bool m_frameSkipTestState = false;
     std::vector<uint32_t> m_unhandledEvents;
     Rectangle m_savedPaintRect{};
+    uint32_t m_glyphGeneration = 0;
 
     void updateWindowLimits();
 
@@ -22,6 +22,7 @@
 #include "Gui.hpp"
 #include <bit>
 #include <brisk/core/internal/cityhash.hpp>
+#include <brisk/core/Hash.hpp>
 
 namespace Brisk {
 
@@ -256,6 +257,11 @@ struct Rule {
         return m_state;
     }
 
+    // true if the value is computed by a function, e.g. from style variables
+    bool isFunction() const noexcept {
+        return m_op == Internal::RuleOp::Function;
+    }
+
     bool operator==(const Rule& other) const noexcept {
         return m_property == other.m_property &&
                m_property->equals(m_op, m_storage, other.m_op, other.m_storage) && m_state == other.m_state &&
@@ -384,6 +390,24 @@ inline auto textColorFor(
 
 namespace Selectors {
 
+/**
+ * @brief Simple selector that every widget matching a compound selector satisfies.
+ *
+ * Used by Stylesheet to test only the styles that can possibly match a widget.
+ */
+struct IndexKey {
+    // Ordered from the least to the most selective
+    enum class Kind : uint8_t {
+        None,
+        Role,
+        Type,
+        Class,
+        Id,
+    };
+    Kind kind = Kind::None;
+    std::string_view value; // points into the selector
+};
+
 template <typename Sel>
 concept Selector = requires(const Sel sel, Widget* w, MatchFlags f) {
     { sel.matches(w, f) } noexcept -> std::same_as<bool>;
@@ -570,6 +594,43 @@ struct Last : public Nth {
     Last() noexcept : Nth(0, INT_MAX, true) {}
 };
 
+template <Selector Sel>
+inline IndexKey indexKey(const Sel&) noexcept {
+    return {};
+}
+
+inline IndexKey indexKey(const Type& sel) noexcept {
+    return { IndexKey::Kind::Type, sel.type };
+}
+
+inline IndexKey indexKey(const Role& sel) noexcept {
+    return { IndexKey::Kind::Role, sel.role };
+}
+
+inline IndexKey indexKey(const Id& sel) noexcept {
+    return { IndexKey::Kind::Id, sel.id };
+}
+
+inline IndexKey indexKey(const Class& sel) noexcept {
+    return { IndexKey::Kind::Class, sel.className };
+}
+
+template <Selector... Selectors>
+inline IndexKey indexKey(const All<Selectors...>& sel) noexcept {
+    IndexKey result;
+    std::apply(
+        [&result](const auto&... selectors) {
+            (
+                [&result](IndexKey key) {
+                    if (key.kind > result.kind)
+                        result = key;
+                }(indexKey(selectors)),
+                ...);
+        },
+        sel.selectors);
+    return result;
+}
+
 template <Selector... Selectors>
 inline All<std::remove_cvref_t<Selectors>...> all(Selectors&&... selectors) noexcept {
     return { std::forward<Selectors>(selectors)... };
@@ -611,16 +672,22 @@ struct Selector {
         match = [](const void* p, Widget* w, MatchFlags flags) noexcept {
             return reinterpret_cast<const std::remove_cvref_t<Sel>*>(p)->matches(w, flags);
         };
+        key = Selectors::indexKey(*reinterpret_cast<const std::remove_cvref_t<Sel>*>(this->sel.get()));
     }
 
     bool matches(Widget* widget, MatchFlags flags) const noexcept {
         return match(sel.get(), widget, flags);
     }
 
+    Selectors::IndexKey indexKey() const noexcept {
+        return key;
+    }
+
 private:
     std::shared_ptr<void> sel;
     using fn_match = bool (*)(const void*, Widget*, MatchFlags);
     fn_match match;
+    Selectors::IndexKey key;
 };
 
 struct Rules {
@@ -675,10 +742,69 @@ public:
 
     std::vector<Rc<const Stylesheet>> inherited;
 
+    /**
+     * @brief Applies the matching styles to the widget.
+     *
+     * Widgets matching the same set of styles share one merged Rules object. When the widget state
+     * changes later, only the properties that have rules for the changed states are applied again.
+     * Adding or removing styles here or in the inherited stylesheets is detected, styles modified in
+     * place require a call to invalidate().
+     */
     void stylize(Widget* widget, bool isRoot) const;
 
+    /**
+     * @brief Drops the index and the merged rules of this stylesheet and of stylesheets inheriting it.
+     *
+     * Must be called after modifying the styles in place. Widgets pick up the change when restyled.
+     */
+    void invalidate() noexcept;
+
 private:
-    void stylizeInternal(Rules& rules, Widget* widget, bool isRoot) const;
+    using MatchedStyles = std::vector<const Style*>;
+
+    // Rules of all matching styles merged together
+    struct MergedRules {
+        explicit MergedRules(Rules rules);
+
+        // Rules of one property that include rules for specific states
+        struct StateGroup {
+            uint32_t first;
+            uint32_t last;
+            WidgetState states; // union of the states of the rules
+        };
+
+        Rules rules;
+        std::vector<StateGroup> stateGroups;
+        // Stateless function rules, they may read style variables set by the state groups
+        std::vector<uint32_t> functionRules;
+
+        // Applies only the properties whose rules depend on the changed states
+        void applyStateChange(Widget* widget, WidgetState changed) const;
+    };
+
+    struct MatchedStylesHash {
+        size_t operator()(const MatchedStyles& styles) const noexcept;
+    };
+
+    // Styles grouped by the key of their selector, see Selectors::IndexKey
+    struct Index {
+        const Style* data   = nullptr; // detects changes of the style list
+        size_t size         = 0;
+        uint64_t generation = 0; // unique for every rebuild, 0 if the index must be rebuilt
+        std::vector<uint32_t> unkeyed;
+        std::array<std::unordered_map<std::string, std::vector<uint32_t>, StringHash, std::equal_to<>>, 5>
+            keyed;
+    };
+
+    mutable Index m_index;
+    mutable std::unordered_map<MatchedStyles, Rc<const MergedRules>, MatchedStylesHash> m_mergedRules;
+    // Index generations of the inherited stylesheets and this one that m_mergedRules was built from
+    mutable std::vector<uint64_t> m_mergedGenerations;
+
+    const Index& index() const;
+    void validateMergedRules() const;
+    void matchStyles(MatchedStyles& matched, Widget* widget, bool isRoot) const;
+    Rc<const MergedRules> mergedRules(const MatchedStyles& matched) const;
 };
 
 template <typename T, uint64_t Id>
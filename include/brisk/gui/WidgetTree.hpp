@@ -25,6 +25,7 @@
 #include <memory>
 #include <brisk/core/internal/Function.hpp>
 #include <brisk/core/Binding.hpp>
+#include <brisk/core/internal/SizeClassPool.hpp>
 #include <brisk/core/Utilities.hpp>
 #include <brisk/graphics/Geometry.hpp>
 #include <stack>
@@ -51,14 +52,23 @@ struct WidgetGroup {
 
     virtual void afterFrame() {}
 
+    // Takes the widget out of the group, the reverse of Widget::apply
+    void remove(Widget* widget);
+
     void clean();
 };
 
 using Drawable = function<void(Canvas&)>;
 
+// Node counts of the most recent layout pass
+struct LayoutStat {
+    uint32_t visited = 0; // Widgets the layout was applied to
+    uint32_t changed = 0; // Widgets whose geometry changed, including moved subtrees
+};
+
 class WidgetTree {
 public:
-    WidgetTree(InputQueue* inputQueue = nullptr) noexcept;
+    WidgetTree(InputQueue* inputQueue = nullptr);
     ~WidgetTree();
 
     std::shared_ptr<Widget> root() const noexcept;
@@ -66,6 +76,7 @@ public:
     void rescale();
     void onLayoutUpdated();
     uint32_t layoutCounter() const noexcept;
+    LayoutStat layoutStat() const noexcept;
 
     void setViewportRectangle(Rectangle rect);
 
@@ -74,6 +85,12 @@ public:
     Rectangle paintRect() const;
     Rectangle paint(Canvas& canvas, ColorW backgroundColor, bool fullRepaint);
     void update();
+
+    /**
+     * @brief Pool for the widgets created during update(), see Internal::WidgetPoolScope.
+     */
+    const Rc<Internal::SizeClassPool>& widgetPool() const noexcept;
+
     void requestLayer(Drawable drawable);
 
     void invalidateRect(Rectangle rect);
@@ -113,6 +130,7 @@ private:
     std::vector<std::weak_ptr<Widget>> m_rebuildQueue;
     std::vector<Drawable> m_layer;
     uint32_t m_layoutCounter         = 0;
+    LayoutStat m_layoutStat{};
     double m_refreshTime             = 0;
     bool m_transitions               = true;
     bool m_updateGeometryRequested   = false;
@@ -128,5 +146,6 @@ private:
     bool m_realtime             = true;
     bool m_layoutIsActual       = false;
     InputQueue* m_inputQueue    = nullptr;
+    Rc<Internal::SizeClassPool> m_widgetPool;
 };
 } // namespace Brisk
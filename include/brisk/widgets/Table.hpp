@@ -68,6 +68,17 @@ struct Selection {
     void selectRange(TItem value) {
         if (!focused)
             return set(std::move(value));
+        if constexpr (std::is_integral_v<TItem>) {
+            if (!order) {
+                // Items are indices, select all between the focused item and value
+                auto [first, last] = std::minmax(value, *focused);
+                selection.clear();
+                for (TItem i = first; i <= last; ++i) {
+                    selection.insert(selection.end(), i);
+                }
+                return;
+            }
+        }
         auto selectedIt = std::find(order->begin(), order->end(), value);
         auto focusedIt  = std::find(order->begin(), order->end(), *focused);
         BRISK_ASSERT(selectedIt != order->end());
@@ -83,6 +94,7 @@ struct Selection {
     bool isSelected(const TItem& value) const {
         return selection.find(value) != selection.end();
     }
+    bool operator==(const Selection&) const = default;
 };
 
 class WIDGET Table : public Widget {
@@ -121,6 +133,16 @@ public:
         endConstruction();
     }
 
+    /**
+     * @brief Adds the cells of the row to the column width groups.
+     */
+    void bindColumns(std::span<WidthGroup> columns);
+
+    /**
+     * @brief Removes the cells of the row from the column width groups they were added to by `bindColumns`.
+     */
+    void unbindColumns(std::span<WidthGroup> columns);
+
 protected:
     Ptr cloneThis() const override;
 
@@ -206,7 +228,7 @@ public:
     }
 
 protected:
-    friend class Table;
+    friend class TableRow;
     bool m_widthGroupSet = false;
 
     Ptr cloneThis() const override;
@@ -78,12 +78,14 @@ protected:
 
     struct CacheKey2 {
         int width;
+        PointF alignment;
         bool operator==(const CacheKey2&) const noexcept = default;
     };
 
     struct Cached2 {
         SizeF textSize;
-        PreparedText prepared;
+        PreparedText prepared; // Aligned to CacheKey2::alignment
+        PointF offset;
     };
 
     Cached updateCache(const CacheKey&);
@@ -96,6 +98,8 @@ protected:
     void onFontChanged() override;
     void onChanged();
     void onLayoutUpdated() override;
+    void onRefresh() override;
+    PointF textAlignment() const;
     SizeF measure(AvailableSize size) const override;
     Ptr cloneThis() const override;
     explicit Text(Construction construction, std::string text, ArgumentsView<Text> args);
@@ -0,0 +1,163 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#pragma once
+
+#include <brisk/core/BasicTypes.hpp>
+#include <string>
+#include <vector>
+
+namespace Brisk {
+
+/**
+ * @brief Editable text stored as a sequence of paragraphs.
+ *
+ * The text is split at line feeds, and each paragraph is stored separately without its line feed.
+ * Edits only rewrite the paragraphs they touch. This keeps typing in large documents cheap.
+ *
+ * Positions are codepoint offsets into the whole text. Each paragraph except the last is followed
+ * by a single `'\n'`, which counts towards the offsets.
+ */
+class TextDocument {
+public:
+    /**
+     * @brief Describes the paragraphs replaced by an edit.
+     *
+     * Paragraphs `[first, first + removed)` of the document before the edit became paragraphs
+     * `[first, first + inserted)` after it. All other paragraphs are unchanged.
+     */
+    struct Change {
+        uint32_t first;
+        uint32_t removed;
+        uint32_t inserted;
+    };
+
+    /**
+     * @brief Constructs an empty document consisting of one empty paragraph.
+     */
+    TextDocument();
+
+    /**
+     * @brief Constructs a document from the given text.
+     */
+    explicit TextDocument(std::u32string_view text);
+
+    /**
+     * @brief Replaces the whole content of the document.
+     */
+    void assign(std::u32string_view text);
+
+    /**
+     * @brief Replaces the text in `range` with `text`.
+     *
+     * The range is clamped to the document.
+     *
+     * @return The paragraphs affected by the edit.
+     */
+    Change replace(Range<uint32_t> range, std::u32string_view text);
+
+    /**
+     * @brief Inserts `text` at `offset`.
+     */
+    Change insert(uint32_t offset, std::u32string_view text);
+
+    /**
+     * @brief Removes the text in `range`.
+     */
+    Change erase(Range<uint32_t> range);
+
+    /**
+     * @brief Returns the length of the text in codepoints, including line feeds.
+     */
+    uint32_t size() const noexcept {
+        return m_size;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    /**
+     * @brief Returns the number of paragraphs, which is always at least one.
+     */
+    uint32_t paragraphCount() const noexcept {
+        return m_paragraphs.size();
+    }
+
+    /**
+     * @brief Returns the text of a paragraph, without its line feed.
+     */
+    const std::u32string& paragraph(uint32_t index) const {
+        return m_paragraphs[index];
+    }
+
+    /**
+     * @brief Returns the offset of the first character of a paragraph.
+     */
+    uint32_t paragraphStart(uint32_t index) const;
+
+    /**
+     * @brief Returns the offsets covered by a paragraph, excluding its line feed.
+     */
+    Range<uint32_t> paragraphRange(uint32_t index) const;
+
+    /**
+     * @brief Returns the paragraph containing `offset`.
+     *
+     * An offset pointing at a line feed belongs to the paragraph the line feed ends.
+     */
+    uint32_t paragraphAt(uint32_t offset) const;
+
+    /**
+     * @brief Returns the character at `offset`.
+     */
+    char32_t at(uint32_t offset) const;
+
+    /**
+     * @brief Returns the text in `range`, with paragraphs joined by line feeds.
+     */
+    std::u32string text(Range<uint32_t> range) const;
+
+    /**
+     * @brief Returns the whole text, with paragraphs joined by line feeds.
+     */
+    std::u32string text() const;
+
+    /**
+     * @brief Returns the byte offset of `offset` in the UTF-8 encoding of the text.
+     *
+     * Only the paragraph containing `offset` is scanned, so a UTF-8 copy of the text can be patched
+     * along with the document.
+     */
+    uint32_t utf8Offset(uint32_t offset) const;
+
+private:
+    std::vector<std::u32string> m_paragraphs;
+    std::vector<uint32_t> m_utf8Sizes; // UTF-8 length of each paragraph
+    uint32_t m_size = 0;
+    // Offset of each paragraph in codepoints and in UTF-8 bytes. Entries from m_validStarts onwards are
+    // recomputed on demand
+    mutable std::vector<uint32_t> m_starts;
+    mutable std::vector<uint32_t> m_utf8Starts;
+    mutable uint32_t m_validStarts = 0;
+    void updateStarts() const;
+};
+
+} // namespace Brisk
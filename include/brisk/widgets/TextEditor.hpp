@@ -21,6 +21,7 @@
 #pragma once
 
 #include "Widgets.hpp"
+#include "TextDocument.hpp"
 #include <brisk/core/Binding.hpp>
 
 namespace Brisk {
@@ -42,48 +43,68 @@ protected:
     void paint(Canvas& canvas) const override;
     void onLayoutUpdated() override;
     void updateState();
-    void setTextInternal(std::string text);
-
-    void typeCharacter(std::u32string& text, char32_t character);
-
-    std::u32string m_cachedText;
+    void onTextChanged();
+    void onShapingChanged();
+
+    /**
+     * @brief Replaces a range of the text, updating `m_text` and reshaping only the touched paragraphs.
+     */
+    void replaceText(Range<uint32_t> range, std::u32string_view text);
+    void editText(Range<uint32_t> range, std::u32string_view text); // replaceText without normalization
+    void replaceSelection(std::u32string_view text);
+    void typeCharacter(char32_t character);
+
+    TextDocument m_document;
+    bool m_textIsValidUtf8 = true; // m_text can be patched in place
+
+    // Shaped paragraph of m_document
+    struct ParagraphLayout {
+        PreparedText prepared;
+        float top    = 0.f; // Offset from the top of the first paragraph
+        float height = 0.f;
+        float width  = 0.f;
+        bool shaped  = false;
+    };
 
-    mutable PreparedText m_preparedText;
+    mutable std::vector<ParagraphLayout> m_paragraphs;
+    mutable uint32_t m_validTops    = 0; // Paragraphs before this index have up-to-date `top`
+    mutable float m_layoutAlignment = 0.f;
+    mutable SizeF m_contentSize{ 0, 0 };
     Font m_cachedFont{};
 
+    void updateLayout() const;
+    void shapeParagraph(uint32_t index) const;
+    float paragraphBaseline(uint32_t index) const;
+    uint32_t paragraphAtY(float y) const;
+
     double m_blinkTime            = 0.0;
     bool m_blinkState             = true;
     int32_t m_startCursorDragging = 0;
     bool m_multiline              = false;
     void resetBlinking();
-    void updateGraphemes();
-    void makeCursorVisible(uint32_t textLen);
-    void selectAll(const std::u32string& text);
-    void deleteSelection(std::u32string& text);
-    void pasteFromClipboard(std::u32string& text);
-    void copyToClipboard(const std::u32string& text);
-    void cutToClipboard(std::u32string& text);
+    void makeCursorVisible();
     virtual void onSelectionChanged();
     void onRefresh() override;
 
     explicit TextEditor(Construction, ArgumentsView<TextEditor> args);
 
 private:
-    void normalizeCursor(uint32_t textLen);
+    void normalizeCursor();
     void createContextMenu();
     void selectionChanged();
 
 public:
     static const auto& properties() noexcept {
         static constexpr tuplet::tuple props{
-            /*0*/ Internal::PropFieldNotify{ &TextEditor::m_text, &TextEditor::updateState, "text" },
+            /*0*/ Internal::PropFieldNotify{ &TextEditor::m_text, &TextEditor::onTextChanged, "text" },
             /*1*/ Internal::PropField{ &TextEditor::m_onEnter, "onEnter" },
             /*2*/ Internal::PropField{ &TextEditor::m_placeholder, "placeholder" },
             /*3*/
-            Internal::PropFieldNotify{ &TextEditor::m_passwordChar, &TextEditor::updateState,
+            Internal::PropFieldNotify{ &TextEditor::m_passwordChar, &TextEditor::onShapingChanged,
                                        "passwordChar" },
             /*4*/
-            Internal::PropFieldNotify{ &TextEditor::m_multiline, &TextEditor::updateState, "multiline" },
+            Internal::PropFieldNotify{ &TextEditor::m_multiline, &TextEditor::onShapingChanged,
+                                       "multiline" },
         };
         return props;
     }
@@ -120,6 +141,14 @@ public:
     void selectAll();
     void deleteSelection();
     void pasteFromClipboard();
+
+    /**
+     * @brief Replaces the selection with the text as if it was pasted from the clipboard.
+     *
+     * Line breaks become spaces unless the editor is multiline.
+     */
+    void pasteText(std::string_view text);
+
     void copyToClipboard();
     void cutToClipboard();
 
@@ -0,0 +1,215 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#pragma once
+
+#include <brisk/widgets/Table.hpp>
+
+namespace Brisk {
+
+namespace Internal {
+
+/**
+ * @brief Vertical offsets of the rows of a virtual list.
+ *
+ * Rows that have not been measured yet are assumed to have the estimated height. Offsets and
+ * lookups by offset take O(log n).
+ */
+class RowOffsets {
+public:
+    void reset(size_t count, float estimatedHeight);
+
+    size_t size() const noexcept;
+
+    float estimatedHeight() const noexcept;
+
+    /// @brief Stores the measured height of the row. Returns true if the height has changed.
+    bool setHeight(size_t index, float height);
+
+    float height(size_t index) const noexcept;
+
+    bool isMeasured(size_t index) const noexcept;
+
+    /// @brief Returns the offset of the top of the row. offset(size()) is the total height.
+    float offset(size_t index) const noexcept;
+
+    float total() const noexcept;
+
+    /// @brief Returns the index of the row containing the offset, clamped to the valid range.
+    size_t indexAt(float offset) const noexcept;
+
+private:
+    float m_estimatedHeight = 0.f;
+    std::vector<float> m_heights; // negative if not measured yet
+    std::vector<float> m_deltas;  // Fenwick tree of differences from the estimated height
+};
+
+} // namespace Internal
+
+/**
+ * @brief Vertically scrolling list that creates widgets only for the rows near the visible area.
+ *
+ * Rows are created by the factory on demand. When a binder is given, rows that scroll out of view are kept
+ * in a pool and rebound to other indices instead of being destroyed. Row heights are estimated
+ * until the row has been laid out once and cached afterwards. Child widgets passed as arguments are
+ * ignored, all children are managed by the list.
+ */
+class WIDGET VirtualList : public Widget {
+    BRISK_DYNAMIC_CLASS(VirtualList, Widget)
+public:
+    using Base                                   = Widget;
+    constexpr static std::string_view widgetType = "virtuallist";
+
+    using RowFactory = function<Rc<Widget>(size_t index)>;
+    using RowBinder  = function<void(Widget* row, size_t index)>;
+
+    template <WidgetArgument... Args>
+    explicit VirtualList(size_t rowCount, RowFactory factory, RowBinder binder, const Args&... args)
+        : VirtualList{ Construction{ widgetType }, rowCount, std::move(factory), std::move(binder),
+                       std::tuple{ args... } } {
+        endConstruction();
+    }
+
+    /**
+     * @brief Range of row indices that currently have widgets.
+     */
+    Range<size_t> materializedRows() const noexcept;
+
+    /**
+     * @brief Returns the index of the row widget or std::nullopt if it is not a row of this list.
+     */
+    std::optional<size_t> rowIndex(const Widget* row) const noexcept;
+
+    /**
+     * @brief Returns the widget of the row if it is currently materialized.
+     */
+    Widget* rowWidget(size_t index) const noexcept;
+
+    /**
+     * @brief Rebinds the materialized rows, e.g. after the underlying data has changed.
+     */
+    void refreshRows();
+
+    /**
+     * @brief Scrolls the list so that the row is visible.
+     */
+    void scrollToRow(size_t index);
+
+    /**
+     * @brief Selection of the rows. Rows get WidgetState::Selected.
+     *
+     * Clicks on the rows update the selection if the list is selectable. After changing the selection
+     * in place, call bindings->notify(&list->selection()). Selection::order may be left empty.
+     */
+    Selection<size_t>& selection() noexcept;
+
+    /**
+     * @brief Replaces the selection and notifies its listeners.
+     */
+    void setSelection(Selection<size_t> selection);
+
+protected:
+    size_t m_rowCount              = 0;
+    float m_estimatedRowHeight     = 24.f;
+    RowFactory m_factory;
+    RowBinder m_binder;
+    bool m_selectable              = false;
+    Selection<size_t> m_selection;
+    Internal::RowOffsets m_offsets;
+    size_t m_first                 = 0; // index of the first materialized row
+    std::vector<Rc<Widget>> m_pool;     // rows that can be rebound
+    int m_builtScrollOffset        = -1;
+    int m_builtHeight              = -1;
+    std::optional<size_t> m_revealRow;
+
+    void rebuild(bool force) override;
+    void attachedToTree() override;
+    void onLayoutUpdated() override;
+    void onEvent(Event& event) override;
+
+    Ptr cloneThis() const override;
+    explicit VirtualList(Construction construction, size_t rowCount, RowFactory factory, RowBinder binder,
+                         ArgumentsView<VirtualList> args);
+
+    size_t numMaterialized() const noexcept;
+    Rc<Widget> acquireRow(size_t index);
+    virtual void releaseRow(size_t position);
+    void updateRows();
+    void updateSpacers();
+    void updateSelected();
+    void listenSelection();
+    void onRowCountChanged();
+
+public:
+    static const auto& properties() noexcept {
+        static constexpr tuplet::tuple props{
+            /*0*/
+            Internal::PropFieldNotify{ &VirtualList::m_rowCount, &VirtualList::onRowCountChanged,
+                                       "rowCount" },
+            /*1*/
+            Internal::PropFieldNotify{ &VirtualList::m_estimatedRowHeight, &VirtualList::onRowCountChanged,
+                                       "estimatedRowHeight" },
+            /*2*/
+            Internal::PropField{ &VirtualList::m_selectable, "selectable" },
+        };
+        return props;
+    }
+
+public:
+    BRISK_PROPERTIES_BEGIN
+    Property<VirtualList, size_t, 0> rowCount;
+    Property<VirtualList, float, 1> estimatedRowHeight;
+    Property<VirtualList, bool, 2> selectable;
+    BRISK_PROPERTIES_END
+};
+
+inline namespace Arg {
+constexpr inline PropArgument<decltype(VirtualList::rowCount)> rowCount{};
+constexpr inline PropArgument<decltype(VirtualList::estimatedRowHeight)> estimatedRowHeight{};
+constexpr inline PropArgument<decltype(VirtualList::selectable)> selectable{};
+} // namespace Arg
+
+/**
+ * @brief VirtualList whose rows are TableRow widgets sharing the column widths.
+ *
+ * Column widths are computed from the materialized rows only, pooled rows leave the column groups.
+ */
+class WIDGET VirtualTable : public VirtualList {
+    BRISK_DYNAMIC_CLASS(VirtualTable, VirtualList)
+public:
+    using Base                                   = VirtualList;
+    constexpr static std::string_view widgetType = "virtualtable";
+
+    template <WidgetArgument... Args>
+    explicit VirtualTable(size_t rowCount, RowFactory factory, RowBinder binder, const Args&... args)
+        : VirtualList{ Construction{ widgetType }, rowCount, std::move(factory), std::move(binder),
+                       std::tuple{ args... } } {
+        endConstruction();
+    }
+
+    std::array<WidthGroup, 32> columns;
+
+protected:
+    void onChildAdded(Widget* w) override;
+    void releaseRow(size_t position) override;
+    Ptr cloneThis() const override;
+};
+
+} // namespace Brisk
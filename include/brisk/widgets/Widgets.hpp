@@ -57,4 +57,5 @@
 #include "TextEditor.hpp"
 #include "ToggleButton.hpp"
 #include "ValueWidget.hpp"
+#include "VirtualList.hpp"
 #include "Viewport.hpp"
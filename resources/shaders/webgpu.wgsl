@@ -56,6 +56,9 @@ const subpixel_bgr       : subpixel_mode = 2u;
 /// Must match the value in Gradients.hpp
 const gradientMaxStops   = 24u;
 
+// Must match Internal::sdfSpread in Fonts.hpp
+const sdfSpread          = 8.0;
+
 // Vello code. Copyright 2022 the Vello Authors
 // SPDX-License-Identifier: Apache-2.0 OR MIT OR Unlicense
 // Github: linebender/vello
@@ -481,6 +484,9 @@ fn constant_composition_mode() -> u32 {
 fn constant_has_backdrop() -> bool {
     return ((constants.packed2 >> 16u) & 0xffu) != 0u;
 }
+fn constant_sdf_text() -> bool {
+    return ((constants.packed2 >> 24u) & 0xffu) != 0u;
+}
 
 fn get_data(index: u32) -> vec4<f32> {
     return bitcast<vec4<f32>>(data[constants.data_offset + index]);
@@ -549,6 +555,12 @@ fn alignRectangle(rect: vec4<f32>) -> vec4<f32> {
         let pt = mix(rect.xy - vec2<f32>(m), rect.zw + vec2<f32>(m), uv_coord);
         outPosition = vec4<f32>(pt, 0., 1.);
         output.uv = position * (m + m + rect.zw - rect.xy);
+    } else if constant_shader() == shader_text && constant_sdf_text() {
+        let rect = norm_rect(get_data(inst * 2u));
+        let glyph_data = get_data(inst * 2u + 1u);
+        outPosition = vec4<f32>(mix(rect.xy, rect.zw, uv_coord), 0., 1.);
+        output.uv = uv_coord * glyph_data.xy;
+        output.data0 = glyph_data;
     } else if constant_shader() == shader_text {
         var rect = norm_rect(get_data(inst * 2u));
         let glyph_data = get_data(inst * 2u + 1u);
@@ -945,6 +957,21 @@ fn atlasAccum(sprite: i32, pos: vec2<i32>, stride: u32) -> f32 {
     return alpha / f32(constant_sprite_oversampling());
 }
 
+fn atlasSdf(sprite: i32, uv: vec2<f32>, size: vec2<i32>, stride: u32) -> f32 {
+    let texel = uv - vec2<f32>(0.5);
+    let fl = floor(texel);
+    let f = texel - fl;
+    let p0 = clamp(vec2<i32>(fl), vec2<i32>(0), size - vec2<i32>(1));
+    let p1 = clamp(vec2<i32>(fl) + vec2<i32>(1), vec2<i32>(0), size - vec2<i32>(1));
+    let d = mix(mix(atlas(sprite, p0, stride), atlas(sprite, vec2<i32>(p1.x, p0.y), stride), f.x),
+                mix(atlas(sprite, vec2<i32>(p0.x, p1.y), stride), atlas(sprite, p1, stride), f.x), f.y);
+    // Signed distance to the outline in sprite texels, positive inside
+    let dist = (d * 255. - 128.) / 128. * sdfSpread;
+    let w = fwidth(uv);
+    let pixelsPerTexel = 2. / max(w.x + w.y, 0.0001);
+    return clamp(dist * pixelsPerTexel + 0.5, 0., 1.);
+}
+
 fn processSubpixelOutput(rgb: vec3<f32>) -> vec3<f32> {
     if constant_subpixel_mode() == subpixel_off {
         return vec3<f32>(dot(rgb, vec3<f32>(0.3333, 0.3334, 0.3333)));
@@ -1121,6 +1148,9 @@ fn rectangleCoverage(pt: vec2<f32>, rect: vec4<f32>) -> f32 {
             outBlend = vec4<f32>(shadeColor.a * rgb, 1.);
         } else if constant_shader() == shader_color_mask {
             outColor = shadeColor * atlasRGBA(sprite, tuv, stride);
+        } else if constant_sdf_text() {
+            let alpha = atlasSdf(sprite, in.uv, vec2<i32>(in.data0.xy), stride);
+            outColor = shadeColor * vec4<f32>(alpha);
         } else {
             var alpha = atlasAccum(sprite, tuv, stride);
             outColor = shadeColor * vec4<f32>(alpha);
@@ -483,6 +483,18 @@ template std::basic_string<char32_t> utfToUtf<char32_t, wchar_t>(std::basic_stri
 template std::basic_string<wchar_t> utfToUtf<wchar_t, wchar_t>(std::basic_string_view<wchar_t> sv,
                                                                UtfPolicy policy);
 
+void utf32ToUtf16(std::u16string& result, U32StringView text, UtfPolicy policy) {
+    const size_t len =
+        text.empty() ? 0 : utfMaxElements(char16_t{}) * utfCodepoints(text.data(), text.data() + text.size());
+    result.resize(len);
+    char16_t* end = policy == UtfPolicy::ReplaceInvalid
+                        ? utfConvert(result.data(), result.data() + len, text.data(), text.data() + text.size(),
+                                     CUtfPolicy<UtfPolicy::ReplaceInvalid>{})
+                        : utfConvert(result.data(), result.data() + len, text.data(), text.data() + text.size(),
+                                     CUtfPolicy<UtfPolicy::SkipInvalid>{});
+    result.resize(end - result.data());
+}
+
 template <typename InChar, UtfPolicy policy = UtfPolicy::ReplaceInvalid>
 std::basic_string<InChar> utfTransform(std::basic_string_view<InChar> text,
                                        function_ref<char32_t(char32_t)> fn,
@@ -79,6 +79,12 @@ TEST_CASE("Encoding") {
     CHECK(utf32ToUtf8(U"\U0001F603") == "\U0001F603");
     CHECK(utf32ToUtf16(U"\U0001F603") == u"\U0001F603");
 
+    std::u16string buffer = u"previous content";
+    utf32ToUtf16(buffer, U"a\U0001F603");
+    CHECK(buffer == u"a\U0001F603");
+    utf32ToUtf16(buffer, U"");
+    CHECK(buffer.empty());
+
     checkValid(U"", u"", "");
     checkValid(U"A", u"A", "A");
     checkValid(U"\U00000000", u"\U00000000", "\U00000000");
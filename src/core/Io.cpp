@@ -34,6 +34,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #endif
 #include <brisk/core/Text.hpp>
 #include <brisk/core/Utilities.hpp>
@@ -226,6 +228,77 @@ expected<Bytes, IoError> readBytes(const fs::path& file_name) {
     });
 }
 
+#ifdef BRISK_WINDOWS
+MappedFile::~MappedFile() {
+    if (!m_data.empty())
+        UnmapViewOfFile(m_data.data());
+    if (m_handle)
+        CloseHandle(m_handle);
+}
+
+static IoError win32ToResult(DWORD code) {
+    switch (code) {
+    case ERROR_FILE_NOT_FOUND:
+    case ERROR_PATH_NOT_FOUND:
+        return IoError::NotFound;
+    case ERROR_ACCESS_DENIED:
+    case ERROR_SHARING_VIOLATION:
+        return IoError::AccessDenied;
+    default:
+        return IoError::UnknownError;
+    }
+}
+
+expected<Rc<MappedFile>, IoError> mapFile(const fs::path& file_name) {
+    HANDLE file = CreateFileW(file_name.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return unexpected(win32ToResult(GetLastError()));
+    SCOPE_EXIT {
+        CloseHandle(file);
+    };
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+        return unexpected(IoError::CantRead);
+    Rc<MappedFile> result(new MappedFile());
+    if (size.QuadPart == 0)
+        return result;
+    result->m_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!result->m_handle)
+        return unexpected(IoError::CantRead);
+    void* ptr = MapViewOfFile(result->m_handle, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr)
+        return unexpected(IoError::CantRead);
+    result->m_data = BytesView(static_cast<const std::byte*>(ptr), size.QuadPart);
+    return result;
+}
+#else
+MappedFile::~MappedFile() {
+    if (!m_data.empty())
+        munmap(const_cast<std::byte*>(m_data.data()), m_data.size());
+}
+
+expected<Rc<MappedFile>, IoError> mapFile(const fs::path& file_name) {
+    int fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return unexpected(posixToResult(errno));
+    SCOPE_EXIT {
+        close(fd);
+    };
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        return unexpected(posixToResult(errno));
+    Rc<MappedFile> result(new MappedFile());
+    if (st.st_size == 0)
+        return result;
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED)
+        return unexpected(IoError::CantRead);
+    result->m_data = BytesView(static_cast<const std::byte*>(ptr), st.st_size);
+    return result;
+}
+#endif
+
 expected<std::string, IoError> readUtf8(const fs::path& file_name, bool removeBOM) {
     return readBytes(file_name).map([removeBOM](const Bytes& b) {
         if (removeBOM)
@@ -360,6 +433,11 @@ fs::path defaultFolder(DefaultFolder folder) {
         return platformDefaultFolder(static_cast<DefaultFolder>(+folder - +DefaultFolder::AppUserData +
                                                                 +DefaultFolder::UserData)) /
                strOr(appMetadata.vendor, defaultVendor) / strOr(appMetadata.name, defaultName);
+    case DefaultFolder::Cache:
+        return platformDefaultFolder(folder);
+    case DefaultFolder::AppCache:
+        return platformDefaultFolder(DefaultFolder::Cache) / strOr(appMetadata.vendor, defaultVendor) /
+               strOr(appMetadata.name, defaultName);
     default:
         BRISK_UNREACHABLE();
     }
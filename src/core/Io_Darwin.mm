@@ -46,6 +46,8 @@ fs::path platformDefaultFolder(DefaultFolder folder) {
         return home / "Library" / "Application Support";
     case DefaultFolder::SystemData:
         return root / "Library" / "Application Support";
+    case DefaultFolder::Cache:
+        return home / "Library" / "Caches";
     default:
         return home / "Documents";
     }
@@ -91,6 +91,10 @@ fs::path platformDefaultFolder(DefaultFolder folder) {
         return "/usr/local/share/";
     case DefaultFolder::UserData:
         return get("XDG_DATA_HOME", ".local/share");
+    case DefaultFolder::Cache:
+        if (const char* cache = std::getenv("XDG_CACHE_HOME"); cache && *cache)
+            return cache;
+        return userHome() / ".cache";
     default:
         BRISK_UNREACHABLE();
     }
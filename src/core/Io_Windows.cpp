@@ -187,6 +187,8 @@ static REFKNOWNFOLDERID folderId(DefaultFolder folder) {
         return FOLDERID_RoamingAppData;
     case DefaultFolder::SystemData:
         return FOLDERID_ProgramData;
+    case DefaultFolder::Cache:
+        return FOLDERID_LocalAppData;
     default:
         return FOLDERID_Documents;
     }
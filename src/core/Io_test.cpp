@@ -65,6 +65,26 @@ TEST_CASE("defaultPaths") {
     fmt::println("DefaultFolder::AppUserData = {}", defaultFolder(DefaultFolder::AppUserData).string());
     fmt::println("DefaultFolder::AppSystemData = {}", defaultFolder(DefaultFolder::AppSystemData).string());
     fmt::println("DefaultFolder::AppHome = {}", defaultFolder(DefaultFolder::AppHome).string());
+    fmt::println("DefaultFolder::Cache = {}", defaultFolder(DefaultFolder::Cache).string());
+    fmt::println("DefaultFolder::AppCache = {}", defaultFolder(DefaultFolder::AppCache).string());
+}
+
+TEST_CASE("mapFile") {
+    fs::path path = tempFilePath("brisk-map-*.bin");
+    REQUIRE(writeBytes(path, toBytesView("mapped contents")).has_value());
+    {
+        auto mapped = mapFile(path);
+        REQUIRE(mapped.has_value());
+        CHECK(toStringView((*mapped)->data()) == "mapped contents");
+    }
+    REQUIRE(writeBytes(path, BytesView{}).has_value());
+    {
+        auto mapped = mapFile(path);
+        REQUIRE(mapped.has_value());
+        CHECK((*mapped)->data().empty());
+    }
+    fs::remove(path);
+    CHECK(mapFile(path).error() == IoError::NotFound);
 }
 
 TEST_CASE("executablePath") {
@@ -0,0 +1,100 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#include <brisk/core/internal/SizeClassPool.hpp>
+#include <algorithm>
+#include <new>
+
+namespace Brisk {
+
+namespace Internal {
+
+SizeClassPool::SizeClassPool(size_t granularity, size_t numClasses, size_t maxRetained)
+    : m_granularity(granularity), m_maxRetained(maxRetained), m_freeLists(numClasses, nullptr) {}
+
+SizeClassPool::~SizeClassPool() {
+    trim();
+}
+
+size_t SizeClassPool::classIndex(size_t size) const noexcept {
+    return (std::max(size, size_t(1)) + m_granularity - 1) / m_granularity - 1;
+}
+
+void* SizeClassPool::allocate(size_t size) {
+    const size_t index = classIndex(size);
+    if (index < m_freeLists.size()) {
+        std::lock_guard lk(m_mutex);
+        if (FreeBlock* block = m_freeLists[index]) {
+            m_freeLists[index] = block->next;
+            m_retainedBytes -= (index + 1) * m_granularity;
+            ++m_numBlocks;
+            return block;
+        }
+    }
+    void* ptr = alignedAlloc((index + 1) * m_granularity, m_granularity);
+    if (!ptr)
+        throw std::bad_alloc();
+    std::lock_guard lk(m_mutex);
+    ++m_numBlocks;
+    return ptr;
+}
+
+void SizeClassPool::deallocate(void* ptr, size_t size) noexcept {
+    if (!ptr)
+        return;
+    const size_t index = classIndex(size);
+    {
+        std::lock_guard lk(m_mutex);
+        --m_numBlocks;
+        const size_t blockSize = (index + 1) * m_granularity;
+        if (index < m_freeLists.size() && m_retainedBytes + blockSize <= m_maxRetained) {
+            m_freeLists[index] = new (ptr) FreeBlock{ m_freeLists[index] };
+            m_retainedBytes += blockSize;
+            return;
+        }
+    }
+    alignedFree(ptr);
+}
+
+void SizeClassPool::trim() noexcept {
+    std::vector<FreeBlock*> lists;
+    {
+        std::lock_guard lk(m_mutex);
+        lists.swap(m_freeLists);
+        m_freeLists.assign(lists.size(), nullptr);
+        m_retainedBytes = 0;
+    }
+    for (FreeBlock* block : lists) {
+        while (block) {
+            FreeBlock* next = block->next;
+            alignedFree(block);
+            block = next;
+        }
+    }
+}
+
+SizeClassPoolStat SizeClassPool::stat() const {
+    std::lock_guard lk(m_mutex);
+    return { m_numBlocks, m_retainedBytes };
+}
+
+} // namespace Internal
+
+} // namespace Brisk
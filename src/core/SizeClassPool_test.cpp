@@ -0,0 +1,58 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#include <brisk/core/internal/SizeClassPool.hpp>
+#include <catch2/catch_all.hpp>
+#include "Catch2Utils.hpp"
+
+namespace Brisk {
+
+TEST_CASE("SizeClassPool") {
+    Internal::SizeClassPool pool(16, 4, 48);
+    CHECK(pool.stat() == Internal::SizeClassPoolStat{ 0, 0 });
+
+    void* a = pool.allocate(20);
+    void* b = pool.allocate(33);
+    CHECK(reinterpret_cast<uintptr_t>(a) % 16 == 0);
+    CHECK(reinterpret_cast<uintptr_t>(b) % 16 == 0);
+    CHECK(pool.stat() == Internal::SizeClassPoolStat{ 2, 0 });
+
+    pool.deallocate(a, 20);
+    CHECK(pool.stat() == Internal::SizeClassPoolStat{ 1, 32 });
+    // Freed block of the same size class is reused
+    void* c = pool.allocate(32);
+    CHECK(c == a);
+    CHECK(pool.stat() == Internal::SizeClassPoolStat{ 2, 0 });
+
+    // Larger than the largest class, never retained
+    void* large = pool.allocate(65);
+    pool.deallocate(large, 65);
+    CHECK(pool.stat() == Internal::SizeClassPoolStat{ 2, 0 });
+
+    pool.deallocate(b, 33);
+    // Retaining this block would exceed the limit of 48 bytes, so it is freed
+    pool.deallocate(c, 32);
+    CHECK(pool.stat() == Internal::SizeClassPoolStat{ 0, 48 });
+
+    pool.trim();
+    CHECK(pool.stat() == Internal::SizeClassPoolStat{ 0, 0 });
+}
+
+} // namespace Brisk
@@ -97,7 +97,7 @@ SpriteOffset SpriteAtlas::addEntry(Rc<SpriteResource> sprite, uint64_t firstGene
 
     bool allowGrow      = false;
 
-    SpriteOffset offset = add(sprite->bytes(), allowGrow);
+    SpriteOffset offset = add(std::as_const(*sprite).bytes(), allowGrow);
     while (offset == spriteNull) {
         if (!removeOutdated(firstGeneration)) {
             // Cannot remove any more sprites, but there is still no space for a new sprite
@@ -105,7 +105,7 @@ SpriteOffset SpriteAtlas::addEntry(Rc<SpriteResource> sprite, uint64_t firstGene
                 return spriteNull;
             allowGrow = true;
         }
-        offset = add(sprite->bytes(), allowGrow);
+        offset = add(std::as_const(*sprite).bytes(), allowGrow);
     }
     BRISK_ASSERT(offset != spriteNull);
     m_sprites.insert(
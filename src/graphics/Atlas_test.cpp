@@ -0,0 +1,47 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#include <catch2/catch_all.hpp>
+#include "Catch2Utils.hpp"
+#include "Atlas.hpp"
+
+namespace Brisk {
+
+TEST_CASE("SpriteAtlas") {
+    SpriteAtlas atlas(1024, 4096, 1024, nullptr);
+    Rc<SpriteResource> sprite = makeSprite(Size{ 10, 10 });
+    std::memset(sprite->data(), 1, 100);
+    SpriteOffset s1 = atlas.addEntry(sprite, 0, 1);
+    CHECK(s1 == 0);
+    CHECK(atlas.numSprites() == 1);
+    CHECK(atlas.data()[99] == 1);
+
+    Rc<SpriteResource> sprite2 = makeSprite(Size{ 10, 5 });
+    std::memset(sprite2->data(), 2, 50);
+    SpriteOffset s2 = atlas.addEntry(sprite2, 0, 1);
+    CHECK(s2 == alignUp(100, SpriteAtlas::alignment) / SpriteAtlas::alignment);
+    CHECK(atlas.data()[s2 * SpriteAtlas::alignment + 49] == 2);
+
+    // Already in atlas, the same offset is returned
+    CHECK(atlas.addEntry(sprite2, 0, 2) == s2);
+    CHECK(atlas.numSprites() == 2);
+}
+
+} // namespace Brisk
@@ -64,19 +64,20 @@ static PointF quantize(PointF pt, unsigned value) {
     };
 }
 
-static GeometryGlyphs glyphLayout(uint32_t& runIndex, bool& multicolor, std::optional<Color>& color,
-                                  SpriteResources& sprites, const PreparedText& prepared,
-                                  PointF offset = { 0, 0 }) {
+static GeometryGlyphs glyphLayout(uint32_t& runIndex, uint32_t runEnd, bool& multicolor, bool& sdf,
+                                  std::optional<Color>& color, SpriteResources& sprites,
+                                  const PreparedText& prepared, PointF offset = { 0, 0 }) {
     GeometryGlyphs result;
     bool first = true;
-    for (; runIndex < prepared.runs.size(); ++runIndex) {
+    for (; runIndex < runEnd; ++runIndex) {
         const GlyphRun& run = prepared.runVisual(runIndex);
         if (first) {
             color      = run.color;
             multicolor = run.hasColor();
+            sdf        = run.isSdf();
             first      = false;
         } else {
-            if (run.color != color || run.hasColor() != multicolor)
+            if (run.color != color || run.hasColor() != multicolor || run.isSdf() != sdf)
                 return result;
         }
 
@@ -85,9 +86,23 @@ static GeometryGlyphs glyphLayout(uint32_t& runIndex, bool& multicolor, std::opt
             if (data && data->sprite) {
                 GeometryGlyph glyphDesc;
                 PointF pos        = g.pos + run.position + offset;
-                glyphDesc.rect.p1 = quantize(pos + PointF(data->offset_x, -data->offset_y), run.hscale());
+                if (sdf) {
+                    // The sprite holds the glyph at sdfReferenceSize, scale the quad to the run's size
+                    const float scale = run.fontSize / Internal::sdfReferenceSize;
+                    glyphDesc.rect.p1 = pos + PointF(data->offset_x, -data->offset_y) * scale;
+                    glyphDesc.rect.p2 = glyphDesc.rect.p1 + PointF(data->size.width, data->size.height) * scale;
+                    glyphDesc.sprite  = static_cast<float>(findOrAdd(sprites, data->sprite));
+                    glyphDesc.stride  = data->size.width;
+                    glyphDesc.size    = data->size;
+                    result.push_back(std::move(glyphDesc));
+                    continue;
+                }
+                // Color glyphs may be rasterized at a nearby size and scaled
+                glyphDesc.rect.p1 =
+                    quantize(pos + PointF(data->offset_x, -data->offset_y) * data->scale, run.hscale());
                 glyphDesc.rect.p2 =
-                    glyphDesc.rect.p1 + PointF(float(data->size.width) / run.hscale(), data->size.height);
+                    glyphDesc.rect.p1 +
+                    PointF(float(data->size.width) / run.hscale(), data->size.height) * data->scale;
                 glyphDesc.sprite = static_cast<float>(findOrAdd(sprites, data->sprite));
                 glyphDesc.stride = data->size.width;
                 if (run.hasColor())
@@ -101,6 +116,69 @@ static GeometryGlyphs glyphLayout(uint32_t& runIndex, bool& multicolor, std::opt
     return result;
 }
 
+namespace Internal {
+// Glyph quads of a PreparedText, grouped into batches that are drawn with a single command each
+struct TextGeometryCache {
+    struct Batch {
+        GeometryGlyphs glyphs; // Positioned for `origin`
+        SpriteResources sprites;
+        Range<uint32_t> runRange; // In visual order
+        uint32_t line = 0;        // Batches never span lines
+        std::optional<Color> color;
+        bool multicolor = false;
+        bool sdf        = false;
+    };
+
+    std::vector<Batch> batches;
+    PointF origin;
+    uint32_t glyphGeneration = 0; // Rebuilt once glyphs drawn as placeholders become available
+
+    // Quads are snapped to the pixel grid (horizontally to subpixels), so they can only be moved by whole
+    // pixels without rebuilding. SDF quads are not snapped
+    bool reusableAt(PointF position) const noexcept {
+        const PointF delta = position - origin;
+        if (delta.x == std::round(delta.x) && delta.y == std::round(delta.y))
+            return true;
+        for (const Batch& batch : batches) {
+            if (!batch.sdf)
+                return false;
+        }
+        return true;
+    }
+};
+} // namespace Internal
+
+static const Internal::TextGeometryCache& textGeometry(const PreparedText& text, PointF position) {
+    const uint32_t glyphGeneration = fonts->glyphGeneration();
+    if (text.geometryCache && text.geometryCache->glyphGeneration == glyphGeneration &&
+        text.geometryCache->reusableAt(position))
+        return *text.geometryCache;
+
+    // Never modified in place, copies of the PreparedText may share it
+    Rc<Internal::TextGeometryCache> cache = rcnew Internal::TextGeometryCache{};
+    cache->origin                         = position;
+    cache->glyphGeneration                = glyphGeneration;
+    uint32_t runIndex                     = 0;
+
+    auto addBatches = [&](uint32_t line, uint32_t runEnd) {
+        while (runIndex < runEnd) {
+            Internal::TextGeometryCache::Batch batch;
+            batch.runRange.min = runIndex;
+            batch.line         = line;
+            batch.glyphs = glyphLayout(runIndex, runEnd, batch.multicolor, batch.sdf, batch.color,
+                                       batch.sprites, text, position);
+            batch.runRange.max = runIndex;
+            cache->batches.push_back(std::move(batch));
+        }
+    };
+    for (uint32_t line = 0; line < text.lines.size(); ++line) {
+        addBatches(line, std::min(text.lines[line].runRange.max, uint32_t(text.runs.size())));
+    }
+    addBatches(text.lines.empty() ? 0 : text.lines.size() - 1, text.runs.size());
+    text.geometryCache = std::move(cache);
+    return *text.geometryCache;
+}
+
 GeometryGlyphs Internal::pathLayout(SpriteResources& sprites, const RasterizedPath& path) {
     GeometryGlyphs result;
     if (path.sprite) {
@@ -140,6 +218,19 @@ void Canvas::drawColorSprites(SpriteResources sprites, std::span<const GeometryG
     m_context->command(std::move(style), glyphs);
 }
 
+void Canvas::drawSdfTextSprites(SpriteResources sprites, std::span<const GeometryGlyph> glyphs,
+                                RenderStateExArgs args) {
+    RenderStateEx style(ShaderType::Text, glyphs.size(), args);
+    style.subpixelMode       = SubpixelMode::Off;
+    style.spriteOversampling = 1;
+    style.sdfText            = true;
+    style.sprites            = std::move(sprites);
+    style.scissor            = m_state.scissor;
+    style.premultiply();
+    setRenderComposition(style, m_state.composition);
+    m_context->command(std::move(style), glyphs);
+}
+
 void Canvas::drawTextSprites(SpriteResources sprites, std::span<const GeometryGlyph> glyphs,
                              RenderStateExArgs args) {
     RenderStateEx style(ShaderType::Text, glyphs.size(), args);
@@ -705,33 +796,65 @@ void Canvas::fillText(PointF position, PointF alignment, const PreparedText& tex
     if (alignment != PointF{}) {
         position -= PointF(text.bounds().size()) * alignment;
     }
-    Paint textPaint = m_state.fillPaint;
-
-    SpriteResources sprites;
-    uint32_t runIndex = 0;
-    while (runIndex < text.runs.size()) {
-        std::optional<Color> runColor;
-        uint32_t oldRunIndex = runIndex;
-        bool multicolor      = false;
-        GeometryGlyphs g     = glyphLayout(runIndex, multicolor, runColor, sprites, text, position);
-        if (multicolor)
+    Paint textPaint                          = m_state.fillPaint;
+
+    const Internal::TextGeometryCache& cache = textGeometry(text, position);
+    const PointF delta                       = position - cache.origin;
+
+    // Skip the lines outside the scissor
+    Range<uint32_t> visibleLines{ 0, UINT32_MAX };
+    if (m_state.scissor != noClipRect && !text.lines.empty()) {
+        if (std::optional<Matrix> inverse = m_state.transform.invert()) {
+            RectangleF clip    = inverse->transform(RectangleF(m_state.scissor));
+            // Glyphs may overhang the ascender and descender of their line
+            const float margin = text.lines.front().ascDesc.height();
+            visibleLines = text.linesInRange(clip.y1 - position.y - margin, clip.y2 - position.y + margin);
+        }
+    }
+    auto firstBatch = std::partition_point(cache.batches.begin(), cache.batches.end(),
+                                           [&](const Internal::TextGeometryCache::Batch& batch) {
+                                               return batch.line < visibleLines.min;
+                                           });
+
+    GeometryGlyphs moved;
+    for (const Internal::TextGeometryCache::Batch& batch :
+         std::span{ firstBatch, cache.batches.end() }) {
+        if (batch.line >= visibleLines.max)
+            break;
+        const std::optional<Color>& runColor = batch.color;
+        std::span<const GeometryGlyph> g     = batch.glyphs;
+        if (delta != PointF{}) {
+            moved.assign(batch.glyphs.begin(), batch.glyphs.end());
+            for (GeometryGlyph& glyph : moved) {
+                glyph.rect = glyph.rect.withOffset(delta);
+            }
+            g = moved;
+        }
+        if (batch.multicolor)
             drawColorSprites(
-                std::move(sprites), g,
+                batch.sprites, g,
                 std::tuple{
                     Arg::coordMatrix  = m_state.transform,
                     Arg::subpixelMode = m_state.subpixelText ? SubpixelMode::RGB : SubpixelMode::Off,
                     Internal::PaintAndTransform{ Palette::white, m_state.transform, m_state.opacity },
                 });
+        else if (batch.sdf)
+            drawSdfTextSprites(batch.sprites, g,
+                               std::tuple{
+                                   Arg::coordMatrix = m_state.transform,
+                                   Internal::PaintAndTransform{ runColor ? *runColor : textPaint,
+                                                                m_state.transform, m_state.opacity },
+                               });
         else
             drawTextSprites(
-                std::move(sprites), g,
+                batch.sprites, g,
                 std::tuple{
                     Arg::coordMatrix  = m_state.transform,
                     Arg::subpixelMode = m_state.subpixelText ? SubpixelMode::RGB : SubpixelMode::Off,
                     Internal::PaintAndTransform{ runColor ? *runColor : textPaint, m_state.transform,
                                                  m_state.opacity },
                 });
-        for (uint32_t ri = oldRunIndex; ri < runIndex; ++ri) {
+        for (uint32_t ri = batch.runRange.min; ri < batch.runRange.max; ++ri) {
             const GlyphRun& run = text.runVisual(ri);
             if (run.decoration != TextDecoration::None) {
                 run.updateRanges();
@@ -828,6 +951,7 @@ Canvas::ScissorSaver Canvas::saveScissor() & {
 
 void Canvas::fillTextSelection(PointF position, const PreparedText& text, Range<uint32_t> selection) {
     if (selection.distance() != 0) {
+        text.ensureCaretData();
         selection.min = text.characterToGrapheme(selection.min);
         selection.max = text.characterToGrapheme(selection.max);
         for (uint32_t gr : selection) {
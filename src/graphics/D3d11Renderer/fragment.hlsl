@@ -379,6 +379,10 @@ bool constant_has_backdrop() {
   return (((constants[1].z >> 16u) & 255u) != 0u);
 }
 
+bool constant_sdf_text() {
+  return (((constants[1].z >> 24u) & 255u) != 0u);
+}
+
 float2 map(float2 p1, float2 p2) {
   return float2(((p1.x * p2.x) + (p1.y * p2.y)), ((p1.x * p2.y) - (p1.y * p2.x)));
 }
@@ -821,13 +825,30 @@ float atlasAccum(int sprite, int2 pos, uint stride) {
   return (tint_symbol_74 / tint_symbol_76);
 }
 
+float atlasSdf(int sprite, float2 uv, int2 size, uint stride) {
+  float2 texel = (uv - (0.5f).xx);
+  float2 fl = floor(texel);
+  float2 f = (texel - fl);
+  int2 p0 = clamp(tint_ftoi_1(fl), (0).xx, (size - (1).xx));
+  int2 p1 = clamp((tint_ftoi_1(fl) + (1).xx), (0).xx, (size - (1).xx));
+  float tint_symbol_81 = atlas(sprite, p0, stride);
+  float tint_symbol_82 = atlas(sprite, int2(p1.x, p0.y), stride);
+  float tint_symbol_83 = atlas(sprite, int2(p0.x, p1.y), stride);
+  float tint_symbol_84 = atlas(sprite, p1, stride);
+  float d = lerp(lerp(tint_symbol_81, tint_symbol_82, f.x), lerp(tint_symbol_83, tint_symbol_84, f.x), f.y);
+  float dist = ((((d * 255.0f) - 128.0f) / 128.0f) * 8.0f);
+  float2 w = fwidth(uv);
+  float pixelsPerTexel = (2.0f / max((w.x + w.y), 0.00009999999747378752f));
+  return clamp(((dist * pixelsPerTexel) + 0.5f), 0.0f, 1.0f);
+}
+
 float3 processSubpixelOutput(float3 rgb) {
-  uint tint_symbol_81 = constant_subpixel_mode();
-  if ((tint_symbol_81 == 0u)) {
+  uint tint_symbol_85 = constant_subpixel_mode();
+  if ((tint_symbol_85 == 0u)) {
     return float3((dot(rgb, float3(0.33329999446868896484f, 0.33340001106262207031f, 0.33329999446868896484f))).xxx);
   } else {
-    uint tint_symbol_82 = constant_subpixel_mode();
-    if ((tint_symbol_82 == 2u)) {
+    uint tint_symbol_86 = constant_subpixel_mode();
+    if ((tint_symbol_86 == 2u)) {
       return rgb.bgr;
     } else {
       return rgb;
@@ -836,28 +857,28 @@ float3 processSubpixelOutput(float3 rgb) {
 }
 
 float3 atlasSubpixel(int sprite, int2 pos, uint stride) {
-  int tint_symbol_83 = constant_sprite_oversampling();
-  if ((tint_symbol_83 == 6)) {
-    float tint_symbol_84 = atlas(sprite, (pos + int2(-2, 0)), stride);
-    float tint_symbol_85 = atlas(sprite, (pos + int2(-1, 0)), stride);
-    float x0 = (tint_symbol_84 + tint_symbol_85);
-    float tint_symbol_86 = atlas(sprite, (pos + (0).xx), stride);
-    float tint_symbol_87 = atlas(sprite, (pos + int2(1, 0)), stride);
-    float x1 = (tint_symbol_86 + tint_symbol_87);
-    float tint_symbol_88 = atlas(sprite, (pos + int2(2, 0)), stride);
-    float tint_symbol_89 = atlas(sprite, (pos + int2(3, 0)), stride);
-    float x2 = (tint_symbol_88 + tint_symbol_89);
-    float tint_symbol_90 = atlas(sprite, (pos + int2(4, 0)), stride);
-    float tint_symbol_91 = atlas(sprite, (pos + int2(5, 0)), stride);
-    float x3 = (tint_symbol_90 + tint_symbol_91);
-    float tint_symbol_92 = atlas(sprite, (pos + int2(6, 0)), stride);
-    float tint_symbol_93 = atlas(sprite, (pos + int2(7, 0)), stride);
-    float x4 = (tint_symbol_92 + tint_symbol_93);
+  int tint_symbol_87 = constant_sprite_oversampling();
+  if ((tint_symbol_87 == 6)) {
+    float tint_symbol_88 = atlas(sprite, (pos + int2(-2, 0)), stride);
+    float tint_symbol_89 = atlas(sprite, (pos + int2(-1, 0)), stride);
+    float x0 = (tint_symbol_88 + tint_symbol_89);
+    float tint_symbol_90 = atlas(sprite, (pos + (0).xx), stride);
+    float tint_symbol_91 = atlas(sprite, (pos + int2(1, 0)), stride);
+    float x1 = (tint_symbol_90 + tint_symbol_91);
+    float tint_symbol_92 = atlas(sprite, (pos + int2(2, 0)), stride);
+    float tint_symbol_93 = atlas(sprite, (pos + int2(3, 0)), stride);
+    float x2 = (tint_symbol_92 + tint_symbol_93);
+    float tint_symbol_94 = atlas(sprite, (pos + int2(4, 0)), stride);
+    float tint_symbol_95 = atlas(sprite, (pos + int2(5, 0)), stride);
+    float x3 = (tint_symbol_94 + tint_symbol_95);
+    float tint_symbol_96 = atlas(sprite, (pos + int2(6, 0)), stride);
+    float tint_symbol_97 = atlas(sprite, (pos + int2(7, 0)), stride);
+    float x4 = (tint_symbol_96 + tint_symbol_97);
     float3 filt = float3(0.125f, 0.25f, 0.125f);
     return float3(dot(float3(x0, x1, x2), filt), dot(float3(x1, x2, x3), filt), dot(float3(x2, x3, x4), filt));
   } else {
-    int tint_symbol_94 = constant_sprite_oversampling();
-    if ((tint_symbol_94 == 3)) {
+    int tint_symbol_98 = constant_sprite_oversampling();
+    if ((tint_symbol_98 == 3)) {
       float x0 = atlas(sprite, (pos + int2(-2, 0)), stride);
       float x1 = atlas(sprite, (pos + int2(-1, 0)), stride);
       float x2 = atlas(sprite, (pos + (0).xx), stride);
@@ -887,8 +908,8 @@ float2 erf(float2 x) {
 float roundedBoxShadowX(float x, float y, float sigma, float corner, float2 halfSize) {
   float delta = min(((halfSize.y - corner) - abs(y)), 0.0f);
   float curved = ((halfSize.x - corner) + sqrt(max(0.0f, ((corner * corner) - (delta * delta)))));
-  float2 tint_symbol_95 = erf(((float2((x).xx) + float2(-(curved), curved)) * (0.70710676908493041992f / sigma)));
-  float2 integral = (0.5f + (0.5f * tint_symbol_95));
+  float2 tint_symbol_99 = erf(((float2((x).xx) + float2(-(curved), curved)) * (0.70710676908493041992f / sigma)));
+  float2 integral = (0.5f + (0.5f * tint_symbol_99));
   return (integral.y - integral.x);
 }
 
@@ -904,10 +925,10 @@ float roundedBoxShadow(float2 halfSize, float2 tint_symbol_1, float sigma, float
   float corner = abs(border_radii[quadrant]);
   {
     for(int i = 0; (i < 4); i = (i + 1)) {
-      float tint_symbol_96 = value;
-      float tint_symbol_97 = roundedBoxShadowX(tint_symbol_1.x, (tint_symbol_1.y - y), sigma, corner, halfSize);
-      float tint_symbol_98 = gaussian(y, sigma);
-      value = (tint_symbol_96 + ((tint_symbol_97 * tint_symbol_98) * step));
+      float tint_symbol_100 = value;
+      float tint_symbol_101 = roundedBoxShadowX(tint_symbol_1.x, (tint_symbol_1.y - y), sigma, corner, halfSize);
+      float tint_symbol_102 = gaussian(y, sigma);
+      value = (tint_symbol_100 + ((tint_symbol_101 * tint_symbol_102) * step));
       y = (y + step);
     }
   }
@@ -928,18 +949,18 @@ struct FragOut {
 };
 
 bool useBlending() {
-  uint tint_symbol_101 = constant_shader();
-  bool tint_symbol_100 = (tint_symbol_101 == 1u);
-  if (!(tint_symbol_100)) {
-    uint tint_symbol_102 = constant_shader();
-    tint_symbol_100 = (tint_symbol_102 == 5u);
+  uint tint_symbol_105 = constant_shader();
+  bool tint_symbol_104 = (tint_symbol_105 == 1u);
+  if (!(tint_symbol_104)) {
+    uint tint_symbol_106 = constant_shader();
+    tint_symbol_104 = (tint_symbol_106 == 5u);
   }
-  bool tint_symbol_99 = tint_symbol_100;
-  if (tint_symbol_99) {
-    uint tint_symbol_103 = constant_subpixel_mode();
-    tint_symbol_99 = (tint_symbol_103 != 0u);
+  bool tint_symbol_103 = tint_symbol_104;
+  if (tint_symbol_103) {
+    uint tint_symbol_107 = constant_subpixel_mode();
+    tint_symbol_103 = (tint_symbol_107 != 0u);
   }
-  return tint_symbol_99;
+  return tint_symbol_103;
 }
 
 FragOut postprocessColor(FragOut tint_symbol_3, float2 canvas_coord) {
@@ -950,9 +971,9 @@ FragOut postprocessColor(FragOut tint_symbol_3, float2 canvas_coord) {
     uint hpattern = (constants[7].z & 4095u);
     uint vpattern = (constants[7].z >> 12u);
     uint2 coords = tint_ftou(canvas_coord);
-    uint tint_symbol_108 = samplePattern(tint_div(coords.x, pattern_scale), hpattern);
-    uint tint_symbol_109 = samplePattern(tint_div(coords.y, pattern_scale), vpattern);
-    uint p = (tint_symbol_108 & tint_symbol_109);
+    uint tint_symbol_112 = samplePattern(tint_div(coords.x, pattern_scale), hpattern);
+    uint tint_symbol_113 = samplePattern(tint_div(coords.y, pattern_scale), vpattern);
+    uint p = (tint_symbol_112 & tint_symbol_113);
     opacity = (opacity * float(p));
   }
   tint_symbol_4.color = (tint_symbol_4.color * opacity);
@@ -972,12 +993,12 @@ FragOut postprocessColor(FragOut tint_symbol_3, float2 canvas_coord) {
     }
   }
   if (constant_has_backdrop()) {
-    float2 tint_symbol_104 = transformedBackTexCoord(canvas_coord);
-    float4 tint_symbol_5 = backTexture_t.Sample(boundTexture_s, tint_symbol_104);
-    float4 tint_symbol_105 = tint_symbol_5;
-    float4 tint_symbol_106 = tint_symbol_4.color;
-    uint tint_symbol_107 = constant_composition_mode();
-    tint_symbol_4.color = blend_mix_compose(tint_symbol_105, tint_symbol_106, tint_symbol_107);
+    float2 tint_symbol_108 = transformedBackTexCoord(canvas_coord);
+    float4 tint_symbol_5 = backTexture_t.Sample(boundTexture_s, tint_symbol_108);
+    float4 tint_symbol_109 = tint_symbol_5;
+    float4 tint_symbol_110 = tint_symbol_4.color;
+    uint tint_symbol_111 = constant_composition_mode();
+    tint_symbol_4.color = blend_mix_compose(tint_symbol_109, tint_symbol_110, tint_symbol_111);
     tint_symbol_4.blend = float4((tint_symbol_4.color.a).xxxx);
   } else {
     if (!(useBlending())) {
@@ -992,7 +1013,7 @@ float rectangleCoverage(float2 pt, float4 rect) {
   return (wh.x * wh.y);
 }
 
-struct tint_symbol_123 {
+struct tint_symbol_127 {
   noperspective float4 data0 : TEXCOORD0;
   noperspective float4 data1 : TEXCOORD1;
   noperspective float2 uv : TEXCOORD2;
@@ -1000,62 +1021,67 @@ struct tint_symbol_123 {
   nointerpolation uint4 coverage : TEXCOORD4;
   float4 position : SV_Position;
 };
-struct tint_symbol_124 {
+struct tint_symbol_128 {
   float4 color : SV_Target0;
   float4 blend : SV_Target1;
 };
 
 FragOut fragmentMain_inner(VertexOutput tint_symbol_3) {
-  uint tint_symbol_110 = constant_shader();
-  if ((tint_symbol_110 == 4u)) {
+  uint tint_symbol_114 = constant_shader();
+  if ((tint_symbol_114 == 4u)) {
     int2 tex_coord = tint_ftoi_1(tint_symbol_3.position.xy);
-    FragOut tint_symbol_125 = {boundTexture_t.Load(int3(tex_coord, 0)), (1.0f).xxxx};
-    return tint_symbol_125;
+    FragOut tint_symbol_129 = {boundTexture_t.Load(int3(tex_coord, 0)), (1.0f).xxxx};
+    return tint_symbol_129;
   }
   float4 outColor = float4(0.0f, 0.0f, 0.0f, 0.0f);
   float4 outBlend = float4(0.0f, 0.0f, 0.0f, 0.0f);
-  uint tint_symbol_111 = constant_shader();
-  if ((tint_symbol_111 == 2u)) {
-    float tint_symbol_112 = roundedBoxShadow((tint_symbol_3.data0.xy * 0.5f), tint_symbol_3.uv, asfloat(constants[2].y), tint_symbol_3.data1);
-    outColor = (asfloat(constants[8]) * tint_symbol_112);
+  uint tint_symbol_115 = constant_shader();
+  if ((tint_symbol_115 == 2u)) {
+    float tint_symbol_116 = roundedBoxShadow((tint_symbol_3.data0.xy * 0.5f), tint_symbol_3.uv, asfloat(constants[2].y), tint_symbol_3.data1);
+    outColor = (asfloat(constants[8]) * tint_symbol_116);
   } else {
-    uint tint_symbol_114 = constant_shader();
-    bool tint_symbol_113 = (tint_symbol_114 == 3u);
-    if (!(tint_symbol_113)) {
-      uint tint_symbol_115 = constant_shader();
-      tint_symbol_113 = (tint_symbol_115 == 1u);
+    uint tint_symbol_118 = constant_shader();
+    bool tint_symbol_117 = (tint_symbol_118 == 3u);
+    if (!(tint_symbol_117)) {
+      uint tint_symbol_119 = constant_shader();
+      tint_symbol_117 = (tint_symbol_119 == 1u);
     }
-    if (tint_symbol_113) {
+    if (tint_symbol_117) {
       int sprite = tint_ftoi(tint_symbol_3.data0.z);
       uint stride = tint_ftou_1(tint_symbol_3.data0.w);
       int2 tuv = tint_ftoi_1(tint_symbol_3.uv);
       float4 shadeColor = computeShadeColor(tint_symbol_3.canvas_coord);
       if (useBlending()) {
-        float3 tint_symbol_116 = atlasSubpixel(sprite, tuv, stride);
-        float3 rgb = processSubpixelOutput(tint_symbol_116);
+        float3 tint_symbol_120 = atlasSubpixel(sprite, tuv, stride);
+        float3 rgb = processSubpixelOutput(tint_symbol_120);
         outColor = (shadeColor * float4(rgb, 1.0f));
         outBlend = float4((shadeColor.a * rgb), 1.0f);
       } else {
-        uint tint_symbol_117 = constant_shader();
-        if ((tint_symbol_117 == 3u)) {
-          float4 tint_symbol_118 = shadeColor;
-          float4 tint_symbol_119 = atlasRGBA(sprite, tuv, stride);
-          outColor = (tint_symbol_118 * tint_symbol_119);
+        uint tint_symbol_121 = constant_shader();
+        if ((tint_symbol_121 == 3u)) {
+          float4 tint_symbol_122 = shadeColor;
+          float4 tint_symbol_123 = atlasRGBA(sprite, tuv, stride);
+          outColor = (tint_symbol_122 * tint_symbol_123);
         } else {
-          float alpha = atlasAccum(sprite, tuv, stride);
-          outColor = (shadeColor * float4((alpha).xxxx));
+          if (constant_sdf_text()) {
+            float alpha = atlasSdf(sprite, tint_symbol_3.uv, tint_ftoi_1(tint_symbol_3.data0.xy), stride);
+            outColor = (shadeColor * float4((alpha).xxxx));
+          } else {
+            float alpha = atlasAccum(sprite, tuv, stride);
+            outColor = (shadeColor * float4((alpha).xxxx));
+          }
         }
       }
     } else {
-      uint tint_symbol_120 = constant_shader();
-      if ((tint_symbol_120 == 5u)) {
+      uint tint_symbol_124 = constant_shader();
+      if ((tint_symbol_124 == 5u)) {
         uint2 xy = tint_ftou(tint_symbol_3.uv);
         float cov = tint_unpack4x8unorm(tint_symbol_3.coverage[(xy.y & 3u)])[(xy.x & 3u)];
         float4 shadeColor = computeShadeColor(tint_symbol_3.canvas_coord);
         outColor = (shadeColor * float4((cov).xxxx));
       } else {
-        uint tint_symbol_121 = constant_shader();
-        if ((tint_symbol_121 == 0u)) {
+        uint tint_symbol_125 = constant_shader();
+        if ((tint_symbol_125 == 0u)) {
           float4 shadeColor = computeShadeColor(tint_symbol_3.canvas_coord);
           float4 rect = tint_symbol_3.data0;
           float pixelCoverage = rectangleCoverage(tint_symbol_3.canvas_coord, rect);
@@ -1066,14 +1092,14 @@ FragOut fragmentMain_inner(VertexOutput tint_symbol_3) {
       }
     }
   }
-  FragOut tint_symbol_126 = {outColor, outBlend};
-  return postprocessColor(tint_symbol_126, tint_symbol_3.canvas_coord);
+  FragOut tint_symbol_130 = {outColor, outBlend};
+  return postprocessColor(tint_symbol_130, tint_symbol_3.canvas_coord);
 }
 
-tint_symbol_124 fragmentMain(tint_symbol_123 tint_symbol_122) {
-  VertexOutput tint_symbol_127 = {float4(tint_symbol_122.position.xyz, (1.0f / tint_symbol_122.position.w)), tint_symbol_122.data0, tint_symbol_122.data1, tint_symbol_122.uv, tint_symbol_122.canvas_coord, tint_symbol_122.coverage};
-  FragOut inner_result = fragmentMain_inner(tint_symbol_127);
-  tint_symbol_124 wrapper_result = (tint_symbol_124)0;
+tint_symbol_128 fragmentMain(tint_symbol_127 tint_symbol_126) {
+  VertexOutput tint_symbol_131 = {float4(tint_symbol_126.position.xyz, (1.0f / tint_symbol_126.position.w)), tint_symbol_126.data0, tint_symbol_126.data1, tint_symbol_126.uv, tint_symbol_126.canvas_coord, tint_symbol_126.coverage};
+  FragOut inner_result = fragmentMain_inner(tint_symbol_131);
+  tint_symbol_128 wrapper_result = (tint_symbol_128)0;
   wrapper_result.color = inner_result.color;
   wrapper_result.blend = inner_result.blend;
   return wrapper_result;
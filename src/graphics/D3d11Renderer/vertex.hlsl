@@ -23,6 +23,10 @@ int constant_sprite_oversampling() {
   return int(((constants[1].y >> 24u) & 255u));
 }
 
+bool constant_sdf_text() {
+  return (((constants[1].z >> 24u) & 255u) != 0u);
+}
+
 float4 get_data(uint index) {
   return asfloat(data.Load4((16u * (constants[0].x + index))));
 }
@@ -57,11 +61,11 @@ float4 alignRectangle(float4 rect) {
   return float4(floor(rect.xy), ceil(rect.zw));
 }
 
-struct tint_symbol_16 {
+struct tint_symbol_18 {
   uint vidx : SV_VertexID;
   uint inst : SV_InstanceID;
 };
-struct tint_symbol_17 {
+struct tint_symbol_19 {
   noperspective float4 data0 : TEXCOORD0;
   noperspective float4 data1 : TEXCOORD1;
   noperspective float2 uv : TEXCOORD2;
@@ -74,12 +78,12 @@ VertexOutput vertexMain_inner(uint vidx, uint inst) {
   VertexOutput output = (VertexOutput)0;
   uint tint_symbol = constant_shader();
   if ((tint_symbol == 4u)) {
-    float2 tint_symbol_18[4] = {(-0.5f).xx, float2(0.5f, -0.5f), float2(-0.5f, 0.5f), (0.5f).xx};
-    output.position = float4((tint_symbol_18[vidx] * 2.0f), 0.0f, 1.0f);
+    float2 tint_symbol_20[4] = {(-0.5f).xx, float2(0.5f, -0.5f), float2(-0.5f, 0.5f), (0.5f).xx};
+    output.position = float4((tint_symbol_20[vidx] * 2.0f), 0.0f, 1.0f);
     return output;
   }
-  float2 tint_symbol_19[4] = {(-0.5f).xx, float2(0.5f, -0.5f), float2(-0.5f, 0.5f), (0.5f).xx};
-  float2 position = tint_symbol_19[vidx];
+  float2 tint_symbol_21[4] = {(-0.5f).xx, float2(0.5f, -0.5f), float2(-0.5f, 0.5f), (0.5f).xx};
+  float2 position = tint_symbol_21[vidx];
   float2 uv_coord = (position + (0.5f).xx);
   float4 outPosition = (0.0f).xxxx;
   uint tint_symbol_1 = constant_shader();
@@ -104,56 +108,70 @@ VertexOutput vertexMain_inner(uint vidx, uint inst) {
       output.uv = (position * (((m + m) + rect.zw) - rect.xy));
     } else {
       uint tint_symbol_4 = constant_shader();
-      if ((tint_symbol_4 == 1u)) {
+      bool tint_tmp = (tint_symbol_4 == 1u);
+      if (tint_tmp) {
+        tint_tmp = constant_sdf_text();
+      }
+      if ((tint_tmp)) {
         float4 tint_symbol_5 = get_data((inst * 2u));
         float4 rect = norm_rect(tint_symbol_5);
         float4 glyph_data = get_data(((inst * 2u) + 1u));
-        float base = rect.x;
-        rect.x = (rect.x + asfloat(perFrame[1].w));
-        rect.z = (rect.z + asfloat(perFrame[1].w));
-        rect.x = (rect.x - asfloat(perFrame[1].z));
-        rect.z = (rect.z + asfloat(perFrame[1].z));
         outPosition = float4(lerp(rect.xy, rect.zw, uv_coord), 0.0f, 1.0f);
-        float2 tint_symbol_6 = ((outPosition.xy - float2(base, rect.y)) + float2(-(asfloat(perFrame[1].z)), 0.0f));
-        int tint_symbol_7 = constant_sprite_oversampling();
-        float tint_symbol_8 = float(tint_symbol_7);
-        float2 tint_symbol_9 = float2(tint_symbol_8, 1.0f);
-        output.uv = (tint_symbol_6 * tint_symbol_9);
+        output.uv = (uv_coord * glyph_data.xy);
         output.data0 = glyph_data;
       } else {
-        uint tint_symbol_10 = constant_shader();
-        if ((tint_symbol_10 == 3u)) {
-          float4 tint_symbol_11 = get_data((inst * 2u));
-          float4 rect = norm_rect(tint_symbol_11);
+        uint tint_symbol_6 = constant_shader();
+        if ((tint_symbol_6 == 1u)) {
+          float4 tint_symbol_7 = get_data((inst * 2u));
+          float4 rect = norm_rect(tint_symbol_7);
           float4 glyph_data = get_data(((inst * 2u) + 1u));
+          float base = rect.x;
+          rect.x = (rect.x + asfloat(perFrame[1].w));
+          rect.z = (rect.z + asfloat(perFrame[1].w));
+          rect.x = (rect.x - asfloat(perFrame[1].z));
+          rect.z = (rect.z + asfloat(perFrame[1].z));
           outPosition = float4(lerp(rect.xy, rect.zw, uv_coord), 0.0f, 1.0f);
-          output.uv = (outPosition.xy - rect.xy);
+          float2 tint_symbol_8 = ((outPosition.xy - float2(base, rect.y)) + float2(-(asfloat(perFrame[1].z)), 0.0f));
+          int tint_symbol_9 = constant_sprite_oversampling();
+          float tint_symbol_10 = float(tint_symbol_9);
+          float2 tint_symbol_11 = float2(tint_symbol_10, 1.0f);
+          output.uv = (tint_symbol_8 * tint_symbol_11);
           output.data0 = glyph_data;
         } else {
           uint tint_symbol_12 = constant_shader();
-          if ((tint_symbol_12 == 5u)) {
-            uint4 d = data.Load4((16u * (constants[0].x + (inst >> 1u))));
-            uint patchCoord = d[((inst & 1u) << 1u)];
-            uint patchOffset = d[(((inst & 1u) << 1u) + 1u)];
-            output.coverage = data.Load4((16u * ((constants[0].x + ((constants[0].z + 1u) >> 1u)) + patchOffset)));
-            float2 xy = float2(uint2(((patchCoord & 4095u) * 4u), (((patchCoord >> 12u) & 4095u) * 4u)));
-            outPosition = float4(lerp(xy, (xy + float2((4.0f * float((patchCoord >> 24u))), 4.0f)), uv_coord), 0.0f, 1.0f);
-            output.uv = (outPosition.xy - xy);
+          if ((tint_symbol_12 == 3u)) {
+            float4 tint_symbol_13 = get_data((inst * 2u));
+            float4 rect = norm_rect(tint_symbol_13);
+            float4 glyph_data = get_data(((inst * 2u) + 1u));
+            outPosition = float4(lerp(rect.xy, rect.zw, uv_coord), 0.0f, 1.0f);
+            output.uv = (outPosition.xy - rect.xy);
+            output.data0 = glyph_data;
+          } else {
+            uint tint_symbol_14 = constant_shader();
+            if ((tint_symbol_14 == 5u)) {
+              uint4 d = data.Load4((16u * (constants[0].x + (inst >> 1u))));
+              uint patchCoord = d[((inst & 1u) << 1u)];
+              uint patchOffset = d[(((inst & 1u) << 1u) + 1u)];
+              output.coverage = data.Load4((16u * ((constants[0].x + ((constants[0].z + 1u) >> 1u)) + patchOffset)));
+              float2 xy = float2(uint2(((patchCoord & 4095u) * 4u), (((patchCoord >> 12u) & 4095u) * 4u)));
+              outPosition = float4(lerp(xy, (xy + float2((4.0f * float((patchCoord >> 24u))), 4.0f)), uv_coord), 0.0f, 1.0f);
+              output.uv = (outPosition.xy - xy);
+            }
           }
         }
       }
     }
   }
   output.canvas_coord = outPosition.xy;
-  float2 tint_symbol_13 = transform2D(outPosition.xy);
-  float2 tint_symbol_14 = to_screen(tint_symbol_13);
-  output.position = float4(tint_symbol_14, outPosition.zw);
+  float2 tint_symbol_15 = transform2D(outPosition.xy);
+  float2 tint_symbol_16 = to_screen(tint_symbol_15);
+  output.position = float4(tint_symbol_16, outPosition.zw);
   return output;
 }
 
-tint_symbol_17 vertexMain(tint_symbol_16 tint_symbol_15) {
-  VertexOutput inner_result = vertexMain_inner(tint_symbol_15.vidx, tint_symbol_15.inst);
-  tint_symbol_17 wrapper_result = (tint_symbol_17)0;
+tint_symbol_19 vertexMain(tint_symbol_18 tint_symbol_17) {
+  VertexOutput inner_result = vertexMain_inner(tint_symbol_17.vidx, tint_symbol_17.inst);
+  tint_symbol_19 wrapper_result = (tint_symbol_19)0;
   wrapper_result.position = inner_result.position;
   wrapper_result.data0 = inner_result.data0;
   wrapper_result.data1 = inner_result.data1;
@@ -90,10 +90,16 @@ if (BRISK_WEBGPU)
 
 endif ()
 
-brisk_target_link_resource(
-    ${_BRISK_I18N_ICU} PRIVATE "internal/icudt.dat"
-    INPUT ${BRISK_RESOURCES_DIR}/icu/${ICU_DT}
-    BROTLI)
+if (BRISK_ICU_DATA_UNCOMPRESSED)
+    # Used in place, so the OS pages in only the parts of the data that are accessed
+    brisk_target_link_resource(${_BRISK_I18N_ICU} PRIVATE "internal/icudt.dat" INPUT
+                               ${BRISK_RESOURCES_DIR}/icu/${ICU_DT})
+else ()
+    brisk_target_link_resource(
+        ${_BRISK_I18N_ICU} PRIVATE "internal/icudt.dat"
+        INPUT ${BRISK_RESOURCES_DIR}/icu/${ICU_DT}
+        BROTLI)
+endif ()
 
 if (BRISK_D3D11)
     if (_EXPORT_MODE)
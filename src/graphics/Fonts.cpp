@@ -22,6 +22,7 @@
 #include <brisk/graphics/ImageFormats.hpp>
 #include <brisk/graphics/Fonts.hpp>
 #include <map>
+#include <set>
 #include <brisk/core/Log.hpp>
 #include <brisk/core/Time.hpp>
 #include <brisk/core/Utilities.hpp>
@@ -29,12 +30,20 @@
 #include <brisk/core/internal/Fixed.hpp>
 #include <brisk/core/Io.hpp>
 #include <brisk/core/Text.hpp>
+#include <brisk/core/Threading.hpp>
 
 #include <numeric>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <unordered_set>
 #include <utf8proc.h>
 
 #include <harfbuzz/hb.h>
 #include <harfbuzz/hb-ft.h>
+#include <harfbuzz/hb-ot.h>
 
 #include <lunasvg.h>
 
@@ -46,6 +55,7 @@
 #include FT_TRUETYPE_TABLES_H
 #include FT_OTSVG_H
 #include FT_MODULE_H
+#include FT_OUTLINE_H
 
 namespace Brisk {
 
@@ -132,30 +142,276 @@ static GlyphCacheKey glyphCacheKey(float fontSize, uint32_t glyphIndex) {
     return { toFixed6(fontSize), glyphIndex };
 }
 
+// SDF glyphs do not depend on the font size, so they share one key per glyph
+static GlyphCacheKey sdfGlyphCacheKey(uint32_t glyphIndex) {
+    return { -1, glyphIndex };
+}
+
+// Color glyphs are rasterized at whole pixel sizes (multiples of 4 pixels above 32) and scaled when drawn,
+// so that nearby font sizes share sprites
+static float colorGlyphSize(float fontSize) {
+    return fontSize <= 32.f ? std::ceil(fontSize) : std::ceil(fontSize / 4.f) * 4.f;
+}
+
+// Memory budget for cached color glyphs, which are evicted least recently used first
+constexpr size_t colorGlyphCacheBytes = 16 * 1024 * 1024;
+
 const static InclusiveRange<float> nullRange{ HUGE_VALF, -HUGE_VALF };
 
-struct FontFace {
+// On-disk glyph cache: header, entries sorted by key, then glyph bitmaps. The file is mapped and
+// read in place, so all structures are stored in native byte order
+struct GlyphCacheFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numEntries;
+};
+
+struct GlyphCacheFileEntry {
+    uint64_t fontHash;
+    uint32_t variant;
+    FTFixed fontSize;
+    uint32_t glyphIndex;
+    Size size;
+    Size spriteSize;
+    float offsetX;
+    int32_t offsetY;
+    float advanceX;
+    uint64_t dataOffset;
+
+    auto key() const noexcept {
+        return std::tuple{ fontHash, variant, fontSize, glyphIndex };
+    }
+};
+
+constexpr char glyphCacheMagic[8] = { 'B', 'R', 'G', 'L', 'Y', 'P', 'H', 'S' };
+constexpr uint32_t glyphCacheVersion = 2;
+
+// Table directory of an sfnt font: version, table count and the tag, checksum, offset and length of every
+// table. Table checksums cover the table contents, so the directory identifies the font without reading
+// the rest of the file
+static BytesView sfntTableDirectory(BytesView data, uint32_t faceIndex) {
+    auto be32 = [&data](size_t offset) -> uint32_t {
+        const auto* p = reinterpret_cast<const uint8_t*>(data.data()) + offset;
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    };
+    size_t offset = 0;
+    if (data.size() >= 12 && be32(0) == 0x74746366 /* 'ttcf' */) {
+        const uint32_t numFonts = be32(8);
+        if (faceIndex >= numFonts || data.size() < 12 + 4 * size_t(numFonts))
+            return {};
+        offset = be32(12 + 4 * faceIndex);
+    }
+    if (offset > data.size() || data.size() - offset < 12)
+        return {};
+    const size_t size = 12 + 16 * size_t(be32(offset + 4) >> 16);
+    if (data.size() - offset < size)
+        return {};
+    return data.subspan(offset, size);
+}
+
+static std::span<const GlyphCacheFileEntry> glyphCacheEntries(const MappedFile* file) {
+    if (!file)
+        return {};
+    BytesView data = file->data();
+    auto header    = reinterpret_cast<const GlyphCacheFileHeader*>(data.data());
+    return { reinterpret_cast<const GlyphCacheFileEntry*>(data.data() + sizeof(GlyphCacheFileHeader)),
+             header->numEntries };
+}
+
+static std::optional<BytesView> glyphCachePixels(const MappedFile* file, const GlyphCacheFileEntry& entry) {
+    BytesView data = file->data();
+    uint64_t size  = static_cast<uint64_t>(entry.spriteSize.area());
+    if (entry.spriteSize.width < 0 || entry.spriteSize.height < 0 || entry.dataOffset > data.size() ||
+        size > data.size() - entry.dataOffset)
+        return std::nullopt;
+    return data.subspan(entry.dataOffset, size);
+}
+
+static std::optional<GlyphData> findPersistentGlyph(const Rc<MappedFile>& file, uint64_t fontHash,
+                                                    uint32_t variant, GlyphCacheKey key) {
+    std::span<const GlyphCacheFileEntry> entries = glyphCacheEntries(file.get());
+    const auto wanted = std::tuple{ fontHash, variant, key.fontSize, key.glyphIndex };
+    auto it = std::lower_bound(entries.begin(), entries.end(), wanted,
+                               [](const GlyphCacheFileEntry& e, const auto& k) {
+                                   return e.key() < k;
+                               });
+    if (it == entries.end() || it->key() != wanted)
+        return std::nullopt;
+    std::optional<BytesView> pixels = glyphCachePixels(file.get(), *it);
+    if (!pixels)
+        return std::nullopt;
+    GlyphData glyph;
+    glyph.size      = it->size;
+    glyph.offset_x  = it->offsetX;
+    glyph.offset_y  = it->offsetY;
+    glyph.advance_x = it->advanceX;
+#ifdef BRISK_WINDOWS
+    // A live mapping would prevent saveGlyphCache from replacing the file
+    glyph.sprite    = makeSprite(it->spriteSize, *pixels);
+#else
+    // Pixels stay in the mapped file and are copied only once, into the atlas
+    glyph.sprite    = makeSpriteView(it->spriteSize, *pixels, file);
+#endif
+    return glyph;
+}
+
+static constexpr uint8_t operator+(OpenTypeFeature feat) {
+    return static_cast<uint8_t>(feat);
+}
+
+static std::vector<hb_feature_t> shapingFeatures(std::span<const OpenTypeFeatureFlag> requested,
+                                                 FontFlags flags) {
+    std::vector<hb_feature_t> features;
+    bool kernSet = false;
+    for (OpenTypeFeatureFlag feat : requested) {
+        if (feat.feature == OpenTypeFeature::kern) {
+            kernSet = true;
+        }
+        features.push_back(hb_feature_t{
+            openTypeFeatures[+feat.feature],
+            feat.enabled ? 1u : 0u,
+            HB_FEATURE_GLOBAL_START,
+            HB_FEATURE_GLOBAL_END,
+        });
+    }
+    if (!kernSet && (flags && FontFlags::DisableKerning)) {
+        features.push_back(hb_feature_t{
+            openTypeFeatures[+OpenTypeFeature::kern],
+            0u,
+            HB_FEATURE_GLOBAL_START,
+            HB_FEATURE_GLOBAL_END,
+        });
+    }
+    if ((flags && FontFlags::DisableLigatures)) {
+        using enum OpenTypeFeature;
+        for (OpenTypeFeature feature : { liga, clig, dlig }) {
+            features.push_back(hb_feature_t{
+                openTypeFeatures[+feature],
+                0u,
+                HB_FEATURE_GLOBAL_START,
+                HB_FEATURE_GLOBAL_END,
+            });
+        }
+    }
+    return features;
+}
+
+// Shaping results for printable ASCII at one font size, used to lay out simple text without HarfBuzz.
+// Characters and pairs are shaped on first use; a pair that HarfBuzz does not lay out as two independent
+// glyphs (a ligature, mark positioning and so on) is marked complex and sends the text down the full path
+struct AsciiShaping {
+    static constexpr char32_t first   = U' ';
+    static constexpr uint32_t count   = 0x7F - first;
+    static constexpr int16_t unknown  = INT16_MIN;
+    static constexpr int16_t complex  = INT16_MIN + 1;
+    // Font sizes kept per face, fractional sizes from animations and zoom would grow the map otherwise
+    static constexpr size_t maxSizes  = 16;
+
+    std::unique_ptr<hb_buffer_t, hb_buffer_deleter> buffer{ hb_buffer_create() };
+    std::vector<hb_feature_t> features;
+    double time = 0; // Last use, for eviction
+    std::bitset<count> shaped;
+    std::bitset<count> simple;
+    std::array<GlyphId, count> glyphs{};
+    std::array<int32_t, count> advances{}; // 26.6, as reported by HarfBuzz
+    std::array<int16_t, count * count> kerning;
+    std::bitset<count * count> unsafeToBreak;
+
+    AsciiShaping() {
+        kerning.fill(unknown);
+    }
+};
+
+// Color glyphs of all faces, most recently used first, with their total size. Eviction pops from the
+// back instead of walking the caches
+struct ColorGlyphCache {
+    struct Item {
+        FontFace* face;
+        GlyphCacheKey key;
+        size_t bytes;
+    };
+
+    std::list<Item> items;
+    size_t totalBytes = 0;
+};
+
+struct FontFace : public std::enable_shared_from_this<FontFace> {
     FontManager* manager;
     FontFlags flags;
     FT_Face face;
     hb_font_t* hb_font;
     Bytes bytes;
+    Rc<MappedFile> file; // Shared by all faces loaded from the same file
+    BytesView fontData;
+    uint32_t faceIndex = 0;
+    std::optional<uint64_t> fontHash;
 
     bool isSvg() const noexcept {
         return (flags && FontFlags::EnableColor) && FT_HAS_SVG(face);
     }
 
+    // Read without the lock, runs keep the value they were shaped with
+    bool isSdf() const noexcept {
+        return manager->m_sdfSupported &&
+               ((flags && FontFlags::SdfGlyphs) || manager->m_sdfGlyphs.load(std::memory_order_relaxed)) &&
+               !isSvg() && FT_IS_SCALABLE(face);
+    }
+
+    // Identifies the font in the persistent glyph cache. Only the file size and the table directory are
+    // hashed, so mapped font files are not paged in entirely
+    uint64_t contentHash() {
+        if (!fontHash) {
+            // Upper 16 bits of the face index select a named instance of a variable font
+            BytesView directory = sfntTableDirectory(fontData, faceIndex & 0xFFFF);
+            const uint64_t seed = (uint64_t(fontData.size()) << 32) ^ faceIndex;
+            fontHash            = directory.empty() ? fastHash(fontData, seed) : fastHash(directory, seed);
+        }
+        return *fontHash;
+    }
+
+    // Everything besides the font data, size and glyph index that affects the rasterized glyph
+    uint32_t cacheVariant(bool sdf) const noexcept {
+        return static_cast<uint32_t>(flags) | (static_cast<uint32_t>(hscale) << 16) |
+               (static_cast<uint32_t>(sdf) << 24);
+    }
+
     struct GlyphDataAndTime : GlyphData {
         double time;
+        std::optional<std::list<ColorGlyphCache::Item>::iterator> lru; // Color glyphs only
     };
 
+    void trackColorGlyph(const GlyphCacheKey& key, GlyphDataAndTime& glyph) {
+        ColorGlyphCache& colorGlyphs = *manager->m_colorGlyphs;
+        untrackColorGlyph(glyph);
+        const size_t bytes = glyph.sprite ? glyph.sprite->size.area() : 0;
+        colorGlyphs.items.push_front(ColorGlyphCache::Item{ this, key, bytes });
+        colorGlyphs.totalBytes += bytes;
+        glyph.lru = colorGlyphs.items.begin();
+    }
+
+    void untrackColorGlyph(GlyphDataAndTime& glyph) {
+        if (!glyph.lru)
+            return;
+        ColorGlyphCache& colorGlyphs = *manager->m_colorGlyphs;
+        colorGlyphs.totalBytes -= (*glyph.lru)->bytes;
+        colorGlyphs.items.erase(*glyph.lru);
+        glyph.lru.reset();
+    }
+
     struct SizeData {
         FT_Size ftSize;
         FontMetrics metrics;
     };
 
     std::unordered_map<GlyphCacheKey, GlyphDataAndTime, FastHash> cache;
+    // Color glyphs queued for the rasterizer thread
+    std::unordered_set<GlyphCacheKey, FastHash> pendingGlyphs;
+    // Used by the rasterizer thread only, guarded by GlyphRasterizer::ftMutex
+    FT_Face rasterFace = nullptr;
     std::map<uint32_t, SizeData> sizes;
+    // Keyed by font size, shaping flags and whether the text is Latin (see shapeSimpleText)
+    std::map<std::tuple<uint32_t, FontFlags, bool>, std::unique_ptr<AsciiShaping>> asciiShaping;
+    std::optional<bool> contextualSubstitutions;
     FT_Fixed xHeight                     = 0;
     FT_Fixed capHeight                   = 0;
     int hscale                           = 1;
@@ -167,6 +423,7 @@ struct FontFace {
 
     ~FontFace() {
         clearCache();
+        releaseRasterFace();
         if (hb_font)
             hb_font_destroy(hb_font);
         for (auto& s : sizes) {
@@ -175,21 +432,20 @@ struct FontFace {
         HANDLE_FT_ERROR_SOFT(FT_Done_Face(face), return);
     }
 
-    explicit FontFace(FontManager* manager, BytesView data, bool makeCopy, FontFlags flags)
-        : manager(manager), flags(flags) {
+    explicit FontFace(FontManager* manager, BytesView data, bool makeCopy, FontFlags flags,
+                      uint32_t faceIndex = 0)
+        : manager(manager), flags(flags), faceIndex(faceIndex) {
         if (makeCopy) {
             bytes = Bytes(data.begin(), data.end());
             data  = bytes;
         }
+        fontData = data;
         HANDLE_FT_ERROR(FT_New_Memory_Face(static_cast<FT_Library>(manager->m_ft_library),
-                                           (const FT_Byte*)data.data(), data.size(), 0, &face));
+                                           (const FT_Byte*)data.data(), data.size(), faceIndex, &face));
         HANDLE_FT_ERROR(FT_Select_Charmap(face, FT_ENCODING_UNICODE));
 
-        hscale           = isSvg() ? 1 : manager->m_hscale;
-
-        FT_Matrix matrix = { toFixed16(1.0f / HORIZONTAL_OVERSAMPLING * hscale), toFixed16(0), toFixed16(0),
-                             toFixed16(1.0f) };
-        FT_Set_Transform(face, &matrix, NULL);
+        hscale = isSvg() ? 1 : manager->m_hscale;
+        setHorizontalScale(hscale);
         TT_OS2* os2 = (TT_OS2*)FT_Get_Sfnt_Table(face, FT_SFNT_OS2);
         if (os2) {
             if (os2->version >= 2) {
@@ -204,6 +460,12 @@ struct FontFace {
         hb_font = hb_ft_font_create_referenced(face);
     }
 
+    // FreeType reads glyphs directly from the mapping, which is kept alive by the face
+    explicit FontFace(FontManager* manager, Rc<MappedFile> mappedFile, uint32_t faceIndex, FontFlags flags)
+        : FontFace(manager, mappedFile->data(), false, flags, faceIndex) {
+        file = std::move(mappedFile);
+    }
+
     std::string_view familyName() const {
         return face->family_name;
     }
@@ -253,7 +515,106 @@ struct FontFace {
     }
 
     void clearCache() {
+        for (auto& entry : cache) {
+            untrackColorGlyph(entry.second);
+        }
         cache.clear();
+        asciiShaping.clear();
+    }
+
+    // Contextual alternates may depend on more than one neighbouring glyph, which the pairwise
+    // tables of AsciiShaping cannot represent
+    bool hasContextualSubstitutions() {
+        if (!contextualSubstitutions) {
+            contextualSubstitutions = false;
+            hb_face_t* hbFace       = hb_font_get_face(hb_font);
+            std::array<hb_tag_t, 32> tags;
+            unsigned int offset = 0;
+            unsigned int count;
+            do {
+                count = tags.size();
+                hb_ot_layout_table_get_feature_tags(hbFace, HB_OT_TAG_GSUB, offset, &count, tags.data());
+                for (unsigned int i = 0; i < count; ++i) {
+                    if (tags[i] == HB_TAG('c', 'a', 'l', 't') || tags[i] == HB_TAG('r', 'c', 'l', 't'))
+                        contextualSubstitutions = true;
+                }
+                offset += count;
+            } while (count == tags.size());
+        }
+        return *contextualSubstitutions;
+    }
+
+    // Requires the size to be activated by lookupSize
+    std::span<const hb_glyph_info_t> shapeAscii(AsciiShaping& ascii, bool latin, std::u32string_view text) {
+        hb_buffer_t* buffer = ascii.buffer.get();
+        hb_buffer_reset(buffer);
+        hb_buffer_add_codepoints(buffer, (const uint32_t*)text.data(), text.size(), 0, text.size());
+        hb_buffer_set_direction(buffer, HB_DIRECTION_LTR);
+        if (latin)
+            hb_buffer_set_script(buffer, HB_SCRIPT_LATIN);
+        hb_buffer_guess_segment_properties(buffer);
+        hb_shape(hb_font, buffer, ascii.features.data(), ascii.features.size());
+        unsigned int len = hb_buffer_get_length(buffer);
+        return { hb_buffer_get_glyph_infos(buffer, nullptr), len };
+    }
+
+    AsciiShaping& asciiShapingFor(float fontSize, FontFlags shapingFlags, bool latin) {
+        const auto key = std::tuple{ toFixed6(fontSize), shapingFlags, latin };
+        if (!asciiShaping.contains(key) && asciiShaping.size() >= AsciiShaping::maxSizes) {
+            auto lru = std::min_element(asciiShaping.begin(), asciiShaping.end(),
+                                        [](const auto& a, const auto& b) {
+                                            return a.second->time < b.second->time;
+                                        });
+            asciiShaping.erase(lru);
+        }
+        std::unique_ptr<AsciiShaping>& ascii = asciiShaping[key];
+        if (!ascii) {
+            ascii.reset(new AsciiShaping{});
+            ascii->features = shapingFeatures({}, shapingFlags);
+        }
+        ascii->time = currentTime();
+        return *ascii;
+    }
+
+    // Returns true if the character is laid out as a single glyph without offsets.
+    // Requires the size to be activated by lookupSize
+    bool asciiSimple(AsciiShaping& ascii, bool latin, uint32_t index) {
+        if (!ascii.shaped[index]) {
+            ascii.shaped[index]                   = true;
+            char32_t ch                           = AsciiShaping::first + index;
+            std::span<const hb_glyph_info_t> info = shapeAscii(ascii, latin, std::u32string_view(&ch, 1));
+            hb_glyph_position_t* pos              = hb_buffer_get_glyph_positions(ascii.buffer.get(), nullptr);
+            if (info.size() == 1 && info[0].codepoint != 0 && pos[0].x_offset == 0 && pos[0].y_offset == 0) {
+                ascii.simple[index]   = true;
+                ascii.glyphs[index]   = info[0].codepoint;
+                ascii.advances[index] = pos[0].x_advance;
+            }
+        }
+        return ascii.simple[index];
+    }
+
+    // Returns the kerning applied to the first of two simple ASCII glyphs or AsciiShaping::complex.
+    // Requires the size to be activated by lookupSize
+    int16_t asciiPair(AsciiShaping& ascii, bool latin, uint32_t first, uint32_t second) {
+        const uint32_t index = first * AsciiShaping::count + second;
+        int16_t& kerning     = ascii.kerning[index];
+        if (kerning == AsciiShaping::unknown) {
+            kerning = AsciiShaping::complex;
+            char32_t pair[2] = { AsciiShaping::first + first, AsciiShaping::first + second };
+            std::span<const hb_glyph_info_t> info = shapeAscii(ascii, latin, std::u32string_view(pair, 2));
+            hb_glyph_position_t* pos = hb_buffer_get_glyph_positions(ascii.buffer.get(), nullptr);
+            if (info.size() == 2 && info[0].codepoint == ascii.glyphs[first] &&
+                info[1].codepoint == ascii.glyphs[second] && pos[0].x_offset == 0 && pos[0].y_offset == 0 &&
+                pos[1].x_offset == 0 && pos[1].y_offset == 0 && pos[1].x_advance == ascii.advances[second]) {
+                int32_t delta = pos[0].x_advance - ascii.advances[first];
+                if (delta > AsciiShaping::complex && delta <= INT16_MAX) {
+                    kerning = delta;
+                    ascii.unsafeToBreak[index] =
+                        (hb_glyph_info_get_glyph_flags(&info[1]) & HB_GLYPH_FLAG_UNSAFE_TO_BREAK) != 0;
+                }
+            }
+        }
+        return kerning;
     }
 
     GlyphId codepointToGlyph(char32_t codepoint) const {
@@ -261,8 +622,13 @@ struct FontFace {
     }
 
     int garbageCollectCache(double maximumTime) {
+        double time = currentTime();
+        std::erase_if(asciiShaping, [&](const auto& entry) {
+            return time - entry.second->time > maximumTime;
+        });
+        if (isSvg())
+            return 0; // See FontManager::evictColorGlyphs
         int numRemoved = 0;
-        double time    = currentTime();
         for (auto it = cache.begin(); it != cache.end();) {
             if (time - it->second.time > maximumTime) {
                 it = cache.erase(it);
@@ -274,23 +640,8 @@ struct FontFace {
         return numRemoved;
     }
 
-    std::optional<GlyphData> loadGlyphCached(float fontSize, GlyphId glyphIndex) {
-        if (auto it = cache.find(glyphCacheKey(fontSize, glyphIndex)); it != cache.end()) {
-            it->second.time = currentTime();
-            return it->second;
-        } else {
-            std::ignore                   = lookupSize(fontSize);
-            std::optional<GlyphData> data = loadGlyph(glyphIndex);
-            if (!data.has_value())
-                return std::nullopt;
-
-            it              = cache.insert(it, std::pair<Internal::GlyphCacheKey, GlyphDataAndTime>{
-                                      glyphCacheKey(fontSize, glyphIndex),
-                                      GlyphDataAndTime{ static_cast<GlyphData&&>(std::move(*data)), 0.f } });
-            it->second.time = currentTime();
-            return it->second;
-        }
-    }
+    std::optional<GlyphData> loadGlyphCached(float fontSize, GlyphId glyphIndex, bool sdf);
+    void releaseRasterFace();
 
     float getGlyphAdvance(GlyphId glyphIndex) {
         FT_Int32 ftFlags = FT_LOAD_DEFAULT | FT_LOAD_TARGET_LIGHT;
@@ -307,11 +658,17 @@ struct FontFace {
     }
 
     std::optional<GlyphData> loadGlyph(GlyphId glyphIndex) {
+        return loadGlyph(face, glyphIndex);
+    }
+
+    // Rasterizes the glyph with the given FT_Face, which is either `face` or `rasterFace`
+    std::optional<GlyphData> loadGlyph(FT_Face ftFace, GlyphId glyphIndex) {
         FT_Int32 ftFlags;
         if (isSvg()) {
             ftFlags = FT_LOAD_TARGET_LIGHT | FT_LOAD_SVG_ONLY | FT_LOAD_COLOR;
         } else {
-            ftFlags = FT_LOAD_RENDER | FT_LOAD_TARGET_LIGHT;
+            // Outlines are rendered below, straight into the sprite. FreeType presets the bitmap metrics
+            ftFlags = FT_LOAD_TARGET_LIGHT;
         }
         if (flags && FontFlags::DisableHinting) {
             ftFlags |= FT_LOAD_NO_HINTING;
@@ -319,30 +676,59 @@ struct FontFace {
             ftFlags |= FT_LOAD_FORCE_AUTOHINT;
         }
 
-        FT_Error err = FT_Load_Glyph(face, glyphIndex, ftFlags);
+        FT_Error err = FT_Load_Glyph(ftFace, glyphIndex, ftFlags);
         if (err == FT_Err_Invalid_Glyph_Index || err == FT_Err_Invalid_Argument) {
             return std::nullopt;
         }
         HANDLE_FT_ERROR(err);
 
         if (isSvg()) {
-            if (face->glyph->format != FT_GLYPH_FORMAT_SVG) {
+            if (ftFace->glyph->format != FT_GLYPH_FORMAT_SVG) {
                 BRISK_LOG_WARN("Cannot load svg glyph #{} from a SVG font {}", glyphIndex, familyName());
                 return std::nullopt;
             }
-            FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
+            FT_Render_Glyph(ftFace->glyph, FT_RENDER_MODE_NORMAL);
         }
 
-        FT_GlyphSlot slot = face->glyph;
+        FT_GlyphSlot slot = ftFace->glyph;
         if (slot->advance.y != 0)
             return std::nullopt;
 
         GlyphData glyph;
+        glyph.offset_x  = slot->bitmap_left / float(hscale);
+        glyph.offset_y  = slot->bitmap_top;
+        glyph.size.x    = slot->bitmap.width;
+        glyph.size.y    = slot->bitmap.rows;
+        glyph.advance_x = fromFixed6(slot->advance.x) / float(hscale);
+
+        // Overlapping contours need the oversampling that only FT_Render_Glyph applies
+        if (slot->format == FT_GLYPH_FORMAT_OUTLINE && !(slot->outline.flags & FT_OUTLINE_OVERLAP)) {
+            glyph.sprite = makeSprite(glyph.size);
+            if (!glyph.size.empty()) {
+                memset(glyph.sprite->data(), 0, glyph.size.area());
+                FT_Bitmap target{};
+                target.rows       = glyph.size.y;
+                target.width      = glyph.size.x;
+                target.pitch      = glyph.size.x;
+                target.buffer     = reinterpret_cast<unsigned char*>(glyph.sprite->data());
+                target.pixel_mode = FT_PIXEL_MODE_GRAY;
+                target.num_grays  = 256;
+                // Same placement as FreeType's own renderer uses for the preset metrics
+                FT_Outline_Translate(&slot->outline, -slot->bitmap_left * 64,
+                                     (glyph.size.y - slot->bitmap_top) * 64);
+                HANDLE_FT_ERROR(FT_Outline_Get_Bitmap(slot->library, &slot->outline, &target));
+            }
+            return glyph;
+        }
+        if (slot->format != FT_GLYPH_FORMAT_BITMAP) {
+            HANDLE_FT_ERROR(FT_Render_Glyph(slot, FT_RENDER_MODE_LIGHT));
+        }
+
+        unsigned comp  = slot->bitmap.pixel_mode == FT_PIXEL_MODE_BGRA ? 4 : 1;
         glyph.offset_x = slot->bitmap_left / float(hscale);
         glyph.offset_y = slot->bitmap_top;
         glyph.size.x   = slot->bitmap.width;
         glyph.size.y   = slot->bitmap.rows;
-        unsigned comp  = slot->bitmap.pixel_mode == FT_PIXEL_MODE_BGRA ? 4 : 1;
         glyph.sprite   = makeSprite(Size(glyph.size.x * comp, glyph.size.y));
 
         if (!glyph.size.empty()) {
@@ -351,11 +737,70 @@ struct FontFace {
             } else {
                 for (int i = 0; i < glyph.size.y; ++i) {
                     memcpy(glyph.sprite->data() + i * glyph.size.x * comp,
-                           slot->bitmap.buffer + i * slot->bitmap.pitch, glyph.size.x);
+                           slot->bitmap.buffer + i * slot->bitmap.pitch, glyph.size.x * comp);
                 }
             }
         }
-        glyph.advance_x = fromFixed6(slot->advance.x) / float(hscale);
+        return glyph;
+    }
+
+    void setHorizontalScale(int scale) {
+        setHorizontalScale(face, scale);
+    }
+
+    static void setHorizontalScale(FT_Face ftFace, int scale) {
+        FT_Matrix matrix = { toFixed16(1.0f / HORIZONTAL_OVERSAMPLING * scale), toFixed16(0), toFixed16(0),
+                             toFixed16(1.0f) };
+        FT_Set_Transform(ftFace, &matrix, NULL);
+    }
+
+    // Called on the rasterizer thread with GlyphRasterizer::ftMutex locked. FreeType faces are not
+    // thread-safe, so the glyph is rendered by a separate face opened from the same data
+    std::optional<GlyphData> rasterizeGlyph(FT_Library library, GlyphCacheKey key) {
+        if (!rasterFace) {
+            HANDLE_FT_ERROR_SOFT(FT_New_Memory_Face(library, (const FT_Byte*)fontData.data(), fontData.size(),
+                                                    faceIndex, &rasterFace),
+                                 return std::nullopt);
+            setHorizontalScale(rasterFace, hscale);
+        }
+        HANDLE_FT_ERROR_SOFT(FT_Set_Char_Size(rasterFace, key.fontSize, 0, DPI * HORIZONTAL_OVERSAMPLING, DPI),
+                             return std::nullopt);
+        return loadGlyph(rasterFace, key.glyphIndex);
+    }
+
+    // Expects the size to be set to sdfReferenceSize. The distance field is isotropic, so the outline is
+    // loaded without horizontal oversampling and without hinting (hinting is size-specific)
+    std::optional<GlyphData> loadSdfGlyph(GlyphId glyphIndex) {
+        setHorizontalScale(1);
+        FT_Error err = FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT | FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP);
+        setHorizontalScale(hscale);
+        if (err == FT_Err_Invalid_Glyph_Index || err == FT_Err_Invalid_Argument) {
+            return std::nullopt;
+        }
+        HANDLE_FT_ERROR(err);
+
+        FT_GlyphSlot slot = face->glyph;
+        if (slot->advance.y != 0)
+            return std::nullopt;
+
+        GlyphData glyph;
+        glyph.advance_x = fromFixed6(slot->advance.x);
+        if (slot->format == FT_GLYPH_FORMAT_OUTLINE && slot->outline.n_points > 0) {
+            HANDLE_FT_ERROR(FT_Render_Glyph(slot, FT_RENDER_MODE_SDF));
+        }
+        // Includes sdfSpread pixels of padding around the outline
+        glyph.offset_x = slot->bitmap_left;
+        glyph.offset_y = slot->bitmap_top;
+        glyph.size.x   = slot->bitmap.width;
+        glyph.size.y   = slot->bitmap.rows;
+        glyph.sprite   = makeSprite(glyph.size);
+
+        if (!glyph.size.empty()) {
+            for (int i = 0; i < glyph.size.y; ++i) {
+                memcpy(glyph.sprite->data() + i * glyph.size.x, slot->bitmap.buffer + i * slot->bitmap.pitch,
+                       glyph.size.x);
+            }
+        }
         return glyph;
     }
 };
@@ -525,8 +970,174 @@ SVG_RendererHooks svgHooks = {
 };
 } // namespace
 
+namespace Internal {
+
+// Rasterizes color glyphs on a background thread. Uses its own FreeType library, so it never touches the
+// faces used for shaping and rendering on the calling threads
+struct GlyphRasterizer {
+    struct Job {
+        std::shared_ptr<FontFace> face;
+        GlyphCacheKey key;
+        std::optional<GlyphData> glyph;
+    };
+
+    std::mutex mutex; // Guards queue, done and stop
+    std::condition_variable cond;
+    std::deque<Job> queue;
+    std::vector<Job> done;
+    bool stop = false;
+
+    std::mutex ftMutex; // Guards library and FontFace::rasterFace
+    FT_Library library = nullptr;
+    std::thread thread;
+
+    // Drawn while the glyph is being rasterized, keyed by the quantized font size
+    std::unordered_map<FTFixed, GlyphData> placeholders;
+
+    GlyphRasterizer() {
+        HANDLE_FT_ERROR(FT_Init_FreeType(&library));
+        HANDLE_FT_ERROR(FT_Property_Set(library, "ot-svg", "svg-hooks", &svgHooks));
+        thread = std::thread([this]() {
+            setThreadName("GlyphRasterizer");
+            run();
+        });
+    }
+
+    ~GlyphRasterizer() {
+        shutdown();
+        HANDLE_FT_ERROR_SOFT(FT_Done_FreeType(library), return);
+    }
+
+    // Stops the thread and drops pending jobs. Faces released here may call releaseFace
+    void shutdown() {
+        std::deque<Job> dropped;
+        std::vector<Job> droppedDone;
+        {
+            std::lock_guard lk(mutex);
+            stop = true;
+            std::swap(dropped, queue);
+            std::swap(droppedDone, done);
+        }
+        cond.notify_one();
+        if (thread.joinable())
+            thread.join();
+    }
+
+    void enqueue(std::shared_ptr<FontFace> face, GlyphCacheKey key) {
+        {
+            std::lock_guard lk(mutex);
+            queue.push_back(Job{ std::move(face), key, std::nullopt });
+        }
+        cond.notify_one();
+    }
+
+    std::vector<Job> takeDone() {
+        std::lock_guard lk(mutex);
+        return std::exchange(done, {});
+    }
+
+    void releaseFace(FT_Face face) {
+        std::lock_guard lk(ftMutex);
+        HANDLE_FT_ERROR_SOFT(FT_Done_Face(face), return);
+    }
+
+    const GlyphData& placeholder(float fontSize) {
+        auto it = placeholders.find(toFixed6(fontSize));
+        if (it == placeholders.end()) {
+            // A translucent box roughly covering the emoji
+            const int side = std::max(1, static_cast<int>(std::round(fontSize * 0.75f)));
+            GlyphData glyph;
+            glyph.size      = Size(side, side);
+            glyph.offset_x  = fontSize * 0.125f;
+            glyph.offset_y  = side;
+            glyph.advance_x = fontSize;
+            glyph.sprite    = makeSprite(Size(side * 4, side));
+            // Premultiplied BGRA
+            const std::byte pixel[4] = { std::byte{ 0x20 }, std::byte{ 0x20 }, std::byte{ 0x20 },
+                                         std::byte{ 0x40 } };
+            for (int i = 0; i < side * side; ++i) {
+                memcpy(glyph.sprite->data() + i * 4, pixel, 4);
+            }
+            it = placeholders.emplace(toFixed6(fontSize), std::move(glyph)).first;
+        }
+        return it->second;
+    }
+
+private:
+    void run() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock lk(mutex);
+                cond.wait(lk, [this]() {
+                    return stop || !queue.empty();
+                });
+                if (stop)
+                    return;
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            {
+                std::lock_guard lk(ftMutex);
+                BRISK_SUPPRESS_EXCEPTIONS(job.glyph = job.face->rasterizeGlyph(library, job.key));
+            }
+            // The face is released by the thread that takes the job, never here
+            std::lock_guard lk(mutex);
+            done.push_back(std::move(job));
+        }
+    }
+};
+
+void FontFace::releaseRasterFace() {
+    if (rasterFace) {
+        manager->m_rasterizer->releaseFace(rasterFace);
+        rasterFace = nullptr;
+    }
+}
+
+std::optional<GlyphData> FontFace::loadGlyphCached(float fontSize, GlyphId glyphIndex, bool sdf) {
+    const bool color        = isSvg();
+    const float rasterSize  = color ? colorGlyphSize(fontSize) : fontSize;
+    const GlyphCacheKey key = sdf ? sdfGlyphCacheKey(glyphIndex) : glyphCacheKey(rasterSize, glyphIndex);
+    auto it                 = cache.find(key);
+    if (it == cache.end()) {
+        std::optional<GlyphData> data;
+        if (manager->m_glyphCacheFile) {
+            data = findPersistentGlyph(manager->m_glyphCacheFile, contentHash(), cacheVariant(sdf), key);
+        }
+        if (!data.has_value() && color && manager->m_rasterizer) {
+            if (pendingGlyphs.insert(key).second)
+                manager->m_rasterizer->enqueue(shared_from_this(), key);
+            GlyphData placeholder = manager->m_rasterizer->placeholder(rasterSize);
+            placeholder.scale     = fontSize / rasterSize;
+            return placeholder;
+        }
+        if (!data.has_value()) {
+            std::ignore = lookupSize(sdf ? sdfReferenceSize : rasterSize);
+            data        = sdf ? loadSdfGlyph(glyphIndex) : loadGlyph(glyphIndex);
+        }
+        if (!data.has_value())
+            return std::nullopt;
+
+        it = cache.insert(it, std::pair<Internal::GlyphCacheKey, GlyphDataAndTime>{
+                                  key, GlyphDataAndTime{ static_cast<GlyphData&&>(std::move(*data)), 0.f } });
+        if (color)
+            trackColorGlyph(it->first, it->second);
+    } else if (it->second.lru) {
+        std::list<ColorGlyphCache::Item>& items = manager->m_colorGlyphs->items;
+        items.splice(items.begin(), items, *it->second.lru);
+    }
+    it->second.time  = currentTime();
+    GlyphData result = it->second;
+    result.scale     = fontSize / rasterSize;
+    return result;
+}
+
+} // namespace Internal
+
 FontManager::FontManager(std::recursive_mutex* mutex, int hscale, uint32_t cacheTimeMs)
-    : m_lock(mutex), m_hscale(hscale), m_cacheTimeMs(cacheTimeMs) {
+    : m_lock(mutex), m_hscale(hscale), m_cacheTimeMs(cacheTimeMs),
+      m_colorGlyphs(std::make_unique<Internal::ColorGlyphCache>()) {
     HANDLE_FT_ERROR(FT_Init_FreeType(&reinterpret_cast<FT_Library&>(m_ft_library)));
 
     FT_Module mod = FT_Get_Module(reinterpret_cast<FT_Library&>(m_ft_library), "ot-svg");
@@ -536,13 +1147,46 @@ FontManager::FontManager(std::recursive_mutex* mutex, int hscale, uint32_t cache
 
     HANDLE_FT_ERROR(
         FT_Property_Set(reinterpret_cast<FT_Library&>(m_ft_library), "ot-svg", "svg-hooks", &svgHooks));
+
+    // The sdf module is optional in FreeType builds; without it SDF glyphs are silently disabled
+    FT_Int spread  = Internal::sdfSpread;
+    m_sdfSupported = FT_Property_Set(reinterpret_cast<FT_Library&>(m_ft_library), "sdf", "spread",
+                                     &spread) == FT_Err_Ok;
+}
+
+void FontManager::setSdfGlyphs(bool enable) {
+    m_sdfGlyphs = enable;
+}
+
+bool FontManager::sdfGlyphs() const {
+    return m_sdfGlyphs;
 }
 
 FontManager::~FontManager() {
+    if (m_rasterizer)
+        m_rasterizer->shutdown();
+    m_fontChains.clear();
     m_fonts.clear(); // Free FT_Face’s before calling FT_Done_FreeType
+    m_rasterizer.reset();
     HANDLE_FT_ERROR(FT_Done_FreeType(static_cast<FT_Library>(m_ft_library)));
 }
 
+void FontManager::setAsyncColorGlyphs(bool enable) {
+    lock_quard_cond lk(m_lock);
+    if (enable == (m_rasterizer != nullptr))
+        return;
+    if (enable) {
+        m_rasterizer = std::make_unique<Internal::GlyphRasterizer>();
+    } else {
+        m_rasterizer->shutdown();
+        for (auto& ff : m_fonts) {
+            ff.second->pendingGlyphs.clear();
+            ff.second->releaseRasterFace();
+        }
+        m_rasterizer.reset();
+    }
+}
+
 std::vector<std::string_view> FontManager::fontList(std::string_view ff) const {
     std::vector<std::string_view> list = split(ff, ',');
     for (std::string_view& sv : list) {
@@ -567,34 +1211,68 @@ FontFace* FontManager::findFontByKey(FontKey fontKey) const {
     return nullptr;
 }
 
-std::pair<FontFace*, GlyphId> FontManager::lookupCodepoint(const Font& font, char32_t codepoint,
+FontManager::FontChain& FontManager::fontChain(const Font& font) const {
+    auto it = m_fontChains.find(std::tuple<std::string_view, FontStyle, FontWeight>{
+        font.fontFamily, font.style, font.weight });
+    if (it != m_fontChains.end())
+        return it->second;
+
+    FontChain chain;
+    auto list = fontList(font.fontFamily);
+    for (size_t i = 0; i < list.size() && chain.faces.size() < CodepointBlock::noFace; ++i) {
+        chain.faces.push_back(
+            list[i].empty() ? nullptr : findFontByKey(FontKey{ list[i], font.style, font.weight }));
+    }
+    chain.primary = chain.faces.empty() ? nullptr : chain.faces.front();
+    return m_fontChains.emplace(FontKey{ font.fontFamily, font.style, font.weight }, std::move(chain))
+        .first->second;
+}
+
+void FontManager::invalidateFontChains() {
+    m_fontChains.clear();
+    m_measureCache.clear();
+}
+
+std::pair<FontFace*, GlyphId> FontManager::lookupCodepoint(FontChain& chain, char32_t codepoint,
                                                            bool fallbackToUndef) const {
     if (codepoint < U' ')
         return { nullptr, UINT32_MAX };
-    auto list = fontList(font.fontFamily);
-    for (int offset = 0; offset < list.size(); ++offset) {
-        if (list[offset].empty())
-            continue;
-        FontFace* face = findFontByKey(FontKey{ list[offset], font.style, font.weight });
-        if (face) {
-            GlyphId id = FT_Get_Char_Index(face->face, (FT_ULong)(codepoint));
-            if (id != 0)
-                return { face, id };
-        }
-    }
-    if (fallbackToUndef) {
-        FontFace* face = findFontByKey(FontKey{ list[0], font.style, font.weight });
-        if (face) {
-            return { face, 0 };
+    std::unique_ptr<CodepointBlock>& block = chain.blocks[codepoint >> 8];
+    if (!block)
+        block.reset(new CodepointBlock{});
+    const uint32_t index = codepoint & 0xFF;
+    if (!block->resolved[index]) {
+        block->faceIndex[index] = CodepointBlock::noFace;
+        block->glyph[index]     = UINT32_MAX;
+        for (size_t i = 0; i < chain.faces.size(); ++i) {
+            FontFace* face = chain.faces[i];
+            if (face) {
+                GlyphId id = FT_Get_Char_Index(face->face, (FT_ULong)(codepoint));
+                if (id != 0) {
+                    block->faceIndex[index] = i;
+                    block->glyph[index]     = id;
+                    break;
+                }
+            }
         }
+        block->resolved[index] = true;
     }
+    if (block->faceIndex[index] != CodepointBlock::noFace)
+        return { chain.faces[block->faceIndex[index]], block->glyph[index] };
 
+    if (fallbackToUndef && chain.primary) {
+        return { chain.primary, 0 };
+    }
     return { nullptr, UINT32_MAX };
 }
 
+std::pair<FontFace*, GlyphId> FontManager::lookupCodepoint(const Font& font, char32_t codepoint,
+                                                           bool fallbackToUndef) const {
+    return lookupCodepoint(fontChain(font), codepoint, fallbackToUndef);
+}
+
 Internal::FontFace* FontManager::lookup(const Font& font) const {
-    auto list = fontList(font.fontFamily);
-    return findFontByKey(FontKey{ list[0], font.style, font.weight });
+    return fontChain(font).primary;
 }
 
 FontManager::FontKey FontManager::faceToKey(Internal::FontFace* face) const {
@@ -619,29 +1297,51 @@ void FontManager::addFontAlias(std::string_view newFontFamily, std::string_view
     for (auto& f : aliasesToAdd) {
         m_fonts.insert_or_assign(std::move(f.first), std::move(f.second));
     }
+    invalidateFontChains();
 }
 
 void FontManager::addFont(std::string fontFamily, FontStyle style, FontWeight weight, BytesView data,
                           bool makeCopy, FontFlags flags) {
     lock_quard_cond lk(m_lock);
+    addFontFace(std::move(fontFamily), style, weight, rcnew FontFace(this, data, makeCopy, flags));
+}
+
+void FontManager::addFontFace(std::string fontFamily, FontStyle style, FontWeight weight,
+                              Rc<Internal::FontFace> fontFace) {
     FontKey key{ std::move(fontFamily), style, weight };
-    auto fontFace = rcnew FontFace(this, data, makeCopy, flags);
     m_fonts.insert_or_assign(key, fontFace);
     if (fontFace->familyName() != std::get<0>(key)) {
         // Register alias with real font name
         m_fonts.insert_or_assign(FontKey{ fontFace->familyName(), style, weight }, std::move(fontFace));
     }
+    invalidateFontChains();
 }
 
 status<IoError> FontManager::addFontFromFile(std::string fontFamily, FontStyle style, FontWeight weight,
-                                             const fs::path& path) {
+                                             const fs::path& path, uint32_t faceIndex) {
     lock_quard_cond lk(m_lock);
-    expected<Bytes, IoError> b = readBytes(path);
-    if (b) {
-        addFont(std::move(fontFamily), style, weight, *b);
-        return {};
-    }
-    return unexpected(b.error());
+    std::error_code ec;
+    fs::path key = fs::weakly_canonical(path, ec);
+    if (ec)
+        key = path;
+    // Faces from the same file (styles registered under several families, TrueType collections)
+    // share one mapping. Files whose faces have all been replaced are forgotten here
+    std::erase_if(m_mappedFiles, [](const auto& entry) {
+        return entry.second.expired();
+    });
+    Rc<MappedFile> mapping;
+    if (auto it = m_mappedFiles.find(key); it != m_mappedFiles.end())
+        mapping = it->second.lock();
+    if (!mapping) {
+        expected<Rc<MappedFile>, IoError> mapped = mapFile(path);
+        if (!mapped)
+            return unexpected(mapped.error());
+        mapping            = std::move(*mapped);
+        m_mappedFiles[key] = mapping;
+    }
+    addFontFace(std::move(fontFamily), style, weight,
+                rcnew FontFace(this, mapping, faceIndex, FontFlags::Default));
+    return {};
 }
 
 static bool cmpi(std::string_view a, std::string_view b) {
@@ -706,24 +1406,157 @@ static std::optional<OsFont> fontQuickInfo(FT_Library library, const fs::path& p
     return font;
 }
 
+namespace {
+// Entry of the installed font index, see installedFonts
+struct FontIndexEntry {
+    std::string path;
+    int64_t modified = 0;
+    uint64_t size    = 0;
+    bool valid       = false; // Files that are not fonts are remembered too
+    std::string family;
+    FontStyle style  = FontStyle::Normal;
+    FontWeight weight = FontWeight::Regular;
+    std::string styleName;
+
+    constexpr static std::tuple reflection{
+        ReflectionField{ "path", &FontIndexEntry::path },
+        ReflectionField{ "modified", &FontIndexEntry::modified },
+        ReflectionField{ "size", &FontIndexEntry::size },
+        ReflectionField{ "valid", &FontIndexEntry::valid },
+        ReflectionField{ "family", &FontIndexEntry::family },
+        ReflectionField{ "style", &FontIndexEntry::style },
+        ReflectionField{ "weight", &FontIndexEntry::weight },
+        ReflectionField{ "styleName", &FontIndexEntry::styleName },
+    };
+};
+
+constexpr int fontIndexVersion = 1;
+} // namespace
+
+static std::vector<FontIndexEntry> readFontIndex(const fs::path& path) {
+    expected<Json, IoError> json = readJson(path);
+    if (!json || json->getItem<int>("version").value_or(0) != fontIndexVersion)
+        return {};
+    return json->getItem<std::vector<FontIndexEntry>>("fonts").value_or(std::vector<FontIndexEntry>{});
+}
+
+static void writeFontIndex(const fs::path& path, const std::vector<FontIndexEntry>& entries) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    Json json = JsonObject{};
+    json.setItem("version", fontIndexVersion);
+    json.setItem("fonts", entries);
+    if (!writeJson(path, json)) {
+        BRISK_LOG_WARN("Unable to write font index to {}", path.string());
+    }
+}
+
+// Reads family and style of the given fonts in the thread pool, the calling thread takes part as well.
+// FreeType libraries cannot be shared between threads, so each worker opens its own
+static void scanFontFiles(std::span<FontIndexEntry*> entries) {
+    if (entries.empty())
+        return;
+    // Tasks that start after the scan has finished must not touch the entries, they only see the counters
+    struct ScanState {
+        std::span<FontIndexEntry*> entries;
+        std::atomic_size_t next{ 0 };
+        std::atomic_size_t done{ 0 };
+    };
+    Rc<ScanState> state = rcnew ScanState{ entries };
+    auto worker         = [state]() {
+        if (state->next >= state->entries.size())
+            return;
+        FT_Library library;
+        if (FT_Init_FreeType(&library) != FT_Err_Ok)
+            return;
+        SCOPE_EXIT {
+            FT_Done_FreeType(library);
+        };
+        for (size_t i = state->next++; i < state->entries.size(); i = state->next++) {
+            FontIndexEntry& entry = *state->entries[i];
+            if (std::optional<OsFont> font = fontQuickInfo(library, fs::path(entry.path))) {
+                entry.valid     = true;
+                entry.family    = std::move(font->family);
+                entry.style     = font->style;
+                entry.weight    = font->weight;
+                entry.styleName = std::move(font->styleName);
+            }
+            if (++state->done == state->entries.size())
+                state->done.notify_all();
+        }
+    };
+    const size_t numTasks =
+        std::clamp<size_t>(std::thread::hardware_concurrency(), 1, (entries.size() + 7) / 8);
+    for (size_t i = 1; i < numTasks; ++i) {
+        async(worker);
+    }
+    worker();
+    for (size_t done = state->done; done < entries.size(); done = state->done) {
+        state->done.wait(done);
+    }
+}
+
+fs::path FontManager::defaultFontIndexPath() {
+    return defaultFolder(DefaultFolder::AppCache) / "fonts.json";
+}
+
 std::vector<OsFont> FontManager::installedFonts(bool rescan) const {
     lock_quard_cond lk(m_lock);
     if (m_osFonts.empty() || rescan) {
-        m_osFonts.clear();
+        // Resolved here rather than in the constructor, which runs before the application metadata is set
+        if (!m_fontIndexPath)
+            m_fontIndexPath = defaultFontIndexPath();
+        std::map<std::string, FontIndexEntry> cached;
+        for (FontIndexEntry& entry : m_fontIndexPath->empty() ? std::vector<FontIndexEntry>{}
+                                                              : readFontIndex(*m_fontIndexPath)) {
+            std::string path = entry.path;
+            cached.insert_or_assign(std::move(path), std::move(entry));
+        }
+
+        std::vector<FontIndexEntry> entries;
         for (fs::path path : fontFolders()) {
-            for (auto f : fs::directory_iterator(path)) {
-                if (f.is_regular_file() && isFontExt(f.path().extension().string())) {
-                    if (std::optional<OsFont> fontInfo =
-                            fontQuickInfo(static_cast<FT_Library>(m_ft_library), f.path())) {
-                        m_osFonts.push_back(std::move(*fontInfo));
-                    }
-                }
+            std::error_code ec;
+            for (const fs::directory_entry& f : fs::directory_iterator(path, ec)) {
+                if (!f.is_regular_file(ec) || !isFontExt(f.path().extension().string()))
+                    continue;
+                FontIndexEntry entry;
+                entry.path     = f.path().string();
+                entry.size     = f.file_size(ec);
+                entry.modified = f.last_write_time(ec).time_since_epoch().count();
+                entries.push_back(std::move(entry));
+            }
+        }
+
+        std::vector<FontIndexEntry*> changed;
+        for (FontIndexEntry& entry : entries) {
+            auto it = cached.find(entry.path);
+            if (it != cached.end() && it->second.size == entry.size && it->second.modified == entry.modified) {
+                entry = std::move(it->second);
+            } else {
+                changed.push_back(&entry);
+            }
+        }
+        scanFontFiles(changed);
+        if (!m_fontIndexPath->empty() && (!changed.empty() || cached.size() != entries.size())) {
+            writeFontIndex(*m_fontIndexPath, entries);
+        }
+
+        m_osFonts.clear();
+        for (const FontIndexEntry& entry : entries) {
+            if (entry.valid) {
+                m_osFonts.push_back(OsFont{ entry.family, entry.style, entry.weight, entry.styleName,
+                                            fs::path(entry.path) });
             }
         }
     }
     return m_osFonts;
 }
 
+void FontManager::setFontIndexPath(fs::path path) {
+    lock_quard_cond lk(m_lock);
+    m_fontIndexPath = std::move(path);
+}
+
 bool FontManager::addSystemFont(std::string fontFamily) {
     lock_quard_cond lk(m_lock);
     fs::path path = fontFolders().front();
@@ -876,15 +1709,15 @@ std::vector<TextRun> FontManager::assignFontsToTextRuns(std::u32string_view text
         if (t.end == t.begin)
             continue;
 
-        const Font& font                  = fonts[t.fontIndex].font;
+        FontChain& chain                  = fontChain(fonts[t.fontIndex].font);
 
-        Internal::FontFace* face          = lookupCodepoint(font, text[t.begin], true).first;
+        Internal::FontFace* face          = lookupCodepoint(chain, text[t.begin], true).first;
         uint32_t start                    = t.begin;
         std::vector<TextRun>::iterator it = newTextRuns.end();
 
         for (uint32_t i = t.begin + 1; i < t.end; ++i) {
             char32_t codepoint          = text[i];
-            Internal::FontFace* newFace = lookupCodepoint(font, codepoint, true).first;
+            Internal::FontFace* newFace = lookupCodepoint(chain, codepoint, true).first;
             if (newFace != face) {
                 // TODO: correct t.visualOrder
                 it = newTextRuns.insert(it,
@@ -917,10 +1750,6 @@ static void fixCaret(GlyphList::iterator first, GlyphList::iterator last) {
     }
 }
 
-static constexpr uint8_t operator+(OpenTypeFeature feat) {
-    return static_cast<uint8_t>(feat);
-}
-
 static bool isPrintable(char32_t ch) {
     switch (utf8proc_category(ch)) {
     case UTF8PROC_CATEGORY_ZS:
@@ -947,6 +1776,272 @@ static AscenderDescender spanAscDesc(std::span<const GlyphRun> runs) {
     return result;
 }
 
+static FontFlags shapingFlags(const Font& font, const FontFace* face) {
+    FontFlags flags = face->flags;
+    if (font.letterSpacing > 0) {
+        flags |= FontFlags::DisableLigatures;
+    }
+    return flags;
+}
+
+static GlyphRun newGlyphRun(const FontAndColor& fontAndColor, const TextRun& t, FontMetrics metrics) {
+    const Font& font = fontAndColor.font;
+    GlyphRun run;
+    run.face          = t.face;
+    run.sdf           = t.face && t.face->isSdf();
+    run.fontSize      = font.fontSize;
+    run.tabWidth      = font.tabWidth;
+    run.lineHeight    = font.lineHeight;
+    run.visualOrder   = t.visualOrder;
+    run.decoration    = font.textDecoration;
+    run.direction     = t.direction;
+    run.verticalAlign = font.verticalAlign;
+    run.metrics       = metrics;
+    run.color         = fontAndColor.color;
+    return run;
+}
+
+namespace {
+// Line breaking classes of UAX #14 that occur in printable ASCII
+enum class AsciiBreakClass : uint8_t { AL, NU, SP, OP, CL, CP, QU, EX, IS, SY, HY, BA, PR, PO };
+
+AsciiBreakClass asciiBreakClass(char32_t ch) {
+    using enum AsciiBreakClass;
+    if (ch >= U'0' && ch <= U'9')
+        return NU;
+    switch (ch) {
+    case U' ':
+        return SP;
+    case U'(':
+    case U'[':
+    case U'{':
+        return OP;
+    case U']':
+    case U'}':
+        return CL;
+    case U')':
+        return CP;
+    case U'"':
+    case U'\'':
+        return QU;
+    case U'!':
+    case U'?':
+        return EX;
+    case U',':
+    case U'.':
+    case U':':
+    case U';':
+        return IS;
+    case U'/':
+        return SY;
+    case U'-':
+        return HY;
+    case U'|':
+        return BA;
+    case U'$':
+    case U'+':
+    case U'\\':
+        return PR;
+    case U'%':
+        return PO;
+    default:
+        return AL;
+    }
+}
+} // namespace
+
+// Line break opportunity before text[i] following the rules of UAX #14 that apply to printable ASCII
+static bool isAsciiLineBreak(std::u32string_view text, uint32_t i) {
+    using enum AsciiBreakClass;
+    if (i == 0)
+        return true;
+    AsciiBreakClass cur  = asciiBreakClass(text[i]);
+    AsciiBreakClass prev = asciiBreakClass(text[i - 1]);
+    // LB7, LB13
+    if (cur == SP || cur == CL || cur == CP || cur == EX || cur == IS || cur == SY)
+        return false;
+    uint32_t j = i - 1;
+    while (j > 0 && text[j] == U' ')
+        --j;
+    AsciiBreakClass beforeSpaces = asciiBreakClass(text[j]);
+    // LB14
+    if (beforeSpaces == OP)
+        return false;
+    // LB18
+    if (prev == SP)
+        return true;
+    // LB19
+    if (cur == QU || prev == QU)
+        return false;
+    // LB20.1: a hyphen starting a word
+    if (prev == HY && cur == AL && (i == 1 || text[i - 2] == U' '))
+        return false;
+    // LB21
+    if (cur == BA || cur == HY)
+        return false;
+    // LB23, LB24, LB25, LB28, LB29, LB30
+    switch (cur) {
+    case AL:
+        return !(prev == AL || prev == NU || prev == PR || prev == PO || prev == IS || prev == CP);
+    case NU:
+        return !(prev == AL || prev == NU || prev == PR || prev == PO || prev == HY || prev == IS ||
+                 prev == SY || prev == CP);
+    case OP:
+        if (prev == PR || prev == PO)
+            return !(i + 1 < text.size() && asciiBreakClass(text[i + 1]) == NU);
+        return !(prev == AL || prev == NU);
+    case PR:
+    case PO:
+        if (prev == CL || prev == CP)
+            return !(i >= 2 && asciiBreakClass(text[i - 2]) == NU);
+        return !(prev == AL || prev == NU);
+    default:
+        // LB31
+        return true;
+    }
+}
+
+// Returns the face that covers every character of single-font LTR printable ASCII text, or nullptr if
+// the text needs ICU and HarfBuzz. Sets `latin` if the text contains Latin letters
+FontFace* FontManager::simpleTextFace(const TextWithOptions& text, const Font& font, bool& latin) const {
+    if (text.text.empty() || text.defaultDirection != TextDirection::LTR || !font.features.empty())
+        return nullptr;
+    latin = false;
+    for (char32_t ch : text.text) {
+        if (ch < AsciiShaping::first || ch >= AsciiShaping::first + AsciiShaping::count)
+            return nullptr;
+        latin |= (ch | 0x20) >= U'a' && (ch | 0x20) <= U'z';
+    }
+
+    FontChain& chain = fontChain(font);
+    FontFace* face   = lookupCodepoint(chain, text.text.front(), false).first;
+    if (!face || face->hasContextualSubstitutions())
+        return nullptr;
+    for (char32_t ch : text.text) {
+        if (lookupCodepoint(chain, ch, false).first != face)
+            return nullptr;
+    }
+    return face;
+}
+
+// Positions simple text using the cached advances and kerning of `face`, calling
+// fn(index, glyph, leftCaret, rightCaret, breakAllowed) for each character.
+// Returns false if any character or pair needs full shaping
+template <typename Fn>
+static bool layoutAsciiText(FontFace* face, bool latin, const Font& font, std::u32string_view text, Fn&& fn) {
+    std::ignore         = face->lookupSize(font.fontSize);
+    AsciiShaping& ascii = face->asciiShapingFor(font.fontSize, shapingFlags(font, face), latin);
+    for (char32_t ch : text) {
+        if (!face->asciiSimple(ascii, latin, ch - AsciiShaping::first))
+            return false;
+    }
+
+    float caret = 0.f;
+    for (uint32_t i = 0; i < text.size(); ++i) {
+        const uint32_t index = text[i] - AsciiShaping::first;
+        int32_t advance      = ascii.advances[index];
+        if (i + 1 < text.size()) {
+            int16_t kerning = face->asciiPair(ascii, latin, index, text[i + 1] - AsciiShaping::first);
+            if (kerning == AsciiShaping::complex)
+                return false;
+            advance += kerning;
+        }
+        bool breakAllowed =
+            i == 0 || !ascii.unsafeToBreak[(text[i - 1] - AsciiShaping::first) * AsciiShaping::count + index];
+        if (i != 0 && breakAllowed) {
+            caret += font.letterSpacing;
+            if (text[i] == U' ') {
+                caret += font.wordSpacing;
+            }
+        }
+        float left = caret;
+        caret += fromFixed6(advance) / HORIZONTAL_OVERSAMPLING;
+        fn(i, ascii.glyphs[index], left, caret, breakAllowed);
+    }
+    return true;
+}
+
+// Lays out single-font LTR printable ASCII without ICU or HarfBuzz, using cached advances and kerning.
+// Returns nullopt if the text or the font does not qualify
+std::optional<PreparedText> FontManager::shapeSimpleText(const TextWithOptions& text,
+                                                         const FontAndColor& fontAndColor) const {
+    const Font& font = fontAndColor.font;
+    bool latin;
+    FontFace* face = simpleTextFace(text, font, latin);
+    if (!face)
+        return std::nullopt;
+
+    const uint32_t length = text.text.size();
+    const bool lineBreaks = !(text.options && TextOptions::SingleLine);
+    PreparedText shaped;
+    shaped.options = text.options;
+    shaped.graphemeBoundaries.resize(length + 1);
+    std::iota(shaped.graphemeBoundaries.begin(), shaped.graphemeBoundaries.end(), 0u);
+
+    GlyphRun run = newGlyphRun(fontAndColor, TextRun{ TextDirection::LTR, 0, length, 0, 0, face }, getMetrics(font));
+    run.glyphs.reserve(length);
+    bool simple = layoutAsciiText(
+        face, latin, font, text.text,
+        [&](uint32_t i, GlyphId glyph, float leftCaret, float rightCaret, bool breakAllowed) {
+            Glyph g;
+            g.glyph     = glyph;
+            g.codepoint = text.text[i];
+            toggle(g.flags, GlyphFlags::IsPrintable, isPrintable(g.codepoint));
+            g.pos         = PointF{ leftCaret, 0.f };
+            g.left_caret  = leftCaret;
+            g.right_caret = rightCaret;
+            g.begin_char  = i;
+            g.end_char    = i + 1;
+            g.dir         = TextDirection::LTR;
+            toggle(g.flags, GlyphFlags::SafeToBreak, breakAllowed);
+            toggle(g.flags, GlyphFlags::AtLineBreak, lineBreaks && isAsciiLineBreak(text.text, i));
+            run.glyphs.push_back(std::move(g));
+        });
+    if (!simple)
+        return std::nullopt;
+    shaped.runs.push_back(std::move(run));
+    shaped.visualOrder.push_back(0);
+    shaped.lines.push_back(PreparedText::GlyphLine{
+        Range{ 0u, 1u },
+        Range{ 0u, uint32_t(shaped.graphemeBoundaries.size()) },
+        spanAscDesc(shaped.runs),
+        0.f,
+    });
+    return shaped;
+}
+
+// Measures what shapeSimpleText would lay out without building glyphs
+std::optional<FontManager::TextExtents> FontManager::measureSimpleText(const TextWithOptions& text,
+                                                                       const Font& font) const {
+    bool latin;
+    FontFace* face = simpleTextFace(text, font, latin);
+    if (!face)
+        return std::nullopt;
+
+    InclusiveRange<float> textRange      = nullRange;
+    InclusiveRange<float> printableRange = nullRange;
+    bool simple                          = layoutAsciiText(
+        face, latin, font, text.text,
+        [&](uint32_t i, GlyphId, float leftCaret, float rightCaret, bool) {
+            InclusiveRange<float> h{ leftCaret, rightCaret };
+            textRange = textRange.union_(h);
+            if (isPrintable(text.text[i])) {
+                printableRange = printableRange.union_(h);
+            }
+        });
+    if (!simple)
+        return std::nullopt;
+    if (printableRange == nullRange)
+        printableRange = { 0.f, 0.f };
+
+    const AscenderDescender ascDesc = calcAscDesc(font.lineHeight, getMetrics(font));
+    TextExtents result;
+    result.text      = RectangleF{ textRange.min, -ascDesc.ascender, textRange.max, ascDesc.descender };
+    result.alignment = result.text;
+    result.printable = RectangleF{ printableRange.min, -ascDesc.ascender, printableRange.max, ascDesc.descender };
+    return result;
+}
+
 PreparedText FontManager::shapeRuns(const TextWithOptions& text, std::span<const FontAndColor> fonts,
                                     std::span<const uint32_t> offsets,
                                     const std::vector<TextRun>& textRuns) const {
@@ -964,17 +2059,7 @@ PreparedText FontManager::shapeRuns(const TextWithOptions& text, std::span<const
         const Font& font = fonts[t.fontIndex].font;
 
         PointF caret{ 0.f, 0.f };
-        GlyphRun run;
-        run.face          = t.face;
-        run.fontSize      = font.fontSize;
-        run.tabWidth      = font.tabWidth;
-        run.lineHeight    = font.lineHeight;
-        run.visualOrder   = t.visualOrder;
-        run.decoration    = font.textDecoration;
-        run.direction     = t.direction;
-        run.verticalAlign = font.verticalAlign;
-        run.metrics       = getMetrics(font);
-        run.color         = fonts[t.fontIndex].color;
+        GlyphRun run     = newGlyphRun(fonts[t.fontIndex], t, getMetrics(font));
 
         if (isControlCode(text.text[t.begin])) {
             for (int32_t i = t.begin; i < t.end; ++i) {
@@ -1003,44 +2088,9 @@ PreparedText FontManager::shapeRuns(const TextWithOptions& text, std::span<const
                                 t.direction == TextDirection::LTR ? HB_DIRECTION_LTR : HB_DIRECTION_RTL);
         hb_buffer_guess_segment_properties(hb_buffer.get());
 
-        std::vector<hb_feature_t> features;
-        bool kernSet = false;
-        for (OpenTypeFeatureFlag feat : font.features) {
-            if (feat.feature == OpenTypeFeature::kern) {
-                kernSet = true;
-            }
-            features.push_back(hb_feature_t{
-                openTypeFeatures[+feat.feature],
-                feat.enabled ? 1u : 0u,
-                HB_FEATURE_GLOBAL_START,
-                HB_FEATURE_GLOBAL_END,
-            });
-        }
-        FontFlags flags = t.face->flags;
-        if (font.letterSpacing > 0) {
-            flags |= FontFlags::DisableLigatures;
-        }
-        if (!kernSet && (flags && FontFlags::DisableKerning)) {
-            features.push_back(hb_feature_t{
-                openTypeFeatures[+OpenTypeFeature::kern],
-                0u,
-                HB_FEATURE_GLOBAL_START,
-                HB_FEATURE_GLOBAL_END,
-            });
-        }
-        if ((flags && FontFlags::DisableLigatures)) {
-            using enum OpenTypeFeature;
-            for (OpenTypeFeature feature : { liga, clig, dlig }) {
-                features.push_back(hb_feature_t{
-                    openTypeFeatures[+feature],
-                    0u,
-                    HB_FEATURE_GLOBAL_START,
-                    HB_FEATURE_GLOBAL_END,
-                });
-            }
-        }
+        std::vector<hb_feature_t> features = shapingFeatures(font.features, shapingFlags(font, t.face));
 
-        std::ignore = t.face->lookupSize(font.fontSize);
+        std::ignore                        = t.face->lookupSize(font.fontSize);
 
         hb_shape(t.face->hb_font, hb_buffer.get(), features.data(), features.size());
 
@@ -1146,15 +2196,38 @@ PreparedText FontManager::prepare(const Font& font, const TextWithOptions& text,
     }
 }
 
+const size_t measureCacheSizeLow  = 1800;
+const size_t measureCacheSizeHigh = 2000;
+
 RectangleF FontManager::bounds(const Font& font, const TextWithOptions& text,
                                GlyphRunBounds boundsType) const {
+    lock_quard_cond lk(m_lock);
+    Internal::ShapingCacheKey key{ font, text };
+    ++m_measureCounter;
+    if (auto it = m_measureCache.find(key); it != m_measureCache.end()) {
+        it->second.counter = m_measureCounter;
+        return it->second.extents.bounds(boundsType);
+    }
+    if (m_measureCache.size() > measureCacheSizeHigh) {
+        for (auto it = m_measureCache.begin(); it != m_measureCache.end();) {
+            if (it->second.counter < m_measureCounter - (measureCacheSizeHigh - measureCacheSizeLow)) {
+                it = m_measureCache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    TextExtents extents;
     if (!text.richText.empty()) {
         RichText richText = text.richText;
         richText.setBaseFont(font);
-        return bounds(text, richText.fonts, richText.offsets, boundsType);
+        extents = doMeasure(text, richText.fonts, richText.offsets);
     } else {
-        return bounds(text, one(FontAndColor{ font }), {}, boundsType);
+        extents = doMeasure(text, one(FontAndColor{ font }), {});
     }
+    m_measureCache.emplace(std::move(key), MeasureCacheEntry{ extents, m_measureCounter });
+    return extents.bounds(boundsType);
 }
 
 PreparedText FontManager::prepare(const TextWithOptions& text, std::span<const FontAndColor> fonts,
@@ -1201,7 +2274,7 @@ void FontManager::testRender(Rc<Image> image, const PreparedText& prepared, Poin
             std::optional<GlyphData> data = g.load(run);
 
             if (data && data->sprite) {
-                BytesView v = data->sprite->bytes();
+                BytesView v = std::as_const(*data->sprite).bytes();
                 if (v.empty())
                     continue;
                 for (int32_t y = 0; y < data->size.height; ++y) {
@@ -1262,6 +2335,10 @@ PreparedText FontManager::doShapeCached(const TextWithOptions& text, std::span<c
 PreparedText FontManager::doShape(const TextWithOptions& text, std::span<const FontAndColor> fonts,
                                   std::span<const uint32_t> offsets) const {
     BRISK_ASSERT_MSG("The number of fonts and offsets do not match", fonts.size() == offsets.size() + 1);
+    if (offsets.empty()) {
+        if (std::optional<PreparedText> shaped = shapeSimpleText(text, fonts.front()))
+            return std::move(*shaped);
+    }
     std::vector<TextRun> textRuns = splitTextRuns(text.text, text.defaultDirection);
 
     uint32_t fontIndex            = 0;
@@ -1293,8 +2370,34 @@ RectangleF FontManager::bounds(const TextWithOptions& text, std::span<const Font
                                std::span<const uint32_t> offsets, GlyphRunBounds boundsType) const {
     BRISK_ASSERT_MSG("The number of fonts and offsets do not match", fonts.size() == offsets.size() + 1);
     lock_quard_cond lk(m_lock);
+    return doMeasure(text, fonts, offsets).bounds(boundsType);
+}
+
+FontManager::TextExtents FontManager::doMeasure(const TextWithOptions& text, std::span<const FontAndColor> fonts,
+                                                std::span<const uint32_t> offsets) const {
+    if (offsets.empty()) {
+        if (std::optional<TextExtents> extents = measureSimpleText(text, fonts.front().font))
+            return *extents;
+    }
     PreparedText run = doPrepare(text, fonts, offsets);
-    return run.bounds(boundsType);
+    return TextExtents{
+        run.bounds(GlyphRunBounds::Text),
+        run.bounds(GlyphRunBounds::Alignment),
+        run.bounds(GlyphRunBounds::Printable),
+    };
+}
+
+RectangleF FontManager::TextExtents::bounds(GlyphRunBounds boundsType) const {
+    switch (boundsType) {
+    case GlyphRunBounds::Text:
+        return text;
+    case GlyphRunBounds::Alignment:
+        return alignment;
+    case GlyphRunBounds::Printable:
+        return printable;
+    default:
+        BRISK_UNREACHABLE();
+    }
 }
 
 void FontManager::garbageCollectCache() {
@@ -1302,6 +2405,157 @@ void FontManager::garbageCollectCache() {
     for (auto& ff : m_fonts) {
         ff.second->garbageCollectCache(0.5);
     }
+    if (m_rasterizer) {
+        std::vector<Internal::GlyphRasterizer::Job> done = m_rasterizer->takeDone();
+        for (Internal::GlyphRasterizer::Job& job : done) {
+            job.face->pendingGlyphs.erase(job.key);
+            // Glyphs that failed to load are cached without a sprite, so they are not queued again
+            FontFace::GlyphDataAndTime& entry = job.face->cache[job.key];
+            job.face->untrackColorGlyph(entry);
+            entry = FontFace::GlyphDataAndTime{ job.glyph ? std::move(*job.glyph) : GlyphData{}, currentTime() };
+            job.face->trackColorGlyph(job.key, entry);
+        }
+        if (!done.empty())
+            m_glyphGeneration.fetch_add(1, std::memory_order::relaxed);
+    }
+    evictColorGlyphs(Internal::colorGlyphCacheBytes);
+}
+
+void FontManager::evictColorGlyphs(size_t maxBytes) {
+    Internal::ColorGlyphCache& colorGlyphs = *m_colorGlyphs;
+    while (colorGlyphs.totalBytes > maxBytes && !colorGlyphs.items.empty()) {
+        const Internal::ColorGlyphCache::Item& item = colorGlyphs.items.back();
+        FontFace* face                              = item.face;
+        auto it                                     = face->cache.find(item.key);
+        BRISK_ASSERT(it != face->cache.end());
+        face->untrackColorGlyph(it->second);
+        face->cache.erase(it);
+    }
+}
+
+void FontManager::prewarmGlyphs(const Font& font, std::u32string_view text) const {
+    lock_quard_cond lk(m_lock);
+    PreparedText prepared = doPrepare(TextWithOptions{ text }, one(FontAndColor{ font }), {});
+    for (const GlyphRun& run : prepared.runs) {
+        for (const Internal::Glyph& g : run.glyphs) {
+            std::ignore = g.load(run);
+        }
+    }
+}
+
+fs::path FontManager::defaultGlyphCachePath() {
+    return defaultFolder(DefaultFolder::AppCache) / "glyphs.cache";
+}
+
+status<IoError> FontManager::loadGlyphCache(const fs::path& path) {
+    expected<Rc<MappedFile>, IoError> file = mapFile(path);
+    if (!file)
+        return unexpected(file.error());
+    BytesView data = (*file)->data();
+    if (data.size() < sizeof(Internal::GlyphCacheFileHeader))
+        return unexpected(IoError::UnsupportedFormat);
+    auto header = reinterpret_cast<const Internal::GlyphCacheFileHeader*>(data.data());
+    if (memcmp(header->magic, Internal::glyphCacheMagic, sizeof(header->magic)) != 0 ||
+        header->version != Internal::glyphCacheVersion ||
+        header->numEntries > (data.size() - sizeof(Internal::GlyphCacheFileHeader)) /
+                                 sizeof(Internal::GlyphCacheFileEntry))
+        return unexpected(IoError::UnsupportedFormat);
+
+    lock_quard_cond lk(m_lock);
+    m_glyphCacheFile     = std::move(*file);
+    m_glyphCacheFilePath = path;
+    return {};
+}
+
+status<IoError> FontManager::saveGlyphCache(const fs::path& path) {
+    using Internal::GlyphCacheFileEntry;
+    struct Item {
+        GlyphCacheFileEntry entry;
+        BytesView pixels;
+    };
+
+    // Only the copy from the caches needs the lock, the file is written without it
+    Bytes out;
+    {
+        lock_quard_cond lk(m_lock);
+        std::vector<Item> items;
+        std::set<std::pair<uint64_t, uint32_t>> loadedFonts;
+        std::set<FontFace*> visited; // the same face is registered under several keys
+        for (const auto& f : m_fonts) {
+            FontFace* face = f.second.get();
+            if (!visited.insert(face).second)
+                continue;
+            const uint64_t hash = face->contentHash();
+            loadedFonts.insert({ hash, face->cacheVariant(false) });
+            loadedFonts.insert({ hash, face->cacheVariant(true) });
+            for (const auto& [key, glyph] : face->cache) {
+                if (!glyph.sprite)
+                    continue;
+                const uint32_t variant = face->cacheVariant(key == sdfGlyphCacheKey(key.glyphIndex));
+                items.push_back(Item{
+                    GlyphCacheFileEntry{ hash, variant, key.fontSize, key.glyphIndex, glyph.size,
+                                         glyph.sprite->size, glyph.offset_x, glyph.offset_y, glyph.advance_x,
+                                         0 },
+                    std::as_const(*glyph.sprite).bytes(),
+                });
+            }
+        }
+        for (const GlyphCacheFileEntry& entry : Internal::glyphCacheEntries(m_glyphCacheFile.get())) {
+            if (!loadedFonts.contains({ entry.fontHash, entry.variant }))
+                continue;
+            if (std::optional<BytesView> pixels = Internal::glyphCachePixels(m_glyphCacheFile.get(), entry))
+                items.push_back(Item{ entry, *pixels });
+        }
+        // Glyphs in memory come first and take precedence over the ones from the old file
+        std::stable_sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+            return a.entry.key() < b.entry.key();
+        });
+        items.erase(std::unique(items.begin(), items.end(),
+                                [](const Item& a, const Item& b) {
+                                    return a.entry.key() == b.entry.key();
+                                }),
+                    items.end());
+
+        out.resize(sizeof(Internal::GlyphCacheFileHeader) + items.size() * sizeof(GlyphCacheFileEntry));
+        Internal::GlyphCacheFileHeader header{};
+        memcpy(header.magic, Internal::glyphCacheMagic, sizeof(header.magic));
+        header.version    = Internal::glyphCacheVersion;
+        header.numEntries = items.size();
+        memcpy(out.data(), &header, sizeof(header));
+        for (size_t i = 0; i < items.size(); ++i) {
+            items[i].entry.dataOffset = out.size();
+            memcpy(out.data() + sizeof(header) + i * sizeof(GlyphCacheFileEntry), &items[i].entry,
+                   sizeof(GlyphCacheFileEntry));
+            out.insert(out.end(), items[i].pixels.begin(), items[i].pixels.end());
+        }
+    }
+
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    fs::path temp = path;
+    temp += ".tmp";
+    if (status<IoError> st = writeBytes(temp, out); !st)
+        return st;
+#ifdef BRISK_WINDOWS
+    // A mapped file cannot be replaced on Windows. Glyphs found in it were copied, so only the mapping
+    // itself needs to go, and it is restored if the file could not be replaced
+    fs::path mappedPath;
+    {
+        lock_quard_cond lk(m_lock);
+        m_glyphCacheFile.reset();
+        mappedPath = m_glyphCacheFilePath;
+    }
+#endif
+    fs::rename(temp, path, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+#ifdef BRISK_WINDOWS
+        if (!mappedPath.empty())
+            std::ignore = loadGlyphCache(mappedPath);
+#endif
+        return unexpected(IoError::CantWrite);
+    }
+    return loadGlyphCache(path);
 }
 
 namespace Internal {
@@ -1316,7 +2570,7 @@ float Glyph::caretForDirection(bool inverse) const {
 std::optional<GlyphData> Glyph::load(const GlyphRun& run) const {
     if (!run.face || glyph == UINT32_MAX)
         return std::nullopt;
-    return run.face->loadGlyphCached(run.fontSize, glyph);
+    return run.face->loadGlyphCached(run.fontSize, glyph, run.sdf);
 }
 
 } // namespace Internal
@@ -1346,6 +2600,7 @@ int32_t PreparedText::yToLine(float y) const {
 }
 
 uint32_t PreparedText::caretToGrapheme(uint32_t line, float x) const {
+    ensureCaretData();
     float distance    = HUGE_VALF;
     uint32_t grapheme = UINT32_MAX;
     for (uint32_t i : lines[line].graphemeRange) {
@@ -1359,7 +2614,7 @@ uint32_t PreparedText::caretToGrapheme(uint32_t line, float x) const {
 }
 
 uint32_t PreparedText::caretToGrapheme(PointF pt) const {
-    if (lines.empty() || !hasCaretData())
+    if (lines.empty())
         return UINT32_MAX;
     int32_t line = yToLine(pt.y);
     if (line < 0) {
@@ -1374,14 +2629,16 @@ uint32_t PreparedText::caretToGrapheme(PointF pt) const {
 PointF PreparedText::graphemeToCaret(uint32_t graphemeIndex) const {
     uint32_t line = graphemeToLine(graphemeIndex);
     if (line != UINT32_MAX) {
+        ensureCaretData();
         return PointF(caretPositions[graphemeIndex], lines[line].baseline);
     }
     return PointF{};
 }
 
 uint32_t PreparedText::graphemeToLine(uint32_t graphemeIndex) const {
-    if (lines.empty() || !hasCaretData())
+    if (lines.empty())
         return UINT32_MAX;
+    ensureCaretData();
     auto it = std::lower_bound(lines.begin(), lines.end(), graphemeIndex,
                                [this](const GlyphLine& line, uint32_t graphemeIndex) {
                                    if (line.runRange.max == 0)
@@ -1396,20 +2653,45 @@ uint32_t PreparedText::graphemeToLine(uint32_t graphemeIndex) const {
     return std::distance(lines.begin(), it);
 }
 
+Range<uint32_t> PreparedText::linesInRange(float top, float bottom) const {
+    auto first = std::partition_point(lines.begin(), lines.end(), [top](const GlyphLine& line) {
+        return line.verticalRange().max <= top;
+    });
+    auto last  = std::partition_point(first, lines.end(), [bottom](const GlyphLine& line) {
+        return line.verticalRange().min < bottom;
+    });
+    return { uint32_t(first - lines.begin()), uint32_t(last - lines.begin()) };
+}
+
 PointF PreparedText::alignLines(float alignment_x, float alignment_y) {
     if (runs.empty()) {
         BRISK_ASSERT(!lines.empty());
         return { 0, -lines.front().ascDesc.height() * alignment_y + lines.front().ascDesc.ascender };
     }
     RectangleF bounds = this->bounds(GlyphRunBounds::Text);
+    float y2          = -bounds.height() * alignment_y - bounds.y1;
+    // Shifts recomputed from already aligned positions are float noise, not zero
+    if (alignment_x == alignedX)
+        return PointF(0, y2);
+    bool moved = false;
     for (GlyphLine& line : lines) {
         auto lineSpan         = std::span{ runs }.subspan(line.runRange.min, line.runRange.distance());
         RectangleF lineBounds = spanBounds(lineSpan, GlyphRunBounds::Alignment);
+        float shift           = lineBounds.x1 + lineBounds.width() * alignment_x;
+        if (shift == 0.f)
+            continue;
+        moved = true;
         for (GlyphRun& run : lineSpan) {
-            run.position.x = run.position.x - lineBounds.x1 - lineBounds.width() * alignment_x;
+            run.position.x = run.position.x - shift;
+        }
+    }
+    if (moved) {
+        invalidateGeometry();
+        if (hasCaretData()) {
+            updateCaretData();
         }
     }
-    float y2 = -bounds.height() * alignment_y - bounds.y1;
+    alignedX = alignment_x;
     return PointF(0, y2);
 }
 
@@ -1447,6 +2729,10 @@ bool GlyphRun::hasColor() const noexcept {
     return face && face->isSvg();
 }
 
+bool GlyphRun::isSdf() const noexcept {
+    return sdf;
+}
+
 RectangleF GlyphRun::bounds(GlyphRunBounds boundsType) const {
     updateRanges();
     const InclusiveRange<float> vRange = this->textVRange();
@@ -1853,7 +3139,17 @@ bool PreparedText::hasCaretData() const noexcept {
     return !caretPositions.empty();
 }
 
-void PreparedText::updateCaretData() {
+void PreparedText::ensureCaretData() const {
+    if (!hasCaretData())
+        updateCaretData();
+}
+
+void PreparedText::invalidateCaretData() noexcept {
+    caretPositions.clear();
+    ranges.clear();
+}
+
+void PreparedText::updateCaretData() const {
     BRISK_ASSERT(graphemeBoundaries.size() >= 1);
     caretPositions.clear();
     ranges.clear();
@@ -1906,6 +3202,8 @@ void PreparedText::updateCaretData() {
 }
 
 GlyphRun& PreparedText::runVisual(uint32_t index) {
+    invalidateGeometry();
+    invalidateCaretData();
     return runs[visualOrder[index]];
 }
 
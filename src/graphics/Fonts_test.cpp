@@ -20,12 +20,15 @@
  */
 #include <fmt/ranges.h>
 #include <brisk/graphics/Fonts.hpp>
+#include <brisk/graphics/Canvas.hpp>
 #include <brisk/core/Utilities.hpp>
 #include <catch2/catch_all.hpp>
 #include "Catch2Utils.hpp"
 #include "../core/test/HelloWorld.hpp"
 #include <brisk/core/Reflection.hpp>
 #include "VisualTests.hpp"
+#include <numeric>
+#include <thread>
 
 namespace Brisk {
 
@@ -159,6 +162,21 @@ TEST_CASE("textBreakPositions") {
     }
 }
 
+TEST_CASE("textBreakPositions reuse") {
+    // Iterators are pooled per thread; repeated and nested use must not share state
+    for (int i = 0; i < 10; ++i) {
+        Rc<Internal::TextBreakIterator> outer =
+            Internal::textBreakIterator(U"abc def ghi", TextBreakMode::Word);
+        CHECK(textBreakPositions(U"𠀀𠀁𠀂 abc", TextBreakMode::Grapheme) ==
+              std::vector<uint32_t>{ 0, 1, 2, 3, 4, 5, 6, 7 });
+        std::vector<uint32_t> positions{ 0 };
+        while (auto pos = outer->next()) {
+            positions.push_back(*pos);
+        }
+        CHECK(positions == std::vector<uint32_t>{ 0, 3, 4, 7, 8, 11 });
+    }
+}
+
 TEST_CASE("splitTextRuns") {
     CHECK(Internal::toVisualOrder(Internal::splitTextRuns(U"𠀀𠀁𠀂 𠀀𠀁𠀂", TextDirection::LTR)) ==
           std::vector<Internal::TextRun>{
@@ -529,6 +547,23 @@ TEST_CASE("FontManager") {
     CHECK(run.graphemeToCaret(2).y == 12);
     CHECK(run.graphemeToCaret(3).y == 24);
     CHECK(run.bounds().height() == 36);
+    CHECK(run.linesInRange(run.lines[0].verticalRange().min, run.lines[2].verticalRange().max) ==
+          Range{ 0u, 3u });
+    CHECK(run.linesInRange(run.lines[1].verticalRange().min, run.lines[1].verticalRange().max) ==
+          Range{ 1u, 2u });
+    CHECK(run.linesInRange(100.f, 200.f).empty());
+
+    run = fontManager->prepare(font, U"abc"s);
+    CHECK(!run.hasCaretData());
+    CHECK(run.graphemeToCaret(3).x > run.graphemeToCaret(0).x);
+    CHECK(run.hasCaretData());
+    float leftCaret = run.caretPositions[0];
+    std::ignore     = run.alignLines(1.f);
+    CHECK(run.caretPositions[0] < leftCaret);
+    float rightCaret = run.caretPositions[0];
+    std::ignore      = run.alignLines(1.f);
+    CHECK(run.caretPositions[0] == rightCaret);
+    CHECK(run.caretToGrapheme(PointF{ rightCaret, 0 }) == 0);
 
     RectangleF bounds          = fontManager->bounds(font, U"Hello, world!"s, GlyphRunBounds::Text);
     bounds                     = fontManager->bounds(font, U"  Hello, world!"s, GlyphRunBounds::Text);
@@ -909,4 +944,356 @@ I	Ì	Î	Ĭ	I̊	I̋	Ï	I̧	Ǐ	Ĩ	Í	Ḯ	Í̈
     fontManager.reset();
 }
 
+// Registers Lato-Medium, which most of the tests below shape with
+static void addLato(FontManager& manager, std::string family = "lato", FontFlags flags = FontFlags::Default) {
+    auto ttf = readBytes(fs::path(PROJECT_SOURCE_DIR) / "resources" / "fonts" / "Lato-Medium.ttf");
+    REQUIRE(ttf.has_value());
+    manager.addFont(std::move(family), FontStyle::Normal, FontWeight::Regular, *ttf, true, flags);
+}
+
+TEST_CASE("Font fallback chain") {
+    FontManager manager(nullptr, 1, 5000);
+    auto ttf2 = readBytes(fs::path(PROJECT_SOURCE_DIR) / "resources" / "fonts" / "GoNotoCurrent-Regular.ttf");
+    REQUIRE(ttf2.has_value());
+    addLato(manager);
+
+    Font font;
+    font.fontFamily = "lato, noto";
+    CHECK(manager.hasCodepoint(font, U'a'));
+    CHECK(!manager.hasCodepoint(font, U'\u0915'));
+    CHECK(!manager.hasCodepoint(font, U'\n'));
+
+    // Adding a font must invalidate previously resolved chains
+    manager.addFont("noto", FontStyle::Normal, FontWeight::Regular, *ttf2, true, FontFlags::Default);
+    CHECK(manager.hasCodepoint(font, U'\u0915'));
+    CHECK(manager.hasCodepoint(font(FontWeight::Bold), U'\u0915'));
+
+    PreparedText text = manager.prepare(font, U"a\u0915a"s);
+    REQUIRE(text.runs.size() == 3);
+    CHECK(text.runs[0].face == text.runs[2].face);
+    CHECK(text.runs[0].face != text.runs[1].face);
+}
+
+TEST_CASE("Simple text") {
+    FontManager manager(nullptr, 1, 5000);
+    addLato(manager);
+    Font font;
+    font.fontFamily = "lato";
+    font.fontSize   = 14;
+
+    for (std::u32string text : { U"Hello, world!", U"abc def", U"1,234.56 USD", U"foo-bar baz", U"A B C D E F",
+                                 U"x = y + 1", U"100% done", U"(a) [b]" }) {
+        INFO(utf32ToUtf8(text));
+        PreparedText prepared = manager.prepare(font, text);
+        REQUIRE(prepared.runs.size() == 1);
+        const GlyphRun& run = prepared.runs[0];
+        REQUIRE(run.glyphs.size() == text.size());
+        std::vector<uint32_t> graphemes(text.size() + 1);
+        std::iota(graphemes.begin(), graphemes.end(), 0u);
+        CHECK(prepared.graphemeBoundaries == graphemes);
+
+        std::vector<uint32_t> lineBreaks;
+        for (const Internal::Glyph& g : run.glyphs) {
+            CHECK(g.right_caret >= g.left_caret);
+            if (g.flags && Internal::GlyphFlags::AtLineBreak)
+                lineBreaks.push_back(g.begin_char);
+        }
+        lineBreaks.push_back(text.size());
+        if (icuAvailable) {
+            CHECK(lineBreaks == textBreakPositions(text, TextBreakMode::Line));
+        }
+    }
+
+    // Requesting any OpenType feature disables the fast path, kerning is enabled by default anyway
+    Font shapedFont = font;
+    shapedFont.features.push_back(OpenTypeFeatureFlag{ OpenTypeFeature::kern, true });
+    for (std::u32string text : { U"Hello, world!", U"AVATAR Type", U"12:30 PM" }) {
+        INFO(utf32ToUtf8(text));
+        PreparedText simple = manager.prepare(font, text);
+        PreparedText shaped = manager.prepare(shapedFont, text);
+        REQUIRE(simple.runs.size() == 1);
+        REQUIRE(shaped.runs.size() == 1);
+        REQUIRE(simple.runs[0].glyphs.size() == shaped.runs[0].glyphs.size());
+        for (size_t i = 0; i < simple.runs[0].glyphs.size(); ++i) {
+            const Internal::Glyph& a = simple.runs[0].glyphs[i];
+            const Internal::Glyph& b = shaped.runs[0].glyphs[i];
+            CHECK(a.glyph == b.glyph);
+            CHECK(a.left_caret == b.left_caret);
+            CHECK(a.right_caret == b.right_caret);
+            CHECK((a.flags && Internal::GlyphFlags::SafeToBreak) ==
+                  (b.flags && Internal::GlyphFlags::SafeToBreak));
+        }
+    }
+
+    // More fractional sizes than the per-face limit, evicted sizes are shaped again when reused
+    const PreparedText first = manager.prepare(font, U"AVATAR Type");
+    for (int i = 0; i < 40; ++i) {
+        Font sized           = font;
+        sized.fontSize       = 10.f + i * 0.1f;
+        Font shapedSized     = shapedFont;
+        shapedSized.fontSize = sized.fontSize;
+        PreparedText simple  = manager.prepare(sized, U"AVATAR Type");
+        PreparedText shaped  = manager.prepare(shapedSized, U"AVATAR Type");
+        CHECK(simple.runs[0].glyphs.back().right_caret == shaped.runs[0].glyphs.back().right_caret);
+    }
+    manager.garbageCollectCache();
+    const PreparedText again = manager.prepare(font, U"AVATAR Type");
+    CHECK(again.runs[0].glyphs.back().right_caret == first.runs[0].glyphs.back().right_caret);
+}
+
+TEST_CASE("Measure text") {
+    FontManager manager(nullptr, 1, 5000);
+    addLato(manager);
+    Font font;
+    font.fontFamily    = "lato";
+    font.fontSize      = 14;
+    font.letterSpacing = 1;
+    font.wordSpacing   = 2;
+
+    // Measurement must agree with the bounds of fully prepared text, whether or not the fast path applies
+    for (std::u32string text : { U"Hello, world!", U"  padded  ", U"   ", U"AVATAR Type", U"Caf\u00E9", U"a\nb",
+                                 U"" }) {
+        INFO(utf32ToUtf8(text));
+        PreparedText prepared = manager.prepare(font, text);
+        for (GlyphRunBounds type : { GlyphRunBounds::Text, GlyphRunBounds::Alignment, GlyphRunBounds::Printable }) {
+            CHECK(manager.bounds(font, text, type) == prepared.bounds(type));
+            // Memoized
+            CHECK(manager.bounds(font, text, type) == prepared.bounds(type));
+        }
+    }
+}
+
+namespace {
+// Canvas only needs somewhere to send its commands
+class NullRenderContext final : public RenderContext {
+    BRISK_DYNAMIC_CLASS(NullRenderContext, RenderContext)
+public:
+    void command(RenderStateEx&& cmd, std::span<const uint32_t> data) override {}
+
+    void setGlobalScissor(Rectangle rect) override {}
+
+    int numBatches() const override {
+        return 0;
+    }
+};
+} // namespace
+
+TEST_CASE("Text geometry cache") {
+    FontManager manager(nullptr, 1, 5000);
+    addLato(manager);
+    PreparedText text = manager.prepare(Font{ "lato", 20.f }, U"Hello, world!");
+    NullRenderContext context;
+    Canvas canvas(context);
+
+    canvas.fillText({ 10, 20 }, text);
+    REQUIRE(text.geometryCache);
+    Rc<Internal::TextGeometryCache> cache = text.geometryCache;
+
+    // Whole pixel offsets reuse the quads
+    canvas.fillText({ 15, 27 }, text);
+    CHECK(text.geometryCache == cache);
+
+    // Snapped quads cannot be moved by a fraction of a pixel
+    canvas.fillText({ 15.5f, 27 }, text);
+    REQUIRE(text.geometryCache);
+    CHECK(text.geometryCache != cache);
+
+    // Copies share the cache until either of them moves its glyphs
+    PreparedText copy = text;
+    CHECK(copy.geometryCache == text.geometryCache);
+    std::ignore = copy.alignLines(0.5f);
+    CHECK(!copy.geometryCache);
+    CHECK(text.geometryCache);
+
+    // Realigning with the same factor does not move the glyphs again
+    canvas.fillText({ 10, 20 }, copy);
+    REQUIRE(copy.geometryCache);
+    const float x = copy.runs[0].position.x;
+    std::ignore   = copy.alignLines(0.5f);
+    CHECK(copy.geometryCache);
+    CHECK(copy.runs[0].position.x == x);
+
+    text.invalidateGeometry();
+    CHECK(!text.geometryCache);
+    canvas.fillText({ 10, 20 }, text);
+    CHECK(text.geometryCache);
+}
+
+TEST_CASE("addFontFromFile") {
+    FontManager manager(nullptr, 1, 5000);
+    fs::path path = fs::path(PROJECT_SOURCE_DIR) / "resources" / "fonts" / "Lato-Medium.ttf";
+    REQUIRE(manager.addFontFromFile("lato", FontStyle::Normal, FontWeight::Regular, path).has_value());
+    // Shares the mapping with the face above
+    REQUIRE(manager.addFontFromFile("other", FontStyle::Normal, FontWeight::Bold, path).has_value());
+    CHECK(!manager.addFontFromFile("missing", FontStyle::Normal, FontWeight::Regular, path / "missing")
+               .has_value());
+
+    Font font;
+    font.fontFamily = "lato";
+    font.fontSize   = 14;
+    PreparedText a  = manager.prepare(font, U"Brisk"s);
+    PreparedText b  = manager.prepare(font("other")(FontWeight::Bold), U"Brisk"s);
+    REQUIRE(a.runs.size() == 1);
+    REQUIRE(b.runs.size() == 1);
+    CHECK(a.runs[0].face != b.runs[0].face);
+    CHECK(a.bounds(GlyphRunBounds::Alignment) == b.bounds(GlyphRunBounds::Alignment));
+}
+
+TEST_CASE("installedFonts") {
+    fs::path path = tempFilePath("brisk-fonts-*.json");
+    std::vector<OsFont> scanned;
+    {
+        FontManager manager(nullptr, 1, 5000);
+        manager.setFontIndexPath(path);
+        scanned = manager.installedFonts();
+    }
+    // The second scan is served from the index
+    FontManager manager(nullptr, 1, 5000);
+    manager.setFontIndexPath(path);
+    std::vector<OsFont> indexed = manager.installedFonts();
+    REQUIRE(indexed.size() == scanned.size());
+    for (size_t i = 0; i < indexed.size(); ++i) {
+        CHECK(indexed[i].path == scanned[i].path);
+        CHECK(indexed[i].family == scanned[i].family);
+        CHECK(indexed[i].style == scanned[i].style);
+        CHECK(indexed[i].weight == scanned[i].weight);
+        CHECK(indexed[i].styleName == scanned[i].styleName);
+    }
+    fs::remove(path);
+
+    // An empty path keeps the index in memory only
+    FontManager memoryOnly(nullptr, 1, 5000);
+    memoryOnly.setFontIndexPath({});
+    CHECK(memoryOnly.installedFonts().size() == scanned.size());
+    CHECK(!fs::exists(path));
+}
+
+TEST_CASE("SDF glyphs") {
+    FontManager manager(nullptr, 3, 5000);
+    addLato(manager);
+    addLato(manager, "latosdf", FontFlags::SdfGlyphs);
+
+    Font font;
+    font.fontFamily      = "latosdf";
+    font.fontSize        = 12;
+    PreparedText small   = manager.prepare(font, U"a"s);
+    PreparedText large   = manager.prepare(font(60.f), U"a"s);
+    PreparedText regular = manager.prepare(font("lato"), U"a"s);
+    REQUIRE(small.runs.size() == 1);
+    REQUIRE(large.runs.size() == 1);
+    REQUIRE(regular.runs.size() == 1);
+    CHECK(!regular.runs[0].isSdf());
+    CHECK(!manager.sdfGlyphs());
+    if (!small.runs[0].isSdf()) {
+        SKIP("FreeType is built without the sdf module");
+    }
+    CHECK(large.runs[0].isSdf());
+
+    auto g1 = small.runs[0].glyphs[0].load(small.runs[0]);
+    auto g2 = large.runs[0].glyphs[0].load(large.runs[0]);
+    REQUIRE(g1.has_value());
+    REQUIRE(g2.has_value());
+    // A single distance field is shared by all font sizes
+    CHECK(g1->sprite == g2->sprite);
+    CHECK(g1->size == g2->size);
+    // Padded by the spread on every side
+    CHECK(g1->size.width > 2 * Internal::sdfSpread);
+    CHECK(g1->size.height > 2 * Internal::sdfSpread);
+
+    manager.setSdfGlyphs(true);
+    CHECK(manager.sdfGlyphs());
+    // Runs shaped before the switch keep their mode
+    CHECK(!regular.runs[0].isSdf());
+    auto g3 = regular.runs[0].glyphs[0].load(regular.runs[0]);
+    REQUIRE(g3.has_value());
+    CHECK(g3->sprite != g1->sprite);
+    regular = manager.prepare(font("lato"), U"a"s);
+    CHECK(regular.runs[0].isSdf());
+}
+
+TEST_CASE("Async color glyphs") {
+    FontManager manager(nullptr, 3, 5000);
+    auto ttf = readBytes(fs::path(PROJECT_SOURCE_DIR) / "resources" / "fonts" / "NotoColorEmoji-SVG.otf");
+    REQUIRE(ttf.has_value());
+    manager.addFont("emoji", FontStyle::Normal, FontWeight::Regular, *ttf, true, FontFlags::EnableColor);
+    manager.setAsyncColorGlyphs(true);
+
+    Font font;
+    font.fontFamily       = "emoji";
+    font.fontSize         = 20.5f;
+    PreparedText prepared = manager.prepare(font, U"\U0001F451"s);
+    REQUIRE(prepared.runs.size() == 1);
+    const GlyphRun& run       = prepared.runs[0];
+    const uint32_t generation = manager.glyphGeneration();
+    auto placeholder          = run.glyphs[0].load(run);
+    REQUIRE(placeholder.has_value());
+    REQUIRE(placeholder->sprite);
+    for (int i = 0; i < 500 && manager.glyphGeneration() == generation; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        manager.garbageCollectCache();
+    }
+    REQUIRE(manager.glyphGeneration() != generation);
+
+    auto glyph = run.glyphs[0].load(run);
+    REQUIRE(glyph.has_value());
+    REQUIRE(glyph->sprite);
+    CHECK(glyph->sprite != placeholder->sprite);
+    // Rasterized at a whole pixel size and scaled down
+    CHECK_THAT(glyph->scale, Catch::Matchers::WithinAbs(20.5f / 21.f, 0.0001f));
+    manager.setAsyncColorGlyphs(false);
+}
+
+TEST_CASE("Glyph cache file") {
+    Font font;
+    font.fontFamily = "lato";
+    font.fontSize   = 14;
+    fs::path path   = tempFilePath("brisk-glyphs-*.cache");
+
+    Bytes rasterized;
+    {
+        FontManager manager(nullptr, 3, 5000);
+        addLato(manager);
+        manager.prewarmGlyphs(font, U"Brisk");
+        REQUIRE(manager.saveGlyphCache(path).has_value());
+        PreparedText text = manager.prepare(font, U"B"s);
+        auto g            = text.runs[0].glyphs[0].load(text.runs[0]);
+        REQUIRE(g.has_value());
+        rasterized = toBytes(std::as_const(*g->sprite).bytes());
+    }
+    {
+        FontManager manager(nullptr, 3, 5000);
+        addLato(manager);
+        REQUIRE(manager.loadGlyphCache(path).has_value());
+        PreparedText text = manager.prepare(font, U"B"s);
+        auto g            = text.runs[0].glyphs[0].load(text.runs[0]);
+        REQUIRE(g.has_value());
+        CHECK(toBytes(std::as_const(*g->sprite).bytes()) == rasterized);
+        const uintmax_t fileSize = fs::file_size(path);
+
+        // A failed save keeps the mapped file, so its glyphs still go into the next save
+        fs::path blocked = tempFilePath("brisk-glyphs-*.cache");
+        REQUIRE(writeBytes(blocked, toBytesView("file")).has_value());
+        CHECK(!manager.saveGlyphCache(blocked / "glyphs.cache").has_value());
+        fs::remove(blocked);
+
+        // Rewriting the file that is currently mapped keeps its glyphs
+        REQUIRE(manager.saveGlyphCache(path).has_value());
+        CHECK(fs::file_size(path) == fileSize);
+    }
+    {
+        FontManager manager(nullptr, 3, 5000);
+        addLato(manager);
+        REQUIRE(manager.loadGlyphCache(path).has_value());
+        PreparedText text = manager.prepare(font, U"B"s);
+        auto g            = text.runs[0].glyphs[0].load(text.runs[0]);
+        REQUIRE(g.has_value());
+        CHECK(toBytes(std::as_const(*g->sprite).bytes()) == rasterized);
+    }
+
+    REQUIRE(writeBytes(path, toBytesView("not a glyph cache")).has_value());
+    FontManager manager(nullptr, 3, 5000);
+    CHECK(manager.loadGlyphCache(path).error() == IoError::UnsupportedFormat);
+    fs::remove(path);
+}
+
 } // namespace Brisk
@@ -29,8 +29,12 @@
 #include <unicode/uclean.h>
 #include <unicode/ubidi.h>
 #include <unicode/brkiter.h>
+#include <unicode/utext.h>
 #include <unicode/udata.h>
 #include <brisk/core/Resources.hpp>
+#include <brisk/core/Io.hpp>
+#include <brisk/core/Log.hpp>
+#include <mutex>
 
 #include "unicode/utypes.h"
 #include "unicode/udata.h"
@@ -87,31 +91,93 @@ namespace Brisk {
 
 bool icuAvailable = true;
 
-// Uncompress and initialize ICU data.
-static void uncompressIcuData() {
-    static bool icuDataInit = false;
-    if (icuDataInit)
-        return;
+// ICU data shipped as a separate file, either pointed to by BRISK_ICU_DATA or placed next to the executable
+static std::optional<fs::path> icuDataFile() {
+    std::error_code ec;
+    if (const char* env = std::getenv("BRISK_ICU_DATA"); env && *env && fs::is_regular_file(env, ec))
+        return fs::path(env);
+    fs::path nextToExe = executablePath().parent_path() / "icudt.dat";
+    if (fs::is_regular_file(nextToExe, ec))
+        return nextToExe;
+    return std::nullopt;
+}
 
-    // Unpack the ICU data.
-    static const Bytes icudt = Resources::load("internal/icudt.dat");
+// Checks that the file is an ICU common data archive for the ICU version and platform Brisk is built with.
+// Entry names start with the package name, e.g. "icudt74l/", which encodes the version and endianness
+static bool isCompatibleIcuData(BytesView data) {
+    struct Header {
+        uint16_t headerSize;
+        uint8_t magic1;
+        uint8_t magic2;
+        UDataInfo info;
+    };
+    Header header;
+    if (data.size() < sizeof(Header))
+        return false;
+    memcpy(&header, data.data(), sizeof(Header));
+    if (header.magic1 != 0xda || header.magic2 != 0x27 || header.info.isBigEndian != U_IS_BIG_ENDIAN ||
+        header.info.charsetFamily != U_CHARSET_FAMILY || header.info.sizeofUChar != U_SIZEOF_UCHAR ||
+        memcmp(header.info.dataFormat, "CmnD", 4) != 0 || header.info.formatVersion[0] != 1)
+        return false;
+
+    // Table of contents: entry count followed by (name offset, data offset) pairs
+    const size_t toc = header.headerSize;
+    uint32_t count, nameOffset;
+    if (data.size() < toc + 3 * sizeof(uint32_t))
+        return false;
+    memcpy(&count, data.data() + toc, sizeof(uint32_t));
+    memcpy(&nameOffset, data.data() + toc + sizeof(uint32_t), sizeof(uint32_t));
+    constexpr std::string_view package = U_ICUDATA_NAME "/";
+    if (count == 0 || nameOffset > data.size() - toc || data.size() - toc - nameOffset < package.size())
+        return false;
+    return std::string_view(reinterpret_cast<const char*>(data.data()) + toc + nameOffset, package.size()) ==
+           package;
+}
 
-    UErrorCode uerr          = U_ZERO_ERROR;
-    udata_setCommonData(icudt.data(), &uerr);
-    if (uerr != UErrorCode::U_ZERO_ERROR) {
-        // Throw an exception if there was an error, including the error name.
-        throwException(EUnicode("ICU setCommonData Error: {}", u_errorName(uerr)));
+// Returns ICU data, preferring sources that need no unpacking. A mapped file and uncompressed embedded
+// data are paged in by the OS only as ICU touches them; compressed embedded data is the fallback and has
+// to be unpacked to the heap in full.
+static BytesView loadIcuData() {
+    static Rc<MappedFile> mapped;
+    static Bytes unpacked;
+
+    if (std::optional<fs::path> path = icuDataFile()) {
+        if (expected<Rc<MappedFile>, IoError> file = mapFile(*path); file && !(*file)->data().empty()) {
+            if (isCompatibleIcuData((*file)->data())) {
+                mapped = std::move(*file);
+                return mapped->data();
+            }
+            BRISK_LOG_WARN("{} is not ICU data for ICU {}, using the embedded data", path->string(),
+                           U_ICU_VERSION);
+        }
     }
+    if (std::optional<BytesView> embedded = Resources::view("internal/icudt.dat"))
+        return *embedded;
+    unpacked = Resources::load("internal/icudt.dat");
+    return unpacked;
+}
+
+// Locate and initialize ICU data on first use.
+static void initIcuData() {
+    static std::once_flag icuDataInit;
+    std::call_once(icuDataInit, []() {
+        BytesView icudt = loadIcuData();
 
-    icuDataInit = true;
+        UErrorCode uerr = U_ZERO_ERROR;
+        udata_setCommonData(icudt.data(), &uerr);
+        if (uerr != UErrorCode::U_ZERO_ERROR) {
+            // Throw an exception if there was an error, including the error name.
+            throwException(EUnicode("ICU setCommonData Error: {}", u_errorName(uerr)));
+        }
 
-    uerr        = U_ZERO_ERROR;
-    u_init(&uerr);
+        uerr = U_ZERO_ERROR;
+        u_init(&uerr);
 
-    if (uerr != UErrorCode::U_ZERO_ERROR) {
-        // Throw an exception if there was an error, including the error name.
-        throwException(EUnicode("ICU Init Error: {}", u_errorName(uerr)));
-    }
+        if (uerr != UErrorCode::U_ZERO_ERROR) {
+            // Throw an exception if there was an error, including the error name.
+            throwException(EUnicode("ICU Init Error: {}", u_errorName(uerr)));
+        }
+    });
 }
 
 struct UBiDiDeleter {
@@ -124,15 +190,8 @@ struct UBiDiDeleter {
     throwException(EUnicode("ICU Error: {}", safeCharPtr(u_errorName(err))));
 }
 
-struct LockableICUBreakIterator {
-    std::mutex mutex;
-    std::unique_ptr<icu::BreakIterator> iterator;
-};
-
-static LockableICUBreakIterator cachedBreakIterators[3];
-
 static std::unique_ptr<icu::BreakIterator> createICUBreakIterator(TextBreakMode mode) {
-    uncompressIcuData();
+    initIcuData();
     UErrorCode uerr = U_ZERO_ERROR;
     std::unique_ptr<icu::BreakIterator> iter;
     switch (mode) {
@@ -155,43 +214,48 @@ static std::unique_ptr<icu::BreakIterator> createICUBreakIterator(TextBreakMode
     }
 }
 
-struct LockedICUBreakIterator {
-    LockableICUBreakIterator* locked;
-    icu::BreakIterator* iterator;
+// An ICU break iterator together with the UText and UTF-16 buffer it was last used with. Reopening the
+// UText and refilling the buffer reuses their storage
+struct PooledICUBreakIterator {
+    std::unique_ptr<icu::BreakIterator> iterator;
+    UText text = UTEXT_INITIALIZER;
+    std::u16string buffer;
+
+    PooledICUBreakIterator()                                         = default;
+    PooledICUBreakIterator(const PooledICUBreakIterator&)            = delete;
+    PooledICUBreakIterator& operator=(const PooledICUBreakIterator&) = delete;
 
-    icu::BreakIterator* operator->() const {
-        return iterator;
+    ~PooledICUBreakIterator() {
+        utext_close(&text);
     }
+};
 
-    LockedICUBreakIterator(const LockedICUBreakIterator&) noexcept            = delete;
-    LockedICUBreakIterator(LockedICUBreakIterator&&) noexcept                 = delete;
-    LockedICUBreakIterator& operator=(const LockedICUBreakIterator&) noexcept = delete;
-    LockedICUBreakIterator& operator=(LockedICUBreakIterator&&) noexcept      = delete;
+// Creating a break iterator is very expensive in ICU, so each thread keeps the iterators it has used.
+// An iterator is taken out of the pool while in use, which keeps nested use on one thread safe without
+// locking
+struct ICUBreakIteratorPool {
+    constexpr static size_t maxFree = 4;
+    std::vector<std::unique_ptr<PooledICUBreakIterator>> free[3];
+};
 
-    LockedICUBreakIterator(TextBreakMode mode) {
-        if (cachedBreakIterators[+mode].mutex.try_lock()) {
-            if (!cachedBreakIterators[+mode].iterator) {
-                cachedBreakIterators[+mode].iterator = createICUBreakIterator(mode);
-            }
-            locked   = &cachedBreakIterators[+mode];
-            iterator = cachedBreakIterators[+mode].iterator.get();
-        } else {
-            locked   = nullptr;
-            iterator = createICUBreakIterator(mode).release();
-        }
-    }
+static thread_local ICUBreakIteratorPool breakIteratorPool;
 
-    ~LockedICUBreakIterator() {
-        if (locked) {
-            locked->mutex.unlock();
-        } else {
-            delete iterator;
-        }
+static std::unique_ptr<PooledICUBreakIterator> acquireICUBreakIterator(TextBreakMode mode) {
+    auto& list = breakIteratorPool.free[+mode];
+    if (!list.empty()) {
+        std::unique_ptr<PooledICUBreakIterator> result = std::move(list.back());
+        list.pop_back();
+        return result;
     }
-};
+    auto result      = std::make_unique<PooledICUBreakIterator>();
+    result->iterator = createICUBreakIterator(mode);
+    return result;
+}
 
-LockedICUBreakIterator acquireICUBreakIterator(TextBreakMode mode) {
-    return LockedICUBreakIterator(mode);
+static void releaseICUBreakIterator(TextBreakMode mode, std::unique_ptr<PooledICUBreakIterator> iter) {
+    auto& list = breakIteratorPool.free[+mode];
+    if (list.size() < ICUBreakIteratorPool::maxFree)
+        list.push_back(std::move(iter));
 }
 
 static TextDirection toDir(UBiDiDirection direction) {
@@ -214,27 +278,32 @@ namespace {
 
 class TextBreakIteratorIcu final : public TextBreakIterator {
 public:
-    LockedICUBreakIterator icu;
-    icu::UnicodeString ustr;
+    TextBreakMode mode;
+    std::unique_ptr<PooledICUBreakIterator> icu;
     size_t codepoints = 0;
     int32_t oldp      = 0;
 
-    TextBreakIteratorIcu(std::u32string_view text, TextBreakMode mode) : icu(mode) {
-        uncompressIcuData();
-        std::u16string u16 = utf32ToUtf16(text);
-        ustr.setTo(u16.data(), u16.size());
-        icu->setText(ustr);
+    TextBreakIteratorIcu(std::u32string_view text, TextBreakMode mode)
+        : mode(mode), icu(acquireICUBreakIterator(mode)) {
+        std::u16string& u16 = icu->buffer;
+        utf32ToUtf16(u16, text);
+        UErrorCode uerr = U_ZERO_ERROR;
+        utext_openUChars(&icu->text, u16.data(), u16.size(), &uerr);
+        HANDLE_UERROR();
+        icu->iterator->setText(&icu->text, uerr);
+        HANDLE_UERROR();
     }
 
-    ~TextBreakIteratorIcu() = default;
+    ~TextBreakIteratorIcu() {
+        releaseICUBreakIterator(mode, std::move(icu));
+    }
 
     std::optional<uint32_t> next() {
-        int32_t p = icu->next();
+        int32_t p = icu->iterator->next();
         if (p == icu::BreakIterator::DONE) {
             return std::nullopt;
         }
-        codepoints +=
-            utf16Codepoints(std::u16string_view{ ustr.getBuffer() + oldp, static_cast<size_t>(p - oldp) });
+        codepoints += utf16Codepoints(std::u16string_view(icu->buffer).substr(oldp, p - oldp));
         oldp = p;
         return codepoints;
     }
@@ -248,7 +317,7 @@ public:
     int32_t u16chars   = 0;
 
     BidiTextIteratorIcu(std::u32string_view text, TextDirection defaultDirection) {
-        uncompressIcuData();
+        initIcuData();
         UErrorCode uerr = U_ZERO_ERROR;
         bidi.reset(ubidi_openSized(0, 0, &uerr));
         HANDLE_UERROR();
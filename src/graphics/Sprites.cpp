@@ -0,0 +1,36 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#include <brisk/graphics/internal/Sprites.hpp>
+
+namespace Brisk {
+
+namespace Internal {
+
+SizeClassPool& spritePool() {
+    // Intentionally leaked: sprites may outlive static destructors (e.g. cached glyphs)
+    static SizeClassPool* pool = new SizeClassPool(alignof(std::max_align_t), 8192 / alignof(std::max_align_t),
+                                                   8 * 1024 * 1024);
+    return *pool;
+}
+
+} // namespace Internal
+
+} // namespace Brisk
@@ -0,0 +1,50 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#include <brisk/graphics/internal/Sprites.hpp>
+#include <catch2/catch_all.hpp>
+#include "Catch2Utils.hpp"
+
+namespace Brisk {
+
+TEST_CASE("makeSprite") {
+    size_t blocks = Internal::spritePool().stat().numBlocks;
+    {
+        Rc<SpriteResource> sprite = makeSprite(Size{ 4, 3 }, toBytesView("abcdefghijkl"));
+        CHECK(sprite->bytes().size() == 12);
+        CHECK(std::memcmp(sprite->data(), "abcdefghijkl", 12) == 0);
+        // Sprite and its control block
+        CHECK(Internal::spritePool().stat().numBlocks == blocks + 2);
+    }
+    CHECK(Internal::spritePool().stat().numBlocks == blocks);
+}
+
+TEST_CASE("makeSpriteView") {
+    auto owner = std::make_shared<std::string>("abcdefghijkl");
+    {
+        Rc<const SpriteResource> sprite = makeSpriteView(Size{ 4, 3 }, toBytesView(*owner), owner);
+        CHECK(owner.use_count() == 2);
+        CHECK(sprite->data() == reinterpret_cast<const std::byte*>(owner->data()));
+        CHECK(sprite->bytes().size() == 12);
+    }
+    CHECK(owner.use_count() == 1);
+}
+
+} // namespace Brisk
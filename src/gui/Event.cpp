@@ -90,25 +90,139 @@ template std::optional<EventTargeted> Event::as<EventTargeted>() const;
 
 void HitTestMap::clear() {
     list.clear();
-    tabGroupId = 0;
+    tabGroupId   = 0;
+    m_indexValid = false;
 }
 
-void HitTestMap::add(std::shared_ptr<Widget> w, InputShape rect, bool anywhere, int zindex) {
+bool HitTestMap::add(std::shared_ptr<Widget> w, InputShape rect, bool anywhere, int zindex) {
     if (rect.empty())
+        return false;
+    list.push_back(HitTestEntry{ std::move(w), zindex, rect, anywhere });
+    m_indexValid = false;
+    return true;
+}
+
+void HitTestMap::build() const {
+    if (m_indexValid)
         return;
-    auto it = std::lower_bound(list.begin(), list.end(), zindex,
-                               [](const HitTestEntry& e, int zindex) BRISK_INLINE_LAMBDA {
-                                   return e.zindex < zindex;
-                               });
-    list.insert(it, HitTestEntry{ w, zindex, rect, anywhere });
+    m_indexValid = true;
+    Index& index = m_index;
+    const auto n = static_cast<uint32_t>(list.size());
+
+    // Same order as inserting every entry before the entries with equal z-index
+    index.order.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        index.order[i] = n - 1 - i;
+    }
+    std::stable_sort(index.order.begin(), index.order.end(), [this](uint32_t a, uint32_t b) {
+        return list[a].zindex < list[b].zindex;
+    });
+
+    index.anywhere.clear();
+    index.large.clear();
+    std::optional<Rectangle> bounds;
+    for (uint32_t pos = 0; pos < n; ++pos) {
+        const HitTestEntry& e = list[index.order[pos]];
+        if (e.anywhere)
+            index.anywhere.push_back(pos);
+        Rectangle r = e.rect.clippedBounds();
+        if (!r.empty())
+            bounds = bounds ? bounds->union_(r) : r;
+    }
+    index.bounds = bounds.value_or(Rectangle{});
+
+    // Aim at about two entries per cell with at most 64k cells
+    constexpr int64_t maxCells = 65536;
+    const int64_t area         = int64_t(index.bounds.width()) * index.bounds.height();
+    index.cellSize             = std::max(16, int(std::ceil(std::sqrt(area / std::max(1.0, n * 0.5)))));
+    for (;;) {
+        index.cells = Size{ (index.bounds.width() + index.cellSize - 1) / index.cellSize,
+                            (index.bounds.height() + index.cellSize - 1) / index.cellSize };
+        if (int64_t(index.cells.width) * index.cells.height <= maxCells)
+            break;
+        index.cellSize *= 2;
+    }
+    const int64_t numCells = int64_t(index.cells.width) * index.cells.height;
+
+    auto cellRange = [&index](Rectangle r) -> Rectangle {
+        return Rectangle{ (r.x1 - index.bounds.x1) / index.cellSize,
+                          (r.y1 - index.bounds.y1) / index.cellSize,
+                          (r.x2 - 1 - index.bounds.x1) / index.cellSize + 1,
+                          (r.y2 - 1 - index.bounds.y1) / index.cellSize + 1 };
+    };
+
+    // Entries covering a quarter of the grid or more are tested for every point instead
+    index.cellStart.assign(numCells + 1, 0);
+    for (uint32_t pos = 0; pos < n; ++pos) {
+        Rectangle r = list[index.order[pos]].rect.clippedBounds();
+        if (r.empty())
+            continue;
+        Rectangle cells = cellRange(r);
+        if (int64_t(cells.width()) * cells.height() * 4 >= numCells) {
+            index.large.push_back(pos);
+            continue;
+        }
+        for (int y = cells.y1; y < cells.y2; ++y)
+            for (int x = cells.x1; x < cells.x2; ++x)
+                ++index.cellStart[y * index.cells.width + x + 1];
+    }
+    for (int64_t c = 0; c < numCells; ++c) {
+        index.cellStart[c + 1] += index.cellStart[c];
+    }
+    index.cellEntries.resize(index.cellStart[numCells]);
+    std::vector<uint32_t> fill(index.cellStart.begin(), index.cellStart.end() - 1);
+    size_t large = 0;
+    for (uint32_t pos = 0; pos < n; ++pos) {
+        Rectangle r = list[index.order[pos]].rect.clippedBounds();
+        if (r.empty())
+            continue;
+        if (large < index.large.size() && index.large[large] == pos) {
+            ++large;
+            continue;
+        }
+        Rectangle cells = cellRange(r);
+        for (int y = cells.y1; y < cells.y2; ++y)
+            for (int x = cells.x1; x < cells.x2; ++x)
+                index.cellEntries[fill[y * index.cells.width + x]++] = pos;
+    }
 }
 
-std::shared_ptr<Widget> HitTestMap::get(float x, float y, bool respect_anywhere) const {
-    for (const HitTestEntry& e : list) {
-        if (e.rect.contains(Point(x, y)) || (respect_anywhere && e.anywhere)) {
-            return e.widget.lock();
+const HitTestMap::HitTestEntry& HitTestMap::at(size_t position) const {
+    build();
+    return list[m_index.order[position]];
+}
+
+size_t HitTestMap::find(Point pt, size_t from, bool respect_anywhere) const {
+    build();
+    const Index& index = m_index;
+    size_t result      = list.size();
+    auto findIn        = [&](const uint32_t* first, const uint32_t* last) BRISK_INLINE_LAMBDA {
+        for (const uint32_t* it = std::lower_bound(first, last, from); it != last && *it < result; ++it) {
+            if (list[index.order[*it]].rect.contains(pt)) {
+                result = *it;
+                return;
+            }
         }
+    };
+    if (respect_anywhere) {
+        auto it = std::lower_bound(index.anywhere.begin(), index.anywhere.end(), from);
+        if (it != index.anywhere.end())
+            result = *it;
+    }
+    if (index.bounds.contains(pt)) {
+        const int cell = (pt.y - index.bounds.y1) / index.cellSize * index.cells.width +
+                         (pt.x - index.bounds.x1) / index.cellSize;
+        findIn(index.cellEntries.data() + index.cellStart[cell],
+               index.cellEntries.data() + index.cellStart[cell + 1]);
     }
+    findIn(index.large.data(), index.large.data() + index.large.size());
+    return result;
+}
+
+std::shared_ptr<Widget> HitTestMap::get(float x, float y, bool respect_anywhere) const {
+    size_t position = find(Point(x, y), 0, respect_anywhere);
+    if (position < list.size())
+        return at(position).widget.lock();
     return nullptr;
 }
 
@@ -171,7 +285,52 @@ void InputQueue::beginDrag(std::shared_ptr<Widget> dragSource, std::shared_ptr<O
     this->draggingOnSource = true;
 }
 
+static bool sameMouseState(const EventMouse& a, const EventMouse& b) noexcept {
+    return a.mods == b.mods && a.downPoint == b.downPoint;
+}
+
+template <typename Wheel>
+static bool mergeWheel(std::deque<Event>& events, const Wheel& wheel) {
+    // Vertical and horizontal wheel events of a single scroll arrive interleaved
+    for (auto it = events.rbegin(); it != events.rend() && it - events.rbegin() < 2; ++it) {
+        if (Wheel* last = std::get_if<Wheel>(&static_cast<EventVariant&>(*it))) {
+            if (!sameMouseState(*last, wheel) || last->point != wheel.point)
+                return false;
+            last->delta += wheel.delta;
+            return true;
+        }
+        if (it->type() != EventType::MouseXWheel && it->type() != EventType::MouseYWheel)
+            return false;
+    }
+    return false;
+}
+
+static bool mergeEvent(std::deque<Event>& events, const Event& event) {
+    if (events.empty())
+        return false;
+    switch (event.type()) {
+    case EventType::MouseMoved: {
+        const auto& moved = std::get<EventMouseMoved>(event);
+        auto* last        = std::get_if<EventMouseMoved>(&static_cast<EventVariant&>(events.back()));
+        if (!last || !sameMouseState(*last, moved))
+            return false;
+        last->coalesced.push_back(last->point);
+        last->coalesced.insert(last->coalesced.end(), moved.coalesced.begin(), moved.coalesced.end());
+        last->point = moved.point;
+        return true;
+    }
+    case EventType::MouseYWheel:
+        return mergeWheel(events, std::get<EventMouseYWheel>(event));
+    case EventType::MouseXWheel:
+        return mergeWheel(events, std::get<EventMouseXWheel>(event));
+    default:
+        return false;
+    }
+}
+
 void InputQueue::addEvent(Event event) {
+    if (mergeEvent(events, event))
+        return;
     events.push_back(std::move(event));
 }
 
@@ -309,7 +468,8 @@ void InputQueue::processKeyEvent(Event e) {
 
 std::optional<std::string> InputQueue::getHintAtMouse() const {
     return getAtMouse<std::string>([](Widget* w) BRISK_INLINE_LAMBDA {
-        return !w->m_hint.empty() ? std::optional<std::string>(w->m_hint) : std::nullopt;
+        const std::string& hint = w->hint.get();
+        return !hint.empty() ? std::optional<std::string>(hint) : std::nullopt;
     });
 }
 
@@ -327,10 +487,10 @@ std::tuple<std::shared_ptr<Widget>, int> InputQueue::getAt(Point pt, int offset,
                                                            bool respect_anywhere) const {
     if (offset < 0 && !capturingMouse.empty())
         return std::tuple<std::shared_ptr<Widget>, int>{ capturingMouse.back().lock(), 0 };
-    for (int i = std::max(0, offset); i < hitTest.list.size(); i++) {
-        if (Rc<Widget> w = hitTest.list[i].widget.lock();
-            w && (hitTest.list[i].rect.contains(pt) || (respect_anywhere && hitTest.list[i].anywhere)))
-            return std::tuple<std::shared_ptr<Widget>, int>{ w, i + 1 };
+    for (size_t i = hitTest.find(pt, std::max(0, offset), respect_anywhere); i < hitTest.size();
+         i = hitTest.find(pt, i + 1, respect_anywhere)) {
+        if (Rc<Widget> w = hitTest.at(i).widget.lock())
+            return std::tuple<std::shared_ptr<Widget>, int>{ w, int(i + 1) };
     }
     return std::tuple<std::shared_ptr<Widget>, int>{ nullptr, INT_MAX };
 }
@@ -560,52 +720,37 @@ void InputQueue::processEvents() {
 }
 
 void InputQueue::processMouseState(const std::shared_ptr<Widget>& target) {
+    // Only widgets present in the hit test map can be hovered
+    std::vector<Rc<Widget>> chain;
     if (target) {
-        std::set<Widget*> parents;
         target->bubble([&](Widget* w) BRISK_INLINE_LAMBDA -> bool {
-            parents.insert(w);
+            if (w->m_hitTestable)
+                chain.push_back(w->shared_from_this());
             return true;
         });
+    }
 
-        for (const HitTestMap::HitTestEntry& entry : hitTest.list) {
-            // All parents are sorted after their children,
-            // so hover events are processed in child-parent order,
-            // which is the correct behavior.
-
-            if (Rc<Widget> ww = entry.widget.lock()) {
-                if (parents.find(ww.get()) != parents.end()) {
-                    // Widget is hovered
-                    if (!(ww->m_state && WidgetState::Hover)) {
-                        ww->toggleState(WidgetState::Hover, true);
-                        EventMouseEntered e;
-                        static_cast<EventMouse&>(e) = *lastMouseEvent;
-                        ww->processTemporaryEvent(Event(e));
-                    }
-                } else {
-                    if ((ww->m_state && WidgetState::Hover)) {
-                        ww->toggleState(WidgetState::Hover, false);
-                        EventMouseExited e;
-                        static_cast<EventMouse&>(e) = *lastMouseEvent;
-                        ww->processTemporaryEvent(Event(e));
-                    }
-                }
-            }
+    // Both chains are in child-parent order, so hover events are processed in that order too
+    std::vector<std::weak_ptr<Widget>> previous = std::exchange(hovered, {});
+    for (const std::weak_ptr<Widget>& weak : previous) {
+        Rc<Widget> ww = weak.lock();
+        if (!ww || std::find(chain.begin(), chain.end(), ww) != chain.end())
+            continue;
+        if ((ww->m_state && WidgetState::Hover)) {
+            ww->toggleState(WidgetState::Hover, false);
+            EventMouseExited e;
+            static_cast<EventMouse&>(e) = *lastMouseEvent;
+            ww->processTemporaryEvent(Event(e));
         }
-    } else {
-        for (const HitTestMap::HitTestEntry& entry : hitTest.list) {
-            // All parents are sorted after their children,
-            // so hover events are processed in child-parent order,
-            // which is the correct behavior.
-
-            if (Rc<Widget> ww = entry.widget.lock()) {
-                if ((ww->m_state && WidgetState::Hover)) {
-                    ww->toggleState(WidgetState::Hover, false);
-                    EventMouseExited e;
-                    static_cast<EventMouse&>(e) = *lastMouseEvent;
-                    ww->processTemporaryEvent(Event(e));
-                }
-            }
+    }
+    for (const Rc<Widget>& ww : chain) {
+        if (!(ww->m_state && WidgetState::Hover)) {
+            ww->toggleState(WidgetState::Hover, true);
+            EventMouseEntered e;
+            static_cast<EventMouse&>(e) = *lastMouseEvent;
+            ww->processTemporaryEvent(Event(e));
         }
+        hovered.push_back(ww);
     }
 }
 
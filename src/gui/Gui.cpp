@@ -30,6 +30,7 @@
 #include <yoga/algorithm/BoundAxis.h>
 #include <brisk/gui/WidgetTree.hpp>
 #include <brisk/core/Resources.hpp>
+#include <atomic>
 
 namespace Brisk {
 
@@ -39,6 +40,29 @@ namespace yoga               = facebook::yoga;
 
 namespace Internal {
 
+namespace {
+
+// Tail of a block allocated by Widget::operator new. The block holds the widget followed by the slots of its
+// layout node and its control block, and goes back to its pool once all three are freed. Weak references
+// may keep the control block, and with it the block, alive after the widget is destroyed.
+struct WidgetBlock {
+    Rc<SizeClassPool> pool;
+    size_t widgetSize;
+    std::atomic<uint32_t> refs{ 1 };
+    bool layoutUsed = false;
+    bool pending    = true;
+};
+
+// Precedes every slot, null for slots allocated on their own
+struct alignas(std::max_align_t) SlotHeader {
+    WidgetBlock* block;
+};
+
+void* layoutNodeAlloc(size_t size);
+void layoutNodeFree(void* ptr, size_t size) noexcept;
+
+} // namespace
+
 class LayoutEngine final : public yoga::Node, public yoga::Style {
 public:
     friend class Brisk::Widget;
@@ -47,6 +71,14 @@ public:
 
     LayoutEngine(Widget* widget) noexcept : m_widget(widget) {}
 
+    static void* operator new(size_t sz) {
+        return layoutNodeAlloc(sz);
+    }
+
+    static void operator delete(void* ptr, size_t sz) noexcept {
+        layoutNodeFree(ptr, sz);
+    }
+
     yoga::LayoutResults m_layoutResults{};
     int16_t m_layoutLineIndex = 0;
     bool m_hasNewLayout : 1   = false;
@@ -434,6 +466,151 @@ private:
 
     Widget* m_widget;
 };
+
+namespace {
+
+constexpr size_t widgetPoolClasses     = 128;
+constexpr size_t widgetPoolMaxRetained = 32 * 1024 * 1024;
+constexpr size_t controlSlotSize       = 8 * sizeof(void*);
+
+static_assert(alignof(LayoutEngine) <= alignof(SlotHeader));
+
+// Offsets of the slots and of the tail within a block
+struct BlockLayout {
+    size_t layout;
+    size_t control;
+    size_t tail;
+    size_t total;
+};
+
+constexpr BlockLayout blockLayout(size_t widgetSize) noexcept {
+    BlockLayout result;
+    result.layout  = alignUp(widgetSize, alignof(SlotHeader)) + sizeof(SlotHeader);
+    result.control = alignUp(result.layout + sizeof(LayoutEngine), alignof(SlotHeader)) + sizeof(SlotHeader);
+    result.tail    = alignUp(result.control + controlSlotSize, alignof(WidgetBlock));
+    result.total   = result.tail + sizeof(WidgetBlock);
+    return result;
+}
+
+Rc<SizeClassPool>& globalWidgetPool() {
+    // Never destroyed, widgets may outlive static destructors
+    static Rc<SizeClassPool>* pool = new Rc<SizeClassPool>(makeWidgetPool());
+    return *pool;
+}
+
+thread_local Rc<SizeClassPool> currentWidgetPool;
+
+// Blocks whose widget has not got its control block yet, newest last
+thread_local std::vector<WidgetBlock*> pendingBlocks;
+
+uint8_t* blockStart(WidgetBlock* block) noexcept {
+    return reinterpret_cast<uint8_t*>(block) - blockLayout(block->widgetSize).tail;
+}
+
+void unpend(WidgetBlock* block) noexcept {
+    if (block->pending) {
+        block->pending = false;
+        std::erase(pendingBlocks, block);
+    }
+}
+
+void releaseBlock(WidgetBlock* block) noexcept {
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    uint8_t* start         = blockStart(block);
+    const size_t total     = blockLayout(block->widgetSize).total;
+    Rc<SizeClassPool> pool = std::move(block->pool);
+    block->~WidgetBlock();
+    pool->deallocate(start, total);
+}
+
+void* blockSlot(WidgetBlock* block, size_t offset) noexcept {
+    block->refs.fetch_add(1, std::memory_order_relaxed);
+    return blockStart(block) + offset;
+}
+
+void* standaloneSlot(size_t size) {
+    uint8_t* ptr = static_cast<uint8_t*>(globalWidgetPool()->allocate(sizeof(SlotHeader) + size));
+    new (ptr) SlotHeader{ nullptr };
+    return ptr + sizeof(SlotHeader);
+}
+
+void freeSlot(void* ptr, size_t size) noexcept {
+    SlotHeader* header = reinterpret_cast<SlotHeader*>(static_cast<uint8_t*>(ptr) - sizeof(SlotHeader));
+    if (header->block)
+        releaseBlock(header->block);
+    else
+        globalWidgetPool()->deallocate(header, sizeof(SlotHeader) + size);
+}
+
+void* layoutNodeAlloc(size_t size) {
+    // The layout node is created by the constructor of the innermost widget under construction
+    for (auto it = pendingBlocks.rbegin(); it != pendingBlocks.rend(); ++it) {
+        if (!(*it)->layoutUsed) {
+            (*it)->layoutUsed = true;
+            return blockSlot(*it, blockLayout((*it)->widgetSize).layout);
+        }
+    }
+    return standaloneSlot(size);
+}
+
+void layoutNodeFree(void* ptr, size_t size) noexcept {
+    freeSlot(ptr, size);
+}
+
+void* widgetAlloc(size_t size) {
+    const BlockLayout layout = blockLayout(size);
+    Rc<SizeClassPool> pool   = currentWidgetPool ? currentWidgetPool : globalWidgetPool();
+    uint8_t* start           = static_cast<uint8_t*>(pool->allocate(layout.total));
+    WidgetBlock* block       = new (start + layout.tail) WidgetBlock{ pool, size };
+    new (start + layout.layout - sizeof(SlotHeader)) SlotHeader{ block };
+    new (start + layout.control - sizeof(SlotHeader)) SlotHeader{ block };
+    try {
+        pendingBlocks.push_back(block);
+    } catch (...) {
+        block->~WidgetBlock();
+        pool->deallocate(start, layout.total);
+        throw;
+    }
+    return start;
+}
+
+void widgetFree(void* ptr, size_t size) noexcept {
+    WidgetBlock* block = reinterpret_cast<WidgetBlock*>(static_cast<uint8_t*>(ptr) + blockLayout(size).tail);
+    unpend(block);
+    releaseBlock(block);
+}
+
+} // namespace
+
+Rc<SizeClassPool> makeWidgetPool() {
+    return std::make_shared<SizeClassPool>(cacheAlignment, widgetPoolClasses, widgetPoolMaxRetained);
+}
+
+WidgetPoolScope::WidgetPoolScope(Rc<SizeClassPool> pool) noexcept
+    : m_previous(std::exchange(currentWidgetPool, std::move(pool))) {}
+
+WidgetPoolScope::~WidgetPoolScope() {
+    currentWidgetPool = std::move(m_previous);
+}
+
+void* controlBlockAlloc(const void* owner, size_t size) {
+    for (auto it = pendingBlocks.rbegin(); it != pendingBlocks.rend(); ++it) {
+        WidgetBlock* block   = *it;
+        const uint8_t* start = blockStart(block);
+        if (owner >= start && owner < start + block->widgetSize) {
+            unpend(block);
+            if (size <= controlSlotSize)
+                return blockSlot(block, blockLayout(block->widgetSize).control);
+            break;
+        }
+    }
+    return standaloneSlot(size);
+}
+
+void controlBlockFree(void* ptr, size_t size) noexcept {
+    freeSlot(ptr, size);
+}
 } // namespace Internal
 
 void Widget::Iterator::operator++() {
@@ -539,12 +716,12 @@ void Widget::requestRestyle() {
     }
 }
 
-void Widget::requestStateRestyle() {
+void Widget::requestStateRestyle(WidgetState changed) {
     if (m_stateTriggersRestyle) {
         requestRestyle();
     } else {
         if (m_reapplyStyle)
-            m_reapplyStyle(this);
+            m_reapplyStyle(this, changed);
     }
 }
 
@@ -627,7 +804,7 @@ Widget::~Widget() noexcept {
 }
 
 void Widget::removeFromGroup(WidgetGroup* group) {
-    m_groups.erase(group);
+    std::erase(m_groups, group);
 }
 
 void Widget::resetSelection() {
@@ -735,136 +912,153 @@ void Widget::computeClipRect() {
 }
 
 void Widget::prepareHint() {
-    if (m_hint.empty()) {
-        m_hintPrepared = {};
+    const std::string& text = hint.get();
+    if (text.empty()) {
+        m_hintLayout.reset();
         return;
     }
-    Font font      = Font{ Font::DefaultPlusIconsEmoji, dp(FontSize::Normal - 1) };
-    m_hintPrepared = fonts->prepare(font, m_hint);
+    Font font        = Font{ Font::DefaultPlusIconsEmoji, dp(FontSize::Normal - 1) };
+    HintLayout& hint = m_hintLayout.emplace();
+    hint.prepared    = fonts->prepare(font, text);
 }
 
 void Widget::computeHintRect() {
-    if (m_hintPrepared.lines.empty()) {
-        m_hintRect = {};
+    if (!m_hintLayout)
+        return;
+    HintLayout& hint = *m_hintLayout;
+    if (hint.prepared.lines.empty()) {
+        hint.rect = {};
         return;
     }
-    Size textSize = m_hintPrepared.bounds().size();
+    Size textSize = hint.prepared.bounds().size();
     Point p       = m_rect.at(0.5f, 1.f);
-    m_hintRect    = p.alignedRect(textSize + Size{ 12_idp, 6_idp }, { 0.5f, 0.f });
-    if (m_tree && !m_tree->viewportRectangle().empty() && !m_hint.empty()) {
-        Size textSize          = m_hintPrepared.bounds().size();
+    hint.rect     = p.alignedRect(textSize + Size{ 12_idp, 6_idp }, { 0.5f, 0.f });
+    if (m_tree && !m_tree->viewportRectangle().empty() && !this->hint.get().empty()) {
+        Size textSize          = hint.prepared.bounds().size();
         Rectangle boundingRect = m_tree->viewportRectangle();
 
         Point p                = m_rect.at(0.5f, 1.f);
-        if (m_hintRect.y2 > boundingRect.y2) {
-            p          = m_rect.at(0.5f, 0.f);
-            m_hintRect = p.alignedRect(textSize + Size{ 12_idp, 6_idp }, { 0.5f, 1.f });
+        if (hint.rect.y2 > boundingRect.y2) {
+            p         = m_rect.at(0.5f, 0.f);
+            hint.rect = p.alignedRect(textSize + Size{ 12_idp, 6_idp }, { 0.5f, 1.f });
         }
 
-        if (m_hintRect.x1 < boundingRect.x1)
-            m_hintRect.applyOffset(boundingRect.x1 - m_hintRect.x1, 0);
-        if (m_hintRect.x2 > boundingRect.x2)
-            m_hintRect.applyOffset(boundingRect.x2 - m_hintRect.x2, 0);
-        m_hintRect.x2 = std::min(m_hintRect.x2, boundingRect.x2);
+        if (hint.rect.x1 < boundingRect.x1)
+            hint.rect.applyOffset(boundingRect.x1 - hint.rect.x1, 0);
+        if (hint.rect.x2 > boundingRect.x2)
+            hint.rect.applyOffset(boundingRect.x2 - hint.rect.x2, 0);
+        hint.rect.x2 = std::min(hint.rect.x2, boundingRect.x2);
 
-        if (m_hintRect.y2 > boundingRect.y2)
-            m_hintRect.applyOffset(0, boundingRect.y2 - m_hintRect.y2);
-        if (m_hintRect.y1 < boundingRect.y1)
-            m_hintRect.applyOffset(0, boundingRect.y1 - m_hintRect.y1);
-        m_hintRect.y2 = std::min(m_hintRect.y2, boundingRect.y2);
+        if (hint.rect.y2 > boundingRect.y2)
+            hint.rect.applyOffset(0, boundingRect.y2 - hint.rect.y2);
+        if (hint.rect.y1 < boundingRect.y1)
+            hint.rect.applyOffset(0, boundingRect.y1 - hint.rect.y1);
+        hint.rect.y2 = std::min(hint.rect.y2, boundingRect.y2);
     }
-    m_hintTextOffset = m_hintPrepared.alignLines(0.5f, 0.5f);
+    hint.textOffset = hint.prepared.alignLines(0.5f, 0.5f);
 }
 
 /// Returns the number of changes
-int32_t Widget::applyLayoutRecursively(RectangleF rectangle) {
-    int32_t counter                = 0;
+int32_t Widget::applyLayoutRecursively(RectangleF rectangle, LayoutStat& stat) {
+    int32_t counter = 0;
+    ++stat.visited;
 
     m_layoutEngine->m_hasNewLayout = false;
     if (!m_hasLayout) {
         counter += m_previouslyHasLayout != m_hasLayout ? 1 : 0;
         m_previouslyHasLayout = m_hasLayout;
+        stat.changed += counter;
         return counter;
     }
-    m_previouslyHasLayout = m_hasLayout;
-    auto& layout          = m_layoutEngine->getLayout();
+    m_previouslyHasLayout       = m_hasLayout;
+    auto& layout                = m_layoutEngine->getLayout();
+    const Rectangle oldRect     = m_rect;
+    const Rectangle oldClipRect = m_clipRect;
     RectangleF rect;
-    if (true || m_layoutEngine->m_hasNewLayout) {
-        SizeF dimensions{ layout.dimension(yoga::Dimension::Width),
-                          layout.dimension(yoga::Dimension::Height) };
-        PointF newOffset;
-        Size viewportSize = this->viewportSize();
-        ResolveParameters params{ resolveFontHeight(), viewportSize };
-        if (m_placement != Placement::Normal) {
-            RectangleF referenceRectangle =
-                m_placement == Placement::Window ? RectangleF{ PointF(0, 0), viewportSize } : rectangle;
-            PointF parent_anchor =
-                resolveValue(m_absolutePosition, PointF{}, PointF(SizeF(referenceRectangle.size())), params);
-            PointF self_anchor = resolveValue(m_anchor, PointF{}, PointF(dimensions), params);
-            newOffset          = referenceRectangle.p1 + parent_anchor - self_anchor;
+    SizeF dimensions{ layout.dimension(yoga::Dimension::Width),
+                      layout.dimension(yoga::Dimension::Height) };
+    PointF newOffset;
+    Size viewportSize = this->viewportSize();
+    ResolveParameters params{ resolveFontHeight(), viewportSize };
+    if (m_placement != Placement::Normal) {
+        RectangleF referenceRectangle =
+            m_placement == Placement::Window ? RectangleF{ PointF(0, 0), viewportSize } : rectangle;
+        PointF parent_anchor = resolveValue(absolutePosition.get(), PointF{},
+                                            PointF(SizeF(referenceRectangle.size())), params);
+        PointF self_anchor   = resolveValue(anchor.get(), PointF{}, PointF(dimensions), params);
+        newOffset          = referenceRectangle.p1 + parent_anchor - self_anchor;
 
-        } else {
-            newOffset = rectangle.p1 + PointF(layout.position(yoga::PhysicalEdge::Left),
-                                              layout.position(yoga::PhysicalEdge::Top));
-        }
-        PointF translate = resolveValue(m_translate, PointF(), PointF(dimensions), params);
-        newOffset += translate;
-
-        if (m_alignToViewport && AlignToViewport::X) {
-            if (newOffset.x < 0) {
-                newOffset.x = 0;
-            } else if (newOffset.x + dimensions.x > viewportSize.x) {
-                newOffset.x = viewportSize.x - dimensions.x;
-            }
-        }
-        if (m_alignToViewport && AlignToViewport::Y) {
-            if (newOffset.y < 0) {
-                newOffset.y = 0;
-            } else if (newOffset.y + dimensions.y > viewportSize.y) {
-                newOffset.y = viewportSize.y - dimensions.y;
-            }
-        }
+    } else {
+        newOffset = rectangle.p1 + PointF(layout.position(yoga::PhysicalEdge::Left),
+                                          layout.position(yoga::PhysicalEdge::Top));
+    }
+    newOffset += resolveValue(translate.get(), PointF(), PointF(dimensions), params);
 
-        rect.x1 = newOffset.x;
-        rect.y1 = newOffset.y;
-        rect.x2 = rect.x1 + dimensions.x;
-        rect.y2 = rect.y1 + dimensions.y;
-        if (assign(m_rect, roundRect(rect))) {
-            ++counter;
-        }
-        if (assign(m_computedBorderWidth, m_layoutEngine->computedBorder())) {
-            ++counter;
+    if (m_alignToViewport && AlignToViewport::X) {
+        if (newOffset.x < 0) {
+            newOffset.x = 0;
+        } else if (newOffset.x + dimensions.x > viewportSize.x) {
+            newOffset.x = viewportSize.x - dimensions.x;
         }
-        if (assign(m_computedPadding, m_layoutEngine->computedPadding())) {
-            ++counter;
-        }
-        if (assign(m_computedMargin, m_layoutEngine->computedMargin())) {
-            ++counter;
-        }
-        if (assign(m_clientRect,
-                   roundRect(rect.withPadding(m_computedBorderWidth).withPadding(m_computedPadding)))) {
-            ++counter;
+    }
+    if (m_alignToViewport && AlignToViewport::Y) {
+        if (newOffset.y < 0) {
+            newOffset.y = 0;
+        } else if (newOffset.y + dimensions.y > viewportSize.y) {
+            newOffset.y = viewportSize.y - dimensions.y;
         }
-    } else {
-        rect = m_rect;
+    }
+
+    rect.x1 = newOffset.x;
+    rect.y1 = newOffset.y;
+    rect.x2 = rect.x1 + dimensions.x;
+    rect.y2 = rect.y1 + dimensions.y;
+    if (assign(m_rect, roundRect(rect))) {
+        ++counter;
+    }
+    if (assign(m_computedBorderWidth, m_layoutEngine->computedBorder())) {
+        ++counter;
+    }
+    if (assign(m_computedPadding, m_layoutEngine->computedPadding())) {
+        ++counter;
+    }
+    if (assign(m_computedMargin, m_layoutEngine->computedMargin())) {
+        ++counter;
+    }
+    if (assign(m_clientRect,
+               roundRect(rect.withPadding(m_computedBorderWidth).withPadding(m_computedPadding)))) {
+        ++counter;
     }
     Point bottomRight{ INT_MIN, INT_MIN };
     RectangleF rectOffset = rect.withOffset(m_childrenOffset);
     computeClipRect();
     computeHintRect();
+    if (counter)
+        ++stat.changed;
 
-    m_subtreeRect = fullPaintRect();
+    // Children that yoga did not lay out again keep their geometry relative to this widget. They are
+    // skipped if this widget is unchanged and only translated if it moved without resizing
+    const Point moved    = m_rect.p1 - oldRect.p1;
+    const bool onlyMoved = m_rect.size() == oldRect.size() &&
+                           (oldClipRect == noClipRect ? m_clipRect == noClipRect
+                                                      : m_clipRect == oldClipRect.withOffset(moved));
+
+    m_subtreeRect        = fullPaintRect();
 
     for (const Ptr& w : *this) {
-        if (w->m_ignoreChildrenOffset) {
-            counter += w->applyLayoutRecursively(rect);
-            if (w->m_placement == Placement::Normal)
-                bottomRight = max(bottomRight, w->m_rect.p2);
+        if (onlyMoved && !w->m_layoutEngine->m_hasNewLayout && w->m_hasLayout &&
+            w->m_placement == Placement::Normal) {
+            if (moved != Point{}) {
+                w->reposition(moved);
+                ++counter;
+                ++stat.changed;
+            }
         } else {
-            counter += w->applyLayoutRecursively(rectOffset);
-            if (w->m_placement == Placement::Normal)
-                bottomRight = max(bottomRight, w->m_rect.p2 - m_childrenOffset);
+            counter += w->applyLayoutRecursively(w->m_ignoreChildrenOffset ? rect : rectOffset, stat);
         }
+        if (w->m_placement == Placement::Normal)
+            bottomRight = max(bottomRight, w->m_ignoreChildrenOffset ? w->m_rect.p2
+                                                                     : w->m_rect.p2 - m_childrenOffset);
         if (w->m_visible)
             m_subtreeRect = m_subtreeRect.union_(w->m_subtreeRect);
     }
@@ -899,7 +1093,8 @@ void Widget::reposition(Point relativeOffset) {
     m_rect        = m_rect.withOffset(relativeOffset);
     m_clientRect  = m_clientRect.withOffset(relativeOffset);
     m_subtreeRect = m_subtreeRect.withOffset(relativeOffset);
-    m_hintRect    = m_hintRect.withOffset(relativeOffset);
+    if (m_hintLayout)
+        m_hintLayout->rect = m_hintLayout->rect.withOffset(relativeOffset);
     computeClipRect();
     computeHintRect();
     for (const Ptr& w : *this) {
@@ -912,7 +1107,7 @@ void Widget::reposition(Point relativeOffset) {
 static void showDebugBorder(Canvas& canvas, Rectangle rect, double elapsed, ColorW color);
 
 void Widget::doRefresh() {
-    if (m_autoHint && !m_isHintVisible && !m_hint.empty() && m_hoverTime >= 0.0 &&
+    if (m_autoHint && !m_isHintVisible && !hint.get().empty() && m_hoverTime >= 0.0 &&
         frameStartTime - m_hoverTime >= 0.6) {
         m_isHintVisible = true;
         invalidate();
@@ -932,20 +1127,56 @@ void Widget::refreshTree() {
         });
 }
 
-void Widget::markTreeDirty() {
-    m_layoutEngine->setDirty(true);
+static bool isViewportRelative(Length value) noexcept {
+    switch (value.unit()) {
+    case LengthUnit::Vw:
+    case LengthUnit::Vh:
+    case LengthUnit::Vmin:
+    case LengthUnit::Vmax:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool Widget::dependsOnViewport() const noexcept {
+    if (m_placement == Placement::Window || m_alignToViewport != AlignToViewport::None)
+        return true;
+    const PointL position    = absolutePosition.get();
+    const PointL selfAnchor  = anchor.get();
+    const PointL translation = translate.get();
+    const Length lengths[]   = {
+        m_width,           m_height,          m_minWidth,        m_minHeight,      m_maxWidth,
+        m_maxHeight,       m_flexBasis,       m_gapColumn,       m_gapRow,         m_marginLeft,
+        m_marginTop,       m_marginRight,     m_marginBottom,    m_paddingLeft,    m_paddingTop,
+        m_paddingRight,    m_paddingBottom,   m_borderWidthLeft, m_borderWidthTop, m_borderWidthRight,
+        m_borderWidthBottom, position.x,      position.y,        selfAnchor.x,     selfAnchor.y,
+        translation.x,     translation.y,
+    };
+    return std::any_of(std::begin(lengths), std::end(lengths), &isViewportRelative);
+}
+
+void Widget::markViewportDependentDirty() {
+    // Percentages are resolved by yoga against the parent and are handled by its cache when the root
+    // size changes. Only widgets that read the viewport size directly have to be laid out again.
+    if (dependsOnViewport())
+        requestUpdateLayout();
     for (const Ptr& w : *this) {
-        w->markTreeDirty();
+        w->markViewportDependentDirty();
     }
 }
 
 void Widget::updateLayout(Rectangle rectangle, bool viewportChanged) {
     // Called by widget tree for the root widget only
     if (viewportChanged)
-        markTreeDirty();
+        markViewportDependentDirty();
     if (yoga::calculateLayout(m_layoutEngine.get(), rectangle.width(), rectangle.height(),
                               yoga::Direction::LTR)) {
-        if (applyLayoutRecursively(rectangle)) {
+        LayoutStat stat;
+        int32_t changes = applyLayoutRecursively(rectangle, stat);
+        if (m_tree)
+            m_tree->m_layoutStat = stat;
+        if (changes) {
             if (m_tree) {
                 m_tree->onLayoutUpdated();
                 m_tree->requestUpdateGeometry();
@@ -1022,7 +1253,8 @@ void Widget::apply(WidgetGroup* group) {
     BRISK_ASSERT(group);
 
     group->widgets.push_back(this);
-    m_groups.insert(group);
+    if (std::find(m_groups.begin(), m_groups.end(), group) == m_groups.end())
+        m_groups.push_back(group);
 
     if (m_tree) {
         m_tree->addGroup(group);
@@ -1179,7 +1411,7 @@ void Widget::doPaint(Canvas& canvas) const {
 
     canvas.setScissor(m_clipRect);
     bool needsPaint = !m_tree || m_tree->isDirty(adjustedRect()) ||
-                      (!m_hintRect.empty() && m_tree->isDirty(adjustedHintRect()));
+                      (!hintRect().empty() && m_tree->isDirty(adjustedHintRect()));
     if (needsPaint) {
         if (m_painter)
             m_painter.paint(canvas, *this);
@@ -1234,18 +1466,20 @@ void Widget::paintFocusFrame(Canvas& canvas) const {
 }
 
 void Widget::paintHint(Canvas& canvas) const {
-    if ((m_isHintExclusive || isHintCurrent()) && !m_hintPrepared.lines.empty() && m_tree &&
-        m_isHintVisible) {
+    if ((m_isHintExclusive || isHintCurrent()) && m_hintLayout && !m_hintLayout->prepared.lines.empty() &&
+        m_tree && m_isHintVisible) {
         m_tree->requestLayer([this](Canvas& canvas) {
-            SizeF textSize     = m_hintPrepared.bounds().size();
-            ColorW color       = getStyleVar<ColorW>(hintBackgroundColor.id).value_or(Palette::white);
-            ColorW shadowColor = getStyleVar<ColorW>(hintShadowColor.id).value_or(Palette::black);
+            if (!m_hintLayout)
+                return;
+            const HintLayout& hint = *m_hintLayout;
+            ColorW color           = getStyleVar<ColorW>(hintBackgroundColor.id).value_or(Palette::white);
+            ColorW shadowColor     = getStyleVar<ColorW>(hintShadowColor.id).value_or(Palette::black);
             canvas.setFillColor(shadowColor);
-            canvas.blurRect(m_hintRect, dp(hintShadowSize), 4._dp, m_squircleCorners);
+            canvas.blurRect(hint.rect, dp(hintShadowSize), 4._dp, m_squircleCorners);
             canvas.setFillColor(color);
-            canvas.fillRect(m_hintRect, 5._dp, m_squircleCorners);
+            canvas.fillRect(hint.rect, 5._dp, m_squircleCorners);
             canvas.setFillColor(getStyleVar<ColorW>(hintTextColor.id).value_or(Palette::black));
-            canvas.fillText(m_hintRect.center() + m_hintTextOffset, m_hintPrepared);
+            canvas.fillText(hint.rect.center() + hint.textOffset, hint.prepared);
         });
     }
 }
@@ -1458,6 +1692,8 @@ void Widget::updateGeometry(HitTestMap::State& state) {
         state.mouseTransparent = false;
     else if (m_mouseInteraction == MouseInteraction::Disable)
         state.mouseTransparent = true;
+    // Set again below if the widget gets an entry in the hit test map
+    m_hitTestable = false;
 
     if (auto inputQueue = this->inputQueue()) {
         if (m_focusCapture && state.visible) {
@@ -1475,9 +1711,10 @@ void Widget::updateGeometry(HitTestMap::State& state) {
         if (m_tabGroup) {
             ++inputQueue->hitTest.tabGroupId;
         }
-        if (state.visible && !state.mouseTransparent)
-            inputQueue->hitTest.add(self, InputShape{ m_rect, getBorderRadiusResolved(), m_clipRect },
-                                    m_mouseAnywhere, state.zindex);
+        if (state.visible && !state.mouseTransparent) {
+            InputShape shape{ m_rect, getBorderRadiusResolved(), m_clipRect };
+            m_hitTestable = inputQueue->hitTest.add(self, shape, m_mouseAnywhere, state.zindex);
+        }
     }
 
     for (const Ptr& w : *this) {
@@ -1492,9 +1729,8 @@ void Widget::updateGeometry(HitTestMap::State& state) {
                 if (scrollSize(orientation) <= 0)
                     continue;
                 ScrollBarGeometry geometry = scrollBarGeometry(orientation);
-                if (!geometry.track.empty()) {
-                    inputQueue->hitTest.add(self, geometry.track, false, state.zindex);
-                }
+                if (inputQueue->hitTest.add(self, geometry.track, false, state.zindex))
+                    m_hitTestable = true;
             }
         }
 
@@ -1696,7 +1932,7 @@ void Widget::setState(WidgetState newState) {
 }
 
 void Widget::stateChanged(WidgetState oldState, WidgetState newState) {
-    requestStateRestyle();
+    requestStateRestyle(oldState ^ newState);
     if (hasScrollBar(Orientation::Horizontal) || hasScrollBar(Orientation::Vertical)) {
         invalidate();
     }
@@ -1831,7 +2067,7 @@ void Widget::resolveAndInherit() {
 
 float Widget::propResolve(const Internal::GuiProp<Widget, Internal::Resolve>* prop, Length value) const {
     if (isInherited(prop->id()) && m_parent) {
-        return (m_parent->*(prop->field)).current;
+        return prop->current(m_parent);
     }
 
     float resolvedFontHeight;
@@ -1863,9 +2099,11 @@ float Widget::propResolve(const Internal::GuiProp<Widget, Internal::Resolve>* pr
 
 // Returns true if resolved value has been changed
 bool Widget::resolveProperty(const Internal::GuiProp<Widget, Internal::Resolve>* prop) {
-    Internal::Resolve& value = (this->*(prop->field));
-    float resolved           = propResolve(prop, value.value);
-    bool changed             = assign(value.current, resolved);
+    Internal::Resolve* value = prop->find(this);
+    if (!value) // Sparse property that has not been set, resolved on every read
+        return false;
+    float resolved = propResolve(prop, value->value);
+    bool changed   = assign(value->current, resolved);
 
     if (changed) {
         requestUpdates(prop->flags);
@@ -1961,6 +2199,15 @@ Rc<Widget> Widget::clone() const {
     return result;
 }
 
+void* Widget::operator new(size_t sz) {
+    return registerInstance(Internal::widgetAlloc(sz), sz);
+}
+
+void Widget::operator delete(void* ptr, size_t sz) {
+    unregisterInstance(ptr);
+    Internal::widgetFree(ptr, sz);
+}
+
 Widget::Widget(const Widget&) = default;
 
 Widget::Widget(Construction construction) : m_layoutEngine{ this } {
@@ -2030,7 +2277,8 @@ void Widget::setTree(WidgetTree* tree) {
             m_tree->detach(this);
             detachedFromTree();
         }
-        m_tree = tree;
+        m_hitTestable = false;
+        m_tree        = tree;
         if (m_tree) {
             m_tree->attach(this);
             attachedToTree();
@@ -2602,21 +2850,21 @@ Rectangle Widget::fullPaintRect() const {
 }
 
 Rectangle Widget::hintRect() const noexcept {
-    return m_hintRect;
+    return m_hintLayout ? m_hintLayout->rect : Rectangle{};
 }
 
 Rectangle Widget::adjustedRect() const noexcept {
-    float shadowSize = m_shadowSize.current;
+    float size = shadowSize.current();
     if (isKeyFocused()) {
-        shadowSize = std::max(shadowSize, dp(focusFrameRange.max));
+        size = std::max(size, dp(focusFrameRange.max));
     }
-    return adjustForShadowSize(m_rect, shadowSize, scalePixels(m_shadowOffset.current),
-                               scalePixels(m_shadowSpread.current));
+    return adjustForShadowSize(m_rect, size, scalePixels(shadowOffset.current()),
+                               scalePixels(shadowSpread.current()));
 }
 
 Rectangle Widget::adjustedHintRect() const noexcept {
-    return adjustForShadowSize(m_hintRect, dp(hintShadowSize), scalePixels(m_shadowOffset.current),
-                               scalePixels(m_shadowSpread.current));
+    return adjustForShadowSize(hintRect(), dp(hintShadowSize), scalePixels(shadowOffset.current()),
+                               scalePixels(shadowSpread.current()));
 }
 
 Nullable<InputQueue> Widget::inputQueue() const noexcept {
@@ -2794,12 +3042,14 @@ Widget::properties() noexcept {
         /* 3 */
         Internal::PropGetterSetter{ &This::m_state, &This::isSelected, &This::setSelected, "selected" },
         /* 4 */
-        Internal::GuiProp{ &Widget::m_absolutePosition, { undef, undef }, AffectLayout, "absolutePosition" },
+        Internal::GuiProp{ Internal::sparseField<PointL, 5>(), { undef, undef }, AffectLayout,
+                           "absolutePosition" },
         /* 5 */
         Internal::GuiProp{ &Widget::m_alignContent, AlignContent::FlexStart, AffectLayout, "alignContent" },
         /* 6 */ Internal::GuiProp{ &Widget::m_alignItems, AlignItems::Stretch, AffectLayout, "alignItems" },
         /* 7 */ Internal::GuiProp{ &Widget::m_alignSelf, AlignSelf::Auto, AffectLayout, "alignSelf" },
-        /* 8 */ Internal::GuiProp{ &Widget::m_anchor, { undef, undef }, AffectLayout, "anchor" },
+        /* 8 */
+        Internal::GuiProp{ Internal::sparseField<PointL, 6>(), { undef, undef }, AffectLayout, "anchor" },
         /* 9 */ Internal::GuiProp{ &Widget::m_aspect, undef, AffectLayout, "aspect" },
         /* 10 */ 10,
         /* 11 */
@@ -2815,7 +3065,9 @@ Widget::properties() noexcept {
         /* 18 */ 18,
         /* 19 */
         Internal::GuiProp{ &Widget::m_color, Palette::white, AffectPaint, "color" },
-        /* 20 */ Internal::GuiProp{ &Widget::m_shadowOffset, PointF{ 0, 0 }, AffectPaint, "shadowOffset" },
+        /* 20 */
+        Internal::GuiProp{ Internal::sparseField<Animated<PointF>, 0>(), PointF{ 0, 0 }, AffectPaint,
+                           "shadowOffset" },
         /* 21 */ Internal::GuiProp{ &Widget::m_cursor, Cursor::NotSet, None, "cursor" },
         /* 22 */ Internal::GuiProp{ &Widget::m_flexBasis, auto_, AffectLayout, "flexBasis" },
         /* 23 */ Internal::GuiProp{ &Widget::m_flexGrow, undef, AffectLayout, "flexGrow" },
@@ -2848,14 +3100,15 @@ Widget::properties() noexcept {
         /* 35 */ Internal::GuiProp{ &Widget::m_opacity, 1.f, AffectPaint, "opacity" },
         /* 36 */ Internal::GuiProp{ &Widget::m_placement, Placement::Normal, AffectLayout, "placement" },
         /* 37 */
-        Internal::GuiProp{ &Widget::m_shadowSize, 0_px, AffectPaint | RelativeToHalfShortestSide,
-                           "shadowSize" },
+        Internal::GuiProp{ Internal::sparseField<Internal::Resolve, 1>(), 0_px,
+                           AffectPaint | RelativeToHalfShortestSide, "shadowSize" },
         /* 38 */
-        Internal::GuiProp{ &Widget::m_shadowColor, 0x000000'AA_rgba, AffectPaint, "shadowColor" },
+        Internal::GuiProp{ Internal::sparseField<Animated<ColorW>, 2>(), 0x000000'AA_rgba, AffectPaint,
+                           "shadowColor" },
         /* 39 */ 39,
         /* 40 */ 40,
         /* 41 */
-        Internal::GuiProp{ &Widget::m_tabSize, 40_px,
+        Internal::GuiProp{ Internal::sparseField<Internal::Resolve, 8>(), 40_px,
                            AffectLayout | AffectFont | AffectPaint | RelativeToFontSize, "tabSize" },
         /* 42 */
         Internal::GuiProp{ &Widget::m_textAlign, TextAlign::Start, AffectPaint, "textAlign" },
@@ -2865,7 +3118,8 @@ Widget::properties() noexcept {
         /* 44 */
         Internal::GuiProp{ &Widget::m_textDecoration, TextDecoration::None, AffectFont | AffectPaint,
                            "textDecoration" },
-        /* 45 */ Internal::GuiProp{ &Widget::m_translate, { 0, 0 }, AffectLayout, "translate" },
+        /* 45 */
+        Internal::GuiProp{ Internal::sparseField<PointL, 7>(), { 0, 0 }, AffectLayout, "translate" },
         /* 46 */ Internal::GuiProp{ &Widget::m_visible, true, AffectLayout | AffectVisibility, "visible" },
         /* 47 */
         Internal::GuiProp{ &Widget::m_wordSpacing, 0_px,
@@ -2895,7 +3149,9 @@ Widget::properties() noexcept {
         /* 65 */
         Internal::GuiProp{ &Widget::m_squircleCorners, false, AffectPaint, "squircleCorners" },
         /* 66 */ Internal::GuiProp{ &Widget::m_delegate, nullptr, None, "delegate" },
-        /* 67 */ Internal::GuiProp{ &Widget::m_hint, {}, AffectLayout | AffectPaint | AffectHint, "hint" },
+        /* 67 */
+        Internal::GuiProp{ Internal::sparseField<std::string, 3>(), {},
+                           AffectLayout | AffectPaint | AffectHint, "hint" },
         /* 68 */ Internal::PropFieldNotify{ &Widget::m_stylesheet, &Widget::requestRestyle, "stylesheet" },
         /* 69 */ Internal::PropFieldNotify{ &Widget::m_painter, &Widget::invalidate, "painter" },
         /* 70 */ Internal::GuiProp{ &Widget::m_isHintExclusive, false, None, "isHintExclusive" },
@@ -2910,7 +3166,8 @@ Widget::properties() noexcept {
         /* 74 */
         Internal::GuiProp{ &Widget::m_scrollBarRadius, 0_px, AffectPaint | RelativeToShortestSide,
                            "scrollBarRadius" },
-        /* 75 */ Internal::GuiProp{ &Widget::m_shadowSpread, 0, AffectPaint, "shadowSpread" },
+        /* 75 */
+        Internal::GuiProp{ Internal::sparseField<Animated<float>, 4>(), 0, AffectPaint, "shadowSpread" },
         /* 76 */
         Internal::GuiProp{ &Widget::m_borderRadiusTopLeft, 0_px, AffectPaint | RelativeToShortestSide,
                            "borderRadiusTopLeft" },
@@ -2978,6 +3235,10 @@ Widget::properties() noexcept {
         Internal::GuiPropCompound<Widget, SizeOf, ContentOverflow, ContentOverflow, 102, 103>{
             "contentOverflow" },
     };
+    constexpr bool sparseValid = props.apply([](const auto&... prop) {
+        return (Internal::sparseInitialValueSupported(prop) && ...);
+    });
+    static_assert(sparseValid, "Sparse properties can't have an initial value function");
     return props;
 }
 } // namespace Brisk
@@ -193,6 +193,11 @@ bool GuiWindow::update() {
     if (m_tree.layoutCounter() != layoutCounter && m_tree.root()) {
         updateWindowLimits();
     }
+    if (uint32_t glyphGeneration = fonts->glyphGeneration(); glyphGeneration != m_glyphGeneration) {
+        // Replace placeholders of color glyphs rasterized in the background
+        m_glyphGeneration = glyphGeneration;
+        m_tree.invalidateRect(m_tree.viewportRectangle());
+    }
     return !m_tree.paintRect().empty();
 }
 
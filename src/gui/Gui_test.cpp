@@ -21,7 +21,404 @@
 #include <catch2/catch_all.hpp>
 #include "Catch2Utils.hpp"
 #include <brisk/gui/Gui.hpp>
+#include <brisk/core/System.hpp>
+#include <random>
 
 using namespace Brisk;
 
 TEST_CASE("Widget constructors") {}
+
+TEST_CASE("Layout skips unchanged subtrees") {
+    WidgetTree tree;
+    tree.disableTransitions();
+    pixelRatio() = 1.f;
+    tree.setViewportRectangle({ 0, 0, 1000, 1000 });
+
+    Rc<Widget> root = rcnew Widget{ layout = Layout::Vertical };
+    for (int i = 0; i < 50; ++i) {
+        Rc<Widget> row = rcnew Widget{ layout = Layout::Horizontal };
+        for (int j = 0; j < 10; ++j) {
+            row->apply(rcnew Widget{ width = 10, height = 10 });
+        }
+        root->apply(row);
+    }
+    tree.setRoot(root);
+    tree.update();
+
+    Rc<Widget> lastLeaf = root->widgets().back()->widgets().back();
+    Rectangle lastRect  = lastLeaf->rect();
+    CHECK(lastRect == Rectangle{ 90, 490, 100, 500 });
+
+    root->widgets().front()->widgets().front()->height = 20;
+    tree.update();
+    // The rows are laid out again, but only the leaves of the first row
+    CHECK(tree.layoutStat().visited <= 1 + 50 + 10);
+    CHECK(lastLeaf->rect() == lastRect.withOffset(0, 10));
+}
+
+namespace {
+class MeasureCounter final : public Widget {
+public:
+    mutable int measured = 0;
+
+    MeasureCounter() : Widget{ Construction{ "measurecounter" }, nullptr } {
+        enableCustomMeasure();
+        endConstruction();
+    }
+
+    SizeF measure(AvailableSize size) const override {
+        ++measured;
+        return { 10.f, 10.f };
+    }
+};
+} // namespace
+
+TEST_CASE("Viewport change relayouts viewport-relative widgets only") {
+    WidgetTree tree;
+    tree.disableTransitions();
+    pixelRatio() = 1.f;
+    tree.setViewportRectangle({ 0, 0, 1000, 1000 });
+
+    Rc<MeasureCounter> counter = rcnew MeasureCounter();
+    Rc<Widget> relative        = rcnew Widget{ width = 50_vw, height = 10 };
+    Rc<Widget> root            = rcnew Widget{
+        layout = Layout::Vertical,
+        rcnew Widget{ width = 100, height = 100, counter },
+        relative,
+    };
+    tree.setRoot(root);
+    tree.update();
+    CHECK(relative->rect().width() == 500);
+    int measured = counter->measured;
+    CHECK(measured > 0);
+
+    tree.setViewportRectangle({ 0, 0, 600, 1000 });
+    tree.update();
+    CHECK(relative->rect().width() == 300);
+    // The fixed-size subtree keeps its cached layout
+    CHECK(counter->measured == measured);
+}
+
+namespace {
+class HoverLogger final : public Widget {
+public:
+    std::vector<std::string>* log;
+
+    HoverLogger(std::string name, std::vector<std::string>* log, Rc<Widget> child = nullptr)
+        : Widget{ Construction{ "hoverlogger" },
+                  std::tuple{ Arg::id = name, Arg::width = 100, Arg::height = 50 } },
+          log(log) {
+        if (child)
+            apply(std::move(child));
+        endConstruction();
+    }
+
+    void onEvent(Event& event) override {
+        if (event.type() == EventType::MouseEntered)
+            log->push_back("+" + id.get());
+        else if (event.type() == EventType::MouseExited)
+            log->push_back("-" + id.get());
+        Widget::onEvent(event);
+    }
+};
+} // namespace
+
+TEST_CASE("Hover follows the widget chain under the mouse") {
+    InputQueue inputQueue;
+    WidgetTree tree(&inputQueue);
+    tree.disableTransitions();
+    pixelRatio() = 1.f;
+    tree.setViewportRectangle({ 0, 0, 1000, 1000 });
+
+    std::vector<std::string> log;
+    Rc<Widget> inner = rcnew HoverLogger("inner", &log);
+    Rc<Widget> outer = rcnew HoverLogger("outer", &log, inner);
+    Rc<Widget> other = rcnew HoverLogger("other", &log);
+    Rc<Widget> root  = rcnew Widget{ layout = Layout::Vertical, outer, other };
+    tree.setRoot(root);
+    tree.update();
+
+    auto moveTo = [&](PointF point) {
+        inputQueue.setLastMouseEvent(EventMouseMoved{ { { {}, KeyModifiers::None }, point, std::nullopt } });
+        inputQueue.processMouseState();
+    };
+
+    moveTo({ 10, 10 });
+    CHECK(log == std::vector<std::string>{ "+inner", "+outer" });
+    CHECK(inner->isHovered());
+    CHECK(outer->isHovered());
+    CHECK(root->isHovered());
+
+    log.clear();
+    moveTo({ 20, 20 });
+    CHECK(log.empty());
+
+    log.clear();
+    moveTo({ 10, 60 });
+    CHECK(log == std::vector<std::string>{ "-inner", "-outer", "+other" });
+    CHECK(!inner->isHovered());
+    CHECK(other->isHovered());
+    CHECK(root->isHovered());
+
+    log.clear();
+    inputQueue.mouseLeave();
+    CHECK(log == std::vector<std::string>{ "-other" });
+    CHECK(!root->isHovered());
+
+    // A zero-size widget has no hit test entry, so it isn't hovered through its overflowing child
+    log.clear();
+    Rc<Widget> child   = rcnew HoverLogger("child", &log);
+    Rc<Widget> wrapper = rcnew HoverLogger("wrapper", &log, child);
+    wrapper->width     = 0;
+    wrapper->height    = 0;
+    wrapper->clip      = WidgetClip::None;
+    root->apply(wrapper);
+    tree.update();
+    moveTo({ 10, 110 });
+    CHECK(log == std::vector<std::string>{ "+child" });
+    CHECK(child->isHovered());
+    CHECK(!wrapper->isHovered());
+
+    // Removed widgets are no longer hit testable
+    log.clear();
+    root->remove(wrapper.get());
+    tree.update();
+    moveTo({ 10, 110 });
+    CHECK(log == std::vector<std::string>{ "-child" });
+    CHECK(!child->isHovered());
+}
+
+TEST_CASE("InputQueue merges mouse moves and wheel events") {
+    InputQueue inputQueue;
+    auto move = [&](PointF point, std::optional<PointF> downPoint = std::nullopt) {
+        inputQueue.addEvent(EventMouseMoved{ { { {}, KeyModifiers::None }, point, downPoint } });
+    };
+    move({ 1, 1 });
+    move({ 2, 2 });
+    move({ 3, 3 });
+    inputQueue.addEvent(EventMouseYWheel{ { { {}, KeyModifiers::None }, { 3, 3 }, std::nullopt }, 1.f });
+    inputQueue.addEvent(EventMouseXWheel{ { { {}, KeyModifiers::None }, { 3, 3 }, std::nullopt }, 2.f });
+    inputQueue.addEvent(EventMouseYWheel{ { { {}, KeyModifiers::None }, { 3, 3 }, std::nullopt }, 1.f });
+    inputQueue.addEvent(EventMouseXWheel{ { { {}, KeyModifiers::None }, { 3, 3 }, std::nullopt }, 2.f });
+    move({ 4, 4 });
+    inputQueue.addEvent(EventMouseButtonPressed{
+        { { { {}, KeyModifiers::None }, { 4, 4 }, PointF{ 4, 4 } }, MouseButton::Left } });
+    move({ 5, 5 }, PointF{ 4, 4 });
+    move({ 6, 6 }, PointF{ 4, 4 });
+
+    REQUIRE(inputQueue.events.size() == 6);
+    auto first = inputQueue.events[0].as<EventMouseMoved>();
+    REQUIRE(first.has_value());
+    CHECK(first->point == PointF{ 3, 3 });
+    CHECK(first->coalesced == std::vector<PointF>{ { 1, 1 }, { 2, 2 } });
+    CHECK(inputQueue.events[1].as<EventMouseYWheel>()->delta == 2.f);
+    CHECK(inputQueue.events[2].as<EventMouseXWheel>()->delta == 4.f);
+    CHECK(inputQueue.events[3].as<EventMouseMoved>()->coalesced.empty());
+    CHECK(inputQueue.events[4].type() == EventType::MouseButtonPressed);
+    auto last = inputQueue.events[5].as<EventMouseMoved>();
+    REQUIRE(last.has_value());
+    CHECK(last->point == PointF{ 6, 6 });
+    CHECK(last->coalesced == std::vector<PointF>{ { 5, 5 } });
+}
+
+namespace {
+struct HitTestFixture {
+    HitTestMap map;
+    std::vector<uint32_t> reference; // list indices in the order the map used to keep them
+    std::vector<Rc<Widget>> widgets;
+
+    explicit HitTestFixture(int count) {
+        std::mt19937 rnd(1);
+        for (int i = 0; i < 16; ++i)
+            widgets.push_back(rcnew Widget{});
+        for (int i = 0; i < count; ++i) {
+            Point p{ int(rnd() % 4000), int(rnd() % 3000) };
+            Size size{ int(rnd() % 60) + 1, int(rnd() % 40) + 1 };
+            if (i % 1000 == 0)
+                size = Size{ 4000, 3000 };
+            int zindex = rnd() % 8 == 0 ? 1 : 0;
+            Rectangle clip = i % 3 == 0 ? Rectangle{ p, Size{ 20, 20 } } : noClipRect;
+            bool anywhere  = i % 5000 == 4999;
+            map.add(widgets[i % widgets.size()], InputShape{ Rectangle{ p, size }, CornersF{ 4.f }, clip },
+                    anywhere, zindex);
+            auto it = std::lower_bound(reference.begin(), reference.end(), zindex,
+                                       [&](uint32_t e, int z) {
+                                           return map.list[e].zindex < z;
+                                       });
+            reference.insert(it, i);
+        }
+    }
+
+    size_t referenceFind(Point pt, size_t from, bool anywhere) const {
+        for (size_t i = from; i < reference.size(); ++i) {
+            const HitTestMap::HitTestEntry& e = map.list[reference[i]];
+            if (e.rect.contains(pt) || (anywhere && e.anywhere))
+                return i;
+        }
+        return reference.size();
+    }
+};
+} // namespace
+
+TEST_CASE("HitTestMap") {
+    HitTestFixture fixture(20'000);
+    HitTestMap& map = fixture.map;
+    fixture.map.build();
+    for (size_t i = 0; i < map.size(); ++i) {
+        REQUIRE(&map.at(i) == &map.list[fixture.reference[i]]);
+    }
+    std::mt19937 rnd(2);
+    for (int i = 0; i < 2000; ++i) {
+        Point pt{ int(rnd() % 4200) - 100, int(rnd() % 3200) - 100 };
+        bool anywhere = i % 2;
+        size_t pos    = map.find(pt, 0, anywhere);
+        CHECK(pos == fixture.referenceFind(pt, 0, anywhere));
+        if (pos < map.size()) {
+            CHECK(map.find(pt, pos + 1, anywhere) == fixture.referenceFind(pt, pos + 1, anywhere));
+        }
+    }
+
+    map.clear();
+    CHECK(map.find({ 10, 10 }, 0, true) == 0);
+    CHECK(map.get(10, 10, true) == nullptr);
+}
+
+TEST_CASE("HitTestMap benchmark", "[.benchmark]") {
+    HitTestFixture fixture(50'000);
+    std::mt19937 rnd(3);
+    const std::vector<HitTestMap::HitTestEntry> entries = fixture.map.list;
+    BENCHMARK("build 50k") {
+        // Re-add the same entries so that every sample builds the index for exactly 50k entries
+        fixture.map.clear();
+        for (const HitTestMap::HitTestEntry& e : entries) {
+            fixture.map.add(e.widget.lock(), e.rect, e.anywhere, e.zindex);
+        }
+        fixture.map.build();
+        return fixture.map.size();
+    };
+    BENCHMARK("get 50k") {
+        return fixture.map.get(float(rnd() % 4000), float(rnd() % 3000), false);
+    };
+}
+
+TEST_CASE("Widget memory is recycled") {
+    Rc<Widget> w        = rcnew Widget{ opacity = 0.5f, hidden = true };
+    const Widget* first = w.get();
+    w.reset();
+    w = rcnew Widget{};
+    CHECK(w.get() == first);
+    CHECK(w->opacity.get() == 1.f);
+    CHECK(!w->hidden.get());
+
+    w->selected      = true;
+    Rc<Widget> clone = w->clone();
+    CHECK(clone.get() != w.get());
+    CHECK(clone->selected.get());
+}
+
+TEST_CASE("Widget shares its memory block with the layout node and control block") {
+    Rc<Internal::SizeClassPool> pool = Internal::makeWidgetPool();
+    {
+        Internal::WidgetPoolScope scope(pool);
+        Rc<Widget> w = rcnew Widget{ rcnew Widget{} };
+        CHECK(pool->stat().numBlocks == 2);
+
+        WeakRc<Widget> weak = w;
+        w.reset();
+        // The control block keeps the block of the outer widget
+        CHECK(pool->stat().numBlocks == 1);
+        weak.reset();
+        CHECK(pool->stat().numBlocks == 0);
+    }
+    Rc<Widget> w = rcnew Widget{};
+    CHECK(pool->stat().numBlocks == 0);
+}
+
+TEST_CASE("Widgets built during update come from the pool of the tree") {
+    WidgetTree tree;
+    tree.setViewportRectangle({ 0, 0, 100, 100 });
+    Rc<Widget> root = rcnew Widget{
+        Builder{
+            [](Widget* target) {
+                target->apply(rcnew Widget{});
+            },
+        },
+    };
+    CHECK(tree.widgetPool()->stat().numBlocks == 0);
+    tree.setRoot(root);
+    tree.update();
+    REQUIRE(root->widgets().size() == 1);
+    CHECK(tree.widgetPool()->stat().numBlocks == 1);
+}
+
+TEST_CASE("Sparse widget properties") {
+    Rc<Widget> w = rcnew Widget{};
+    CHECK(w->shadowColor.get() == 0x000000'AA_rgba);
+    CHECK(w->tabSize.get() == 40_px);
+    CHECK(w->hint.get() == "");
+    CHECK(w->absolutePosition.get() == PointL{ undef, undef });
+
+    int hintChanged   = 0;
+    int shadowChanged = 0;
+    bindings->listen(Value{ &w->hint }, [&hintChanged]() {
+        ++hintChanged;
+    });
+    bindings->listen(Value{ &w->shadowColor }, [&shadowChanged]() {
+        ++shadowChanged;
+    });
+
+    w->hint = "";
+    CHECK(hintChanged == 0);
+    w->hint = "tooltip";
+    CHECK(hintChanged == 1);
+    // Each sparse property has its own binding address
+    CHECK(shadowChanged == 0);
+    w->shadowColor = Palette::red;
+    w->shadowSize  = 4_px;
+    CHECK(shadowChanged == 1);
+    CHECK(hintChanged == 1);
+    CHECK(w->hint.get() == "tooltip");
+    CHECK(w->shadowColor.get() == Palette::red);
+    CHECK(w->shadowSize.get() == 4_px);
+    CHECK(w->shadowSpread.get() == 0.f);
+
+    Rc<Widget> clone = w->clone();
+    w->hint          = "changed";
+    CHECK(clone->hint.get() == "tooltip");
+    CHECK(clone->shadowColor.get() == Palette::red);
+    CHECK(clone->shadowSize.get() == 4_px);
+}
+
+TEST_CASE("Widget memory benchmark", "[.benchmark]") {
+    constexpr int count   = 50'000;
+    const uint64_t before = memoryInfo().maxrss;
+    Rc<Widget> root       = rcnew Widget{ layout = Layout::Vertical };
+    for (int i = 0; i < count / 100; ++i) {
+        Rc<Widget> row = rcnew Widget{ layout = Layout::Horizontal };
+        for (int j = 0; j < 99; ++j) {
+            row->apply(rcnew Widget{ width = 10, height = 10 });
+        }
+        root->apply(std::move(row));
+    }
+    const uint64_t after = memoryInfo().maxrss;
+    fmt::print("sizeof(Widget) = {} bytes, resident memory per widget = {} bytes\n", sizeof(Widget),
+               (after - before) * 1024 / count);
+
+    BENCHMARK("traverse 50k widgets") {
+        int visible = 0;
+        for (const Rc<Widget>& row : *root) {
+            for (const Rc<Widget>& w : *row) {
+                visible += w->visible.get();
+            }
+        }
+        return visible;
+    };
+
+    BENCHMARK("rebuild 1k widgets") {
+        Rc<Widget> row = rcnew Widget{ layout = Layout::Horizontal };
+        for (int j = 0; j < 1000; ++j) {
+            row->apply(rcnew Widget{ width = 10, height = 10 });
+        }
+        return row->widgets().size();
+    };
+}
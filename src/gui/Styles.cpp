@@ -19,6 +19,7 @@
  * license. For commercial licensing options, please visit: https://brisklib.com
  */
 #include <brisk/gui/Styles.hpp>
+#include <atomic>
 
 namespace Brisk {
 
@@ -63,24 +64,151 @@ void Rules::applyTo(Widget* widget) const {
     }
 }
 
+size_t Stylesheet::MatchedStylesHash::operator()(const MatchedStyles& styles) const noexcept {
+    return fastHash(toBytesView(styles));
+}
+
+const Stylesheet::Index& Stylesheet::index() const {
+    if (m_index.generation != 0 && m_index.data == data() && m_index.size == size())
+        return m_index;
+    static std::atomic<uint64_t> generations{ 0 };
+    m_index.data       = data();
+    m_index.size       = size();
+    m_index.generation = ++generations;
+    m_index.unkeyed.clear();
+    for (auto& keyed : m_index.keyed) {
+        keyed.clear();
+    }
+    for (uint32_t i = 0; i < size(); ++i) {
+        Selectors::IndexKey key = (*this)[i].selector.indexKey();
+        if (key.kind == Selectors::IndexKey::Kind::None)
+            m_index.unkeyed.push_back(i);
+        else
+            m_index.keyed[to_underlying(key.kind)][std::string(key.value)].push_back(i);
+    }
+    return m_index;
+}
+
+void Stylesheet::invalidate() noexcept {
+    m_index.generation = 0;
+}
+
+void Stylesheet::validateMergedRules() const {
+    // Merged rules point into the inherited stylesheets too, so a change of any of them drops the cache
+    const size_t count = inherited.size() + 1;
+    bool changed       = m_mergedGenerations.size() != count;
+    m_mergedGenerations.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Stylesheet& ss      = i < inherited.size() ? *inherited[i] : *this;
+        const uint64_t generation = ss.index().generation;
+        if (m_mergedGenerations[i] != generation) {
+            m_mergedGenerations[i] = generation;
+            changed                = true;
+        }
+    }
+    if (changed)
+        m_mergedRules.clear();
+}
+
 void Stylesheet::stylize(Widget* widget, bool isRoot) const {
-    Rules rules;
+    MatchedStyles matched;
     for (const auto& ss : inherited) {
         BRISK_ASSERT(ss);
-        ss->stylizeInternal(rules, widget, isRoot);
+        ss->matchStyles(matched, widget, isRoot);
     }
-    stylizeInternal(rules, widget, isRoot);
-    rules.applyTo(widget);
-    widget->m_reapplyStyle = [rules = std::move(rules)](Widget* self) {
-        rules.applyTo(self);
+    matchStyles(matched, widget, isRoot);
+    validateMergedRules();
+    Rc<const MergedRules> merged = mergedRules(matched);
+    merged->rules.applyTo(widget);
+    widget->m_reapplyStyle = [merged = std::move(merged)](Widget* self, WidgetState changed) {
+        merged->applyStateChange(self, changed);
     };
 }
 
-void Stylesheet::stylizeInternal(Rules& rules, Widget* widget, bool isRoot) const {
-    for (const Style& style : *this) {
+void Stylesheet::matchStyles(MatchedStyles& matched, Widget* widget, bool isRoot) const {
+    using Kind          = Selectors::IndexKey::Kind;
+    const Index& index = this->index();
+    std::vector<uint32_t> candidates(index.unkeyed);
+    auto addBucket = [&](Kind kind, std::string_view value) BRISK_INLINE_LAMBDA {
+        const auto& keyed = index.keyed[to_underlying(kind)];
+        if (keyed.empty())
+            return;
+        if (auto it = keyed.find(value); it != keyed.end())
+            candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    };
+    addBucket(Kind::Type, widget->type());
+    addBucket(Kind::Id, widget->id.get());
+    addBucket(Kind::Role, widget->role.get());
+    for (const std::string& className : widget->classes.get()) {
+        addBucket(Kind::Class, className);
+    }
+    // Later styles override earlier ones, so keep the stylesheet order
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (uint32_t i : candidates) {
+        const Style& style = (*this)[i];
         if (style.selector.matches(widget, isRoot ? MatchFlags::IsRoot : MatchFlags::None)) {
-            rules.merge(style.rules);
+            matched.push_back(&style);
         }
     }
 }
+
+Stylesheet::MergedRules::MergedRules(Rules rules) : rules(std::move(rules)) {
+    // Rules are sorted by property name, so the rules of each property are adjacent
+    const std::vector<Rule>& list = this->rules.rules;
+    for (uint32_t first = 0; first < list.size();) {
+        uint32_t last      = first;
+        WidgetState states = WidgetState::None;
+        for (; last < list.size() && list[last].name() == list[first].name(); ++last) {
+            states |= list[last].state();
+        }
+        if (states != WidgetState::None) {
+            stateGroups.push_back({ first, last, states });
+        } else {
+            for (uint32_t i = first; i < last; ++i) {
+                if (list[i].isFunction())
+                    functionRules.push_back(i);
+            }
+        }
+        first = last;
+    }
+}
+
+void Stylesheet::MergedRules::applyStateChange(Widget* widget, WidgetState changed) const {
+    if (changed && WidgetState::ForcePressed)
+        changed |= WidgetState::Pressed; // rules for Pressed also apply to ForcePressed
+    Widget::StyleApplying styleApplying;
+    bool applied = false;
+    for (const StateGroup& group : stateGroups) {
+        if ((group.states & changed) == WidgetState::None)
+            continue;
+        for (uint32_t i = group.first; i < group.last; ++i) {
+            rules.rules[i].applyTo(widget);
+        }
+        applied = true;
+    }
+    if (!applied)
+        return;
+    // Style variables may have changed, so functions reading them are evaluated again
+    for (uint32_t i : functionRules) {
+        rules.rules[i].applyTo(widget);
+    }
+}
+
+Rc<const Stylesheet::MergedRules> Stylesheet::mergedRules(const MatchedStyles& matched) const {
+    if (auto it = m_mergedRules.find(matched); it != m_mergedRules.end())
+        return it->second;
+    // Distinct sets of matching styles are few in practice, this only guards against unbounded growth
+    constexpr size_t maxMergedRules = 4096;
+    if (m_mergedRules.size() >= maxMergedRules)
+        m_mergedRules.clear();
+    Rules rules;
+    for (const Style* style : matched) {
+        rules.merge(style->rules);
+    }
+    Rc<const MergedRules> result = std::make_shared<const MergedRules>(std::move(rules));
+    m_mergedRules.emplace(matched, result);
+    return result;
+}
 } // namespace Brisk
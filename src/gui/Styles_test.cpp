@@ -79,6 +79,7 @@ public:
     using W::m_height;
     using W::m_type;
     using W::m_width;
+    using W::requestRestyle;
     using W::resolveProperties;
     using W::restyleIfRequested;
     using W::setState;
@@ -426,6 +427,91 @@ TEST_CASE("Stylesheet with inheritance") {
     CHECK(w2->widgets().front()->backgroundColor.get() == Palette::transparent);
 }
 
+TEST_CASE("Stylesheet changes drop the merged rules") {
+    using namespace Selectors;
+    Rc<Stylesheet> base = rcnew Stylesheet{
+        Style{
+            Id{ "A" },
+            { color = Palette::red },
+        },
+    };
+    Rc<Stylesheet> derived = rcnew Stylesheet{
+        base,
+        Style{
+            Type{ "widget" },
+            { backgroundColor = Palette::blue },
+        },
+    };
+    Rc<Widget> w = rcnew Widget{ stylesheet = derived, id = "A" };
+    auto restyle = [&]() {
+        unprotect(w)->requestRestyle();
+        unprotect(w)->restyleIfRequested();
+    };
+    restyle();
+    CHECK(w->color.get() == Palette::red);
+    CHECK(w->backgroundColor.get() == Palette::blue);
+
+    // A style added to the inherited stylesheet
+    base->push_back(Style{ Id{ "A" }, { color = Palette::green } });
+    restyle();
+    CHECK(w->color.get() == Palette::green);
+
+    // Styles modified in place
+    base->front().rules = Rules{ color = Palette::yellow };
+    base->back().rules  = Rules{ borderWidth = 2_px };
+    base->invalidate();
+    restyle();
+    CHECK(w->color.get() == Palette::yellow);
+    CHECK(w->borderWidth.get() == EdgesL{ 2_px });
+}
+
+TEST_CASE("Stylesheet index keeps style order") {
+    using namespace Selectors;
+    CHECK(Brisk::Selector{ Type{ "button" } }.indexKey().kind == IndexKey::Kind::Type);
+    CHECK(Brisk::Selector{ Type{ "button" } && Id{ "ok" } }.indexKey().value == "ok");
+    CHECK(Brisk::Selector{ Parent{ Id{ "ok" } } && Class{ "text" } }.indexKey().value == "text");
+    CHECK(Brisk::Selector{ Type{ "button" } || Id{ "ok" } }.indexKey().kind == IndexKey::Kind::None);
+
+    Rc<const Stylesheet> stylesheet = rcnew Stylesheet{
+        Style{
+            Class{ "warning" },
+            Rules{ color = Palette::yellow, shadowSize = 1 },
+        },
+        Style{
+            Type{ Widget::widgetType },
+            Rules{ color = Palette::green },
+        },
+        Style{
+            Universal{},
+            Rules{ shadowSize = 2 },
+        },
+        Style{
+            Parent{ Id{ "list" } } && Class{ "warning" },
+            Rules{ color = Palette::red },
+        },
+    };
+
+    Rc<Widget> w = rcnew Widget{
+        Arg::stylesheet = stylesheet,
+        id              = "list",
+        rcnew Widget{ classes = { "warning" } },
+        rcnew Widget{ classes = { "warning" } },
+        rcnew Widget{
+            rcnew Widget{ classes = { "warning" } },
+        },
+    };
+    unprotect(w)->restyleIfRequested();
+    CHECK(w->color.get() == ColorW(Palette::green));
+    CHECK(w->shadowSize.get() == 2_px);
+    for (int i = 0; i < 2; ++i) {
+        CHECK(w->widgets()[i]->color.get() == ColorW(Palette::red));
+        CHECK(w->widgets()[i]->shadowSize.get() == 2_px);
+    }
+    Rc<Widget> nested = w->widgets()[2]->widgets().front();
+    CHECK(nested->color.get() == ColorW(Palette::green));
+    CHECK(nested->shadowSize.get() == 2_px);
+}
+
 TEST_CASE("Style with states") {
     using namespace Selectors;
     using enum WidgetState;
@@ -452,6 +538,75 @@ TEST_CASE("Style with states") {
     CHECK(w1->widgets().front()->color.get() == ColorW(Palette::red));
 }
 
+TEST_CASE("State change reapplies state-dependent rules") {
+    using namespace Selectors;
+    using enum WidgetState;
+    Rc<const Stylesheet> stylesheet = rcnew Stylesheet{
+        Style{
+            Universal{},
+            Rules{
+                shadowSize                = 1,
+                color                     = Palette::white,
+                color | Hover             = Palette::yellow,
+                backgroundColor           = Palette::black,
+                backgroundColor | Pressed = Palette::red,
+            },
+        },
+    };
+
+    Rc<Widget> w = rcnew Widget{ Arg::stylesheet = stylesheet };
+    unprotect(w)->restyleIfRequested();
+    CHECK(w->color.get() == ColorW(Palette::white));
+    CHECK(w->shadowSize.get() == 1_px);
+
+    unprotect(w)->toggleState(Hover, true);
+    CHECK(w->color.get() == ColorW(Palette::yellow));
+    CHECK(w->backgroundColor.get() == ColorW(Palette::black));
+
+    unprotect(w)->toggleState(ForcePressed, true);
+    CHECK(w->backgroundColor.get() == ColorW(Palette::red));
+    CHECK(w->color.get() == ColorW(Palette::yellow));
+
+    unprotect(w)->toggleState(Hover | ForcePressed, false);
+    CHECK(w->color.get() == ColorW(Palette::white));
+    CHECK(w->backgroundColor.get() == ColorW(Palette::black));
+    CHECK(w->shadowSize.get() == 1_px);
+
+    // Stateless properties changed after styling keep their values
+    w->shadowSize = 5;
+    unprotect(w)->toggleState(Hover, true);
+    CHECK(w->shadowSize.get() == 5_px);
+    CHECK(w->color.get() == ColorW(Palette::yellow));
+}
+
+TEST_CASE("State change reevaluates function rules") {
+    using namespace Selectors;
+    using enum WidgetState;
+    Rc<const Stylesheet> stylesheet = rcnew Stylesheet{
+        Style{
+            Universal{},
+            Rules{
+                backgroundColor         = Palette::black,
+                backgroundColor | Hover = Palette::white,
+                // Stateless, but reads a property that depends on the state
+                color                   = textColorFor([](Widget* w) {
+                    return w->backgroundColor.get();
+                }),
+            },
+        },
+    };
+
+    Rc<Widget> w = rcnew Widget{ Arg::stylesheet = stylesheet };
+    unprotect(w)->restyleIfRequested();
+    CHECK(w->color.get() == ColorW(Palette::white));
+
+    unprotect(w)->toggleState(Hover, true);
+    CHECK(w->color.get() == ColorW(Palette::black));
+
+    unprotect(w)->toggleState(Hover, false);
+    CHECK(w->color.get() == ColorW(Palette::white));
+}
+
 class Derived : public Widget {
     BRISK_DYNAMIC_CLASS(Derived, Widget)
 public:
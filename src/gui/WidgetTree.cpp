@@ -29,6 +29,11 @@ void WidgetGroup::clean() {
     }
 }
 
+void WidgetGroup::remove(Widget* widget) {
+    std::erase(widgets, widget);
+    widget->removeFromGroup(this);
+}
+
 void WidgetTree::setRoot(std::shared_ptr<Widget> root) {
     if (root != m_root) {
         if (m_root) {
@@ -88,6 +93,10 @@ uint32_t WidgetTree::layoutCounter() const noexcept {
     return m_layoutCounter;
 }
 
+LayoutStat WidgetTree::layoutStat() const noexcept {
+    return m_layoutStat;
+}
+
 std::shared_ptr<Widget> WidgetTree::root() const noexcept {
     return m_root;
 }
@@ -136,6 +145,9 @@ void WidgetTree::disableRealtimeMode() {
 }
 
 void WidgetTree::update() {
+    // Widgets built by rebuilds and event handlers reuse the memory of the ones they replace
+    Internal::WidgetPoolScope poolScope(m_widgetPool);
+
     if (m_realtime)
         bindings->assign(frameStartTime, currentTime());
 
@@ -155,6 +167,10 @@ void WidgetTree::update() {
     m_layoutIsActual = true;
 }
 
+const Rc<Internal::SizeClassPool>& WidgetTree::widgetPool() const noexcept {
+    return m_widgetPool;
+}
+
 void WidgetTree::processEventsAndAnimations() {
     if (m_layoutIsActual) {
         if (m_inputQueue)
@@ -195,6 +211,7 @@ void WidgetTree::updateLayoutAndGeometry() {
         m_root->updateGeometry(state);
         m_updateGeometryRequested = false;
         if (m_inputQueue) {
+            m_inputQueue->hitTest.build();
             m_inputQueue->processMouseState();
         }
     }
@@ -310,7 +327,8 @@ Nullable<InputQueue> WidgetTree::inputQueue() const {
     return m_inputQueue;
 }
 
-WidgetTree::WidgetTree(InputQueue* inputQueue) noexcept : m_inputQueue(inputQueue) {}
+WidgetTree::WidgetTree(InputQueue* inputQueue)
+    : m_inputQueue(inputQueue), m_widgetPool(Internal::makeWidgetPool()) {}
 
 WidgetTree::~WidgetTree() {
     m_root.reset();
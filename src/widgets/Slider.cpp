@@ -92,7 +92,7 @@ void Slider::onEvent(Event& event) {
             normalizedValue = std::clamp(newValue, 0.f, 1.f);
             startModifying();
             if (m_hintFormatter)
-                m_hint = m_hintFormatter(m_value);
+                hint = m_hintFormatter(m_value);
             event.stopPropagation();
             break;
         case DragEvent::Dropped:
@@ -33,15 +33,7 @@ void Table::childrenChanged() {
     Widget::childrenChanged();
     for (const Rc<Widget>& w1 : *this) {
         if (TableRow* row = dynamicCast<TableRow*>(w1.get())) {
-            int i = 0;
-            for (const Rc<Widget>& w2 : *row) {
-                if (TableCell* cell = dynamicCast<TableCell*>(w2.get())) {
-                    if (!cell->m_widthGroupSet && i < columns.size()) {
-                        cell->apply(&columns[i++]);
-                        cell->m_widthGroupSet = true;
-                    }
-                }
-            }
+            row->bindColumns(columns);
         }
     }
 }
@@ -60,6 +52,30 @@ TableRow::TableRow(Construction construction, ArgumentsView<TableRow> args)
 
 Rc<Widget> TableRow::cloneThis() const { BRISK_CLONE_IMPLEMENTATION }
 
+void TableRow::bindColumns(std::span<WidthGroup> columns) {
+    int i = 0;
+    for (const Rc<Widget>& w : *this) {
+        if (TableCell* cell = dynamicCast<TableCell*>(w.get())) {
+            if (!cell->m_widthGroupSet && i < columns.size()) {
+                cell->apply(&columns[i++]);
+                cell->m_widthGroupSet = true;
+            }
+        }
+    }
+}
+
+void TableRow::unbindColumns(std::span<WidthGroup> columns) {
+    int i = 0;
+    for (const Rc<Widget>& w : *this) {
+        if (TableCell* cell = dynamicCast<TableCell*>(w.get())) {
+            if (cell->m_widthGroupSet && i < columns.size()) {
+                columns[i++].remove(cell);
+                cell->m_widthGroupSet = false;
+            }
+        }
+    }
+}
+
 Rc<Widget> TableHeader::cloneThis() const { BRISK_CLONE_IMPLEMENTATION }
 
 TableHeader::TableHeader(Construction construction, ArgumentsView<TableHeader> args)
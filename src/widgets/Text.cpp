@@ -49,12 +49,23 @@ void Text::onChanged() {
         if (m_wordWrap || m_textAutoSize == TextAutoSize::None) {
             requestUpdateLayout();
         }
-        m_cache2.invalidate({ m_clientRect.width() }, true);
-    } else if (m_wordWrap) {
-        m_cache2.invalidate({ m_clientRect.width() });
+        m_cache2.invalidate({ m_clientRect.width(), textAlignment() }, true);
+    } else {
+        m_cache2.invalidate({ m_wordWrap ? m_clientRect.width() : m_cache2.key().width, textAlignment() });
+    }
+}
+
+void Text::onRefresh() {
+    // textAlign and textVerticalAlign only repaint the widget, so a changed alignment is picked up here
+    if (m_cache2.key().alignment != textAlignment()) {
+        m_cache2.invalidate({ m_cache2.key().width, textAlignment() });
     }
 }
 
+PointF Text::textAlignment() const {
+    return { toFloatAlign(m_textAlign), toFloatAlign(m_textVerticalAlign) };
+}
+
 float Text::calcFontSizeFor(const Font& font, const std::string& m_text) const {
     float fontSize          = m_fontSize.current;
     const float refFontSize = 32.f;
@@ -113,9 +124,18 @@ SizeF Text::measure(AvailableSize size) const {
 void Text::paint(Canvas& canvas) const {
     Widget::paint(canvas);
     if (m_opacity.current > 0.f) {
-        RectangleF inner = m_clientRect;
-        ColorW color     = m_color.current.multiplyAlpha(m_opacity.current);
-        auto prepared    = m_cache2->prepared;
+        RectangleF inner             = m_clientRect;
+        ColorW color                 = m_color.current.multiplyAlpha(m_opacity.current);
+        const PointF alignment       = textAlignment();
+        const PreparedText* prepared = &m_cache2->prepared;
+        PointF offset                = m_cache2->offset;
+        std::optional<PreparedText> realigned;
+        if (m_cache2.key().alignment != alignment) {
+            // Alignment changed after the last refresh
+            realigned = m_cache2->prepared;
+            offset    = realigned->alignLines(alignment);
+            prepared  = &*realigned;
+        }
 
         canvas.setFillColor(color);
         if (m_rotation != Rotation::NoRotation) {
@@ -125,16 +145,12 @@ void Text::paint(Canvas& canvas) const {
                            .translate(-rotated.center().x, -rotated.center().y)
                            .rotate90(static_cast<int>(m_rotation))
                            .translate(inner.center().x, inner.center().y);
-            PointF offset = prepared.alignLines(toFloatAlign(m_textAlign), toFloatAlign(m_textVerticalAlign));
-            auto&& state  = canvas.saveState();
+            auto&& state     = canvas.saveState();
             state->transform = m;
-            canvas.fillText(rotated.at(toFloatAlign(m_textAlign), toFloatAlign(m_textVerticalAlign)) + offset,
-                            prepared);
+            canvas.fillText(rotated.at(alignment.x, alignment.y) + offset, *prepared);
         } else {
-            PointF offset = prepared.alignLines(toFloatAlign(m_textAlign), toFloatAlign(m_textVerticalAlign));
-            prepared.updateCaretData();
-            offset += inner.at(toFloatAlign(m_textAlign), toFloatAlign(m_textVerticalAlign));
-            canvas.fillText(offset, prepared);
+            offset += inner.at(alignment.x, alignment.y);
+            canvas.fillText(offset, *prepared);
         }
     }
 }
@@ -157,7 +173,9 @@ Text::Cached2 Text::updateCache2(const CacheKey2& key) {
     auto prepared  = m_cache->shaped.wrap(m_wordWrap ? key.width : 16777216.f);
     SizeF textSize = prepared.bounds().size();
     textSize       = max(textSize, SizeF{ 0, fonts->metrics(m_cache.key().font).vertBounds() });
-    return { textSize, std::move(prepared) };
+    // Aligned once here, so that painting neither copies nor moves the glyphs
+    PointF offset  = prepared.alignLines(key.alignment);
+    return { textSize, std::move(prepared), offset };
 }
 
 void BackStrikedText::paint(Canvas& canvas) const {
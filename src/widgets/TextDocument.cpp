@@ -0,0 +1,182 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#include <brisk/widgets/TextDocument.hpp>
+#include <algorithm>
+
+namespace Brisk {
+
+// Length of the text as written by utf32ToUtf8, which replaces invalid codepoints
+static uint32_t utf8Length(std::u32string_view text) {
+    uint32_t length = 0;
+    for (char32_t ch : text) {
+        if (ch < 0x80)
+            length += 1;
+        else if (ch < 0x800)
+            length += 2;
+        else if (ch < 0x10000 || ch > 0x10FFFF)
+            length += 3;
+        else
+            length += 4;
+    }
+    return length;
+}
+
+TextDocument::TextDocument() : m_paragraphs(1), m_utf8Sizes(1, 0) {}
+
+TextDocument::TextDocument(std::u32string_view text) {
+    assign(text);
+}
+
+void TextDocument::assign(std::u32string_view text) {
+    m_paragraphs.clear();
+    for (;;) {
+        size_t lf = text.find(U'\n');
+        m_paragraphs.emplace_back(text.substr(0, lf));
+        if (lf == std::u32string_view::npos)
+            break;
+        text.remove_prefix(lf + 1);
+    }
+    m_utf8Sizes.resize(m_paragraphs.size());
+    for (size_t i = 0; i < m_paragraphs.size(); ++i) {
+        m_utf8Sizes[i] = utf8Length(m_paragraphs[i]);
+    }
+    m_size        = 0;
+    m_validStarts = 0;
+    updateStarts();
+    m_size = m_starts.back() + m_paragraphs.back().size();
+}
+
+void TextDocument::updateStarts() const {
+    if (m_validStarts >= m_paragraphs.size() && m_starts.size() == m_paragraphs.size())
+        return;
+    m_starts.resize(m_paragraphs.size());
+    m_utf8Starts.resize(m_paragraphs.size());
+    if (m_validStarts == 0) {
+        m_starts[0]     = 0;
+        m_utf8Starts[0] = 0;
+        m_validStarts   = 1;
+    }
+    for (uint32_t i = m_validStarts; i < m_paragraphs.size(); ++i) {
+        m_starts[i]     = m_starts[i - 1] + m_paragraphs[i - 1].size() + 1;
+        m_utf8Starts[i] = m_utf8Starts[i - 1] + m_utf8Sizes[i - 1] + 1;
+    }
+    m_validStarts = m_paragraphs.size();
+}
+
+uint32_t TextDocument::paragraphStart(uint32_t index) const {
+    updateStarts();
+    return m_starts[index];
+}
+
+Range<uint32_t> TextDocument::paragraphRange(uint32_t index) const {
+    uint32_t start = paragraphStart(index);
+    return { start, start + uint32_t(m_paragraphs[index].size()) };
+}
+
+uint32_t TextDocument::paragraphAt(uint32_t offset) const {
+    updateStarts();
+    return std::upper_bound(m_starts.begin(), m_starts.end(), std::min(offset, m_size)) - m_starts.begin() - 1;
+}
+
+char32_t TextDocument::at(uint32_t offset) const {
+    uint32_t index = paragraphAt(offset);
+    uint32_t local = offset - m_starts[index];
+    return local < m_paragraphs[index].size() ? m_paragraphs[index][local] : U'\n';
+}
+
+std::u32string TextDocument::text(Range<uint32_t> range) const {
+    range.max = std::min(range.max, m_size);
+    std::u32string result;
+    if (range.empty())
+        return result;
+    result.reserve(range.distance());
+    uint32_t first = paragraphAt(range.min);
+    uint32_t last  = paragraphAt(range.max);
+    for (uint32_t i = first; i <= last; ++i) {
+        uint32_t from = i == first ? range.min - m_starts[i] : 0;
+        uint32_t to   = i == last ? range.max - m_starts[i] : m_paragraphs[i].size();
+        result.append(m_paragraphs[i], from, to - from);
+        if (i != last)
+            result += U'\n';
+    }
+    return result;
+}
+
+std::u32string TextDocument::text() const {
+    return text({ 0, m_size });
+}
+
+uint32_t TextDocument::utf8Offset(uint32_t offset) const {
+    uint32_t index = paragraphAt(offset);
+    uint32_t local = std::min(offset, m_size) - m_starts[index];
+    return m_utf8Starts[index] + utf8Length(std::u32string_view(m_paragraphs[index]).substr(0, local));
+}
+
+TextDocument::Change TextDocument::replace(Range<uint32_t> range, std::u32string_view text) {
+    range.max = std::min(range.max, m_size);
+    range.min = std::min(range.min, range.max);
+
+    const uint32_t first      = paragraphAt(range.min);
+    const uint32_t last       = paragraphAt(range.max);
+    const uint32_t firstLocal = range.min - m_starts[first];
+    const uint32_t lastLocal  = range.max - m_starts[last];
+    m_size                    = m_size - range.distance() + text.size();
+
+    if (first == last && text.find(U'\n') == std::u32string_view::npos) {
+        // Typing within a paragraph
+        m_paragraphs[first].replace(firstLocal, lastLocal - firstLocal, text);
+        m_utf8Sizes[first] = utf8Length(m_paragraphs[first]);
+        m_validStarts      = std::min(m_validStarts, first + 1);
+        return { first, 1, 1 };
+    }
+
+    std::u32string suffix = m_paragraphs[last].substr(lastLocal);
+    std::vector<std::u32string> inserted;
+    inserted.emplace_back(m_paragraphs[first].substr(0, firstLocal));
+    for (char32_t ch : text) {
+        if (ch == U'\n')
+            inserted.emplace_back();
+        else
+            inserted.back() += ch;
+    }
+    inserted.back() += suffix;
+
+    m_paragraphs.erase(m_paragraphs.begin() + first, m_paragraphs.begin() + last + 1);
+    m_utf8Sizes.erase(m_utf8Sizes.begin() + first, m_utf8Sizes.begin() + last + 1);
+    m_utf8Sizes.insert(m_utf8Sizes.begin() + first, inserted.size(), 0);
+    for (size_t i = 0; i < inserted.size(); ++i) {
+        m_utf8Sizes[first + i] = utf8Length(inserted[i]);
+    }
+    m_paragraphs.insert(m_paragraphs.begin() + first, std::make_move_iterator(inserted.begin()),
+                        std::make_move_iterator(inserted.end()));
+    m_validStarts = std::min(m_validStarts, first + 1);
+    return { first, last - first + 1, uint32_t(inserted.size()) };
+}
+
+TextDocument::Change TextDocument::insert(uint32_t offset, std::u32string_view text) {
+    return replace({ offset, offset }, text);
+}
+
+TextDocument::Change TextDocument::erase(Range<uint32_t> range) {
+    return replace(range, {});
+}
+
+} // namespace Brisk
@@ -32,7 +32,13 @@
 namespace Brisk {
 
 static std::u32string normalizeCompose(std::u32string str) {
-    return str;
+    // Nothing below the combining diacritics composes with anything
+    if (std::all_of(str.begin(), str.end(), [](char32_t ch) {
+            return ch < 0x300;
+        }))
+        return str;
+    std::u32string composed = utfNormalize<char32_t>(str, UtfNormalization::NFC);
+    return composed.empty() ? str : composed;
 }
 
 TextEditor::TextEditor(Construction construction, ArgumentsView<TextEditor> args)
@@ -117,43 +123,66 @@ Range<uint32_t> TextEditor::selection() const {
 }
 
 void TextEditor::moveCursor(MoveCursor move, bool select) {
-    uint32_t oldCursor = cursor;
+    updateLayout();
+    uint32_t oldCursor           = cursor;
+    const uint32_t p             = m_document.paragraphAt(cursor);
+    const Range<uint32_t> range  = m_document.paragraphRange(p);
+    const PreparedText& prepared = m_paragraphs[p].prepared;
     using enum MoveCursor;
     switch (move) {
     case Up:
     case Down: {
-        uint32_t grapheme = m_preparedText.characterToGrapheme(cursor);
-        uint32_t line     = m_preparedText.graphemeToLine(grapheme);
-        float offsetx     = m_preparedText.caretPositions[grapheme];
-        if (line == UINT32_MAX || (line == 0 && move == Up) ||
-            (line == m_preparedText.lines.size() - 1 && move == Down))
+        uint32_t grapheme = prepared.characterToGrapheme(cursor - range.min);
+        uint32_t line     = prepared.graphemeToLine(grapheme);
+        if (line == UINT32_MAX || m_document.empty())
             break;
-        line += move == Down ? +1 : -1;
-        grapheme = m_preparedText.caretToGrapheme(line, offsetx);
-        cursor   = m_preparedText.graphemeToCharacter(grapheme);
+        float offsetx               = prepared.graphemeToCaret(grapheme).x;
+        uint32_t target             = p;
+        const PreparedText* targetText = &prepared;
+        if (move == Up && line == 0) {
+            if (p == 0)
+                break;
+            targetText = &m_paragraphs[--target].prepared;
+            line       = targetText->lines.size() - 1;
+        } else if (move == Down && line == prepared.lines.size() - 1) {
+            if (p + 1 == m_document.paragraphCount())
+                break;
+            targetText = &m_paragraphs[++target].prepared;
+            line       = 0;
+        } else {
+            line += move == Down ? +1 : -1;
+        }
+        grapheme = targetText->caretToGrapheme(line, offsetx);
+        cursor   = std::min(m_document.paragraphStart(target) + targetText->graphemeToCharacter(grapheme),
+                            m_document.paragraphRange(target).max);
         break;
     }
 
     case Right:
     case Left: {
-        uint32_t grapheme = m_preparedText.characterToGrapheme(cursor);
-        if ((grapheme == 0 && move == Left) ||
-            (grapheme == m_preparedText.graphemeBoundaries.size() - 1 && move == Right))
-            break;
-        grapheme += move == Right ? +1 : -1;
-        cursor = m_preparedText.graphemeToCharacter(grapheme);
+        uint32_t grapheme = prepared.characterToGrapheme(cursor - range.min);
+        if (move == Left) {
+            // From the start of a paragraph, move to the end of the previous one
+            cursor = grapheme == 0 ? std::max(range.min, 1u) - 1
+                                   : range.min + prepared.graphemeToCharacter(grapheme - 1);
+        } else {
+            cursor = cursor >= range.max
+                         ? std::min(range.max + 1, m_document.size())
+                         : std::min(range.min + prepared.graphemeToCharacter(grapheme + 1), range.max);
+        }
         break;
     }
 
     case LineBeginning:
     case LineEnd: {
-        uint32_t grapheme = m_preparedText.characterToGrapheme(cursor);
-        uint32_t line     = m_preparedText.graphemeToLine(grapheme);
+        uint32_t grapheme = prepared.characterToGrapheme(cursor - range.min);
+        uint32_t line     = prepared.graphemeToLine(grapheme);
         if (line == UINT32_MAX)
             break;
-        cursor = m_preparedText.graphemeToCharacter(move == LineBeginning
-                                                        ? m_preparedText.lines[line].graphemeRange.min
-                                                        : m_preparedText.lines[line].graphemeRange.max - 1);
+        cursor = std::min(range.min + prepared.graphemeToCharacter(move == LineBeginning
+                                                                      ? prepared.lines[line].graphemeRange.min
+                                                                      : prepared.lines[line].graphemeRange.max - 1),
+                          range.max);
         break;
     }
 
@@ -161,7 +190,7 @@ void TextEditor::moveCursor(MoveCursor move, bool select) {
         cursor = 0;
         break;
     case TextEnd:
-        cursor = m_cachedText.size();
+        cursor = m_document.size();
         break;
     }
 
@@ -173,40 +202,115 @@ void TextEditor::moveCursor(MoveCursor move, bool select) {
     selectionChanged();
 }
 
+void TextEditor::shapeParagraph(uint32_t index) const {
+    ParagraphLayout& layout = m_paragraphs[index];
+    std::u32string text;
+    if (m_document.empty())
+        text = utf8ToUtf32(m_placeholder);
+    else if (m_passwordChar)
+        text.assign(m_document.paragraph(index).size(), m_passwordChar);
+    else
+        text = m_document.paragraph(index);
+    layout.prepared = fonts->prepare(
+        m_cachedFont, TextWithOptions{ std::move(text), m_multiline ? TextOptions::Default : TextOptions::SingleLine });
+    std::ignore   = layout.prepared.alignLines(m_layoutAlignment);
+    // Line metrics keep the height of blank paragraphs
+    layout.height = layout.prepared.bounds().height();
+    layout.width  = layout.prepared.runs.empty() ? 0.f : layout.prepared.bounds().width();
+    layout.shaped = true;
+    m_validTops   = std::min(m_validTops, index + 1);
+}
+
+void TextEditor::updateLayout() const {
+    const uint32_t count = m_document.paragraphCount();
+    if (m_paragraphs.size() != count) {
+        m_paragraphs.assign(count, ParagraphLayout{});
+        m_validTops = 0;
+    }
+    const float alignmentX = toFloatAlign(m_textAlign);
+    const bool realign     = alignmentX != m_layoutAlignment;
+    m_layoutAlignment      = alignmentX;
+    bool reshaped          = false;
+    for (uint32_t p = 0; p < count; ++p) {
+        if (!m_paragraphs[p].shaped) {
+            shapeParagraph(p);
+            reshaped = true;
+        } else if (realign) {
+            std::ignore = m_paragraphs[p].prepared.alignLines(alignmentX);
+        }
+    }
+    if (reshaped || m_validTops < count) {
+        for (uint32_t p = m_validTops; p < count; ++p) {
+            m_paragraphs[p].top = p == 0 ? 0.f : m_paragraphs[p - 1].top + m_paragraphs[p - 1].height;
+        }
+        m_validTops          = count;
+        m_contentSize.width  = 0.f;
+        for (const ParagraphLayout& layout : m_paragraphs) {
+            m_contentSize.width = std::max(m_contentSize.width, layout.width);
+        }
+        m_contentSize.height = m_paragraphs.back().top + m_paragraphs.back().height;
+    }
+    m_alignmentOffset = Point(PointF(0.f, -m_contentSize.height * toFloatAlign(m_textVerticalAlign)));
+}
+
+float TextEditor::paragraphBaseline(uint32_t index) const {
+    const PreparedText& prepared = m_paragraphs[index].prepared;
+    return m_paragraphs[index].top + prepared.lines.front().ascDesc.ascender;
+}
+
+uint32_t TextEditor::paragraphAtY(float y) const {
+    auto it = std::upper_bound(m_paragraphs.begin(), m_paragraphs.end(), y,
+                               [](float y, const ParagraphLayout& layout) {
+                                   return y < layout.top;
+                               });
+    return it == m_paragraphs.begin() ? 0 : std::distance(m_paragraphs.begin(), it) - 1;
+}
+
 void TextEditor::paint(Canvas& canvas) const {
     paintBackground(canvas, m_rect);
-    Font font                  = this->font();
-
-    std::u32string placeholder = utf8ToUtf32(this->m_placeholder);
-    bool isPlaceholder         = m_text.empty();
+    updateLayout();
+    bool isPlaceholder        = m_text.empty();
 
-    Range<uint32_t> selection  = this->selection();
-    selection.min              = std::clamp(selection.min, 0u, (uint32_t)m_cachedText.size());
-    selection.max              = std::clamp(selection.max, 0u, (uint32_t)m_cachedText.size());
+    Range<uint32_t> selection = this->selection();
+    selection.min             = std::clamp(selection.min, 0u, m_document.size());
+    selection.max             = std::clamp(selection.max, 0u, m_document.size());
 
     PointF alignment{ toFloatAlign(m_textAlign), toFloatAlign(m_textVerticalAlign) };
 
-    ColorW textColor  = m_color.current;
-    m_alignmentOffset = m_preparedText.alignLines(alignment);
+    ColorW textColor = m_color.current;
     if (isPlaceholder)
         textColor = textColor.multiplyAlpha(0.5f);
-
-    canvas.setFillColor(ColorW(Palette::Standard::indigo).multiplyAlpha(isFocused() ? 0.85f : 0.5f));
-    Point pos = m_clientRect.at(alignment) + Point(m_alignmentOffset - m_visibleOffset);
-    canvas.fillTextSelection(pos, m_preparedText, selection);
-    canvas.setFillColor(textColor);
-    canvas.fillText(pos, m_preparedText);
+    ColorW selectionColor = ColorW(Palette::Standard::indigo).multiplyAlpha(isFocused() ? 0.85f : 0.5f);
+
+    PointF origin         = m_clientRect.at(alignment) + Point(m_alignmentOffset - m_visibleOffset);
+    // Only paragraphs intersecting the client area are painted
+    uint32_t first        = paragraphAtY(m_clientRect.y1 - origin.y);
+    uint32_t last         = paragraphAtY(m_clientRect.y2 - origin.y);
+    for (uint32_t p = first; p <= last; ++p) {
+        const PreparedText& prepared = m_paragraphs[p].prepared;
+        PointF pos                   = origin + PointF(0.f, paragraphBaseline(p));
+        Range<uint32_t> range        = m_document.paragraphRange(p);
+        Range<uint32_t> selected     = selection.intersection(range);
+        if (!selected.empty()) {
+            canvas.setFillColor(selectionColor);
+            canvas.fillTextSelection(pos, prepared, { selected.min - range.min, selected.max - range.min });
+        }
+        canvas.setFillColor(textColor);
+        canvas.fillText(pos, prepared);
+    }
 
     if (isFocused() && m_blinkState && !isDisabled()) {
-        uint32_t caretGrapheme =
-            m_preparedText.characterToGrapheme(std::clamp(cursor, 0u, uint32_t(m_cachedText.size())));
+        uint32_t offset              = std::min(cursor, m_document.size());
+        uint32_t p                   = m_document.paragraphAt(offset);
+        const PreparedText& prepared = m_paragraphs[p].prepared;
+        uint32_t caretGrapheme       = prepared.characterToGrapheme(offset - m_document.paragraphStart(p));
 
-        uint32_t lineIndex = m_preparedText.graphemeToLine(caretGrapheme);
+        uint32_t lineIndex           = prepared.graphemeToLine(caretGrapheme);
         if (lineIndex != UINT32_MAX) {
-            const auto& line = m_preparedText.lines[lineIndex];
-            Rectangle caretRect(m_clientRect.at(alignment) + Point(m_alignmentOffset - m_visibleOffset) +
-                                    Point(m_preparedText.caretPositions[caretGrapheme], line.baseline) +
-                                    Point(0, -line.ascDesc.ascender),
+            const auto& line = prepared.lines[lineIndex];
+            Rectangle caretRect(Point(origin + PointF(prepared.graphemeToCaret(caretGrapheme).x,
+                                                      paragraphBaseline(p) + line.baseline -
+                                                          line.ascDesc.ascender)),
                                 Size(1_idp, line.ascDesc.height()));
             canvas.setFillColor(textColor);
             canvas.fillRect(caretRect, 0.f);
@@ -214,7 +318,8 @@ void TextEditor::paint(Canvas& canvas) const {
     }
 }
 
-void TextEditor::normalizeCursor(uint32_t textLen) {
+void TextEditor::normalizeCursor() {
+    const uint32_t textLen     = m_document.size();
     uint32_t newCursor         = std::clamp(cursor, 0u, textLen);
     uint32_t newSelectedLength = std::clamp(cursor + selectedLength, 0u, textLen) - cursor;
     if (newCursor != cursor || newSelectedLength != selectedLength) {
@@ -224,26 +329,30 @@ void TextEditor::normalizeCursor(uint32_t textLen) {
     }
 }
 
-void TextEditor::makeCursorVisible(uint32_t textLen) {
-    if (!m_preparedText.hasCaretData() || m_preparedText.caretPositions.size() <= 1) {
+void TextEditor::makeCursorVisible() {
+    updateLayout();
+    if (m_document.empty()) {
         m_visibleOffset = { 0, 0 };
         invalidate();
         return;
     }
-    SizeF bounds = m_preparedText.bounds().size();
-    if (std::ceil(bounds.width) < m_clientRect.width() && std::ceil(bounds.height) < m_clientRect.height()) {
+    if (std::ceil(m_contentSize.width) < m_clientRect.width() &&
+        std::ceil(m_contentSize.height) < m_clientRect.height()) {
         m_visibleOffset = { 0, 0 };
         invalidate();
         return;
     }
 
-    uint32_t grapheme  = m_preparedText.characterToGrapheme(cursor);
-    uint32_t lineIndex = m_preparedText.graphemeToLine(grapheme);
+    uint32_t offset              = std::min(cursor, m_document.size());
+    uint32_t p                   = m_document.paragraphAt(offset);
+    const PreparedText& prepared = m_paragraphs[p].prepared;
+    uint32_t grapheme            = prepared.characterToGrapheme(offset - m_document.paragraphStart(p));
+    uint32_t lineIndex           = prepared.graphemeToLine(grapheme);
     if (lineIndex == UINT32_MAX)
         return;
-    const auto& line = m_preparedText.lines[lineIndex];
-    float caretx     = m_preparedText.caretPositions[grapheme];
-    float carety     = line.baseline;
+    const auto& line = prepared.lines[lineIndex];
+    float caretx     = prepared.graphemeToCaret(grapheme).x;
+    float carety     = paragraphBaseline(p) + line.baseline;
 
     m_visibleOffset -= m_alignmentOffset;
 
@@ -263,12 +372,17 @@ void TextEditor::makeCursorVisible(uint32_t textLen) {
 }
 
 uint32_t TextEditor::caretToOffset(PointF pt) const {
-    if (!m_preparedText.hasCaretData() || m_preparedText.caretPositions.size() == 1) {
+    if (m_document.empty()) {
         return 0;
     }
+    updateLayout();
     PointF alignment{ toFloatAlign(m_textAlign), toFloatAlign(m_textVerticalAlign) };
-    return m_preparedText.graphemeToCharacter(m_preparedText.caretToGrapheme(
-        Point(pt) - (m_clientRect.at(alignment) + Point(m_alignmentOffset - m_visibleOffset))));
+    PointF local = Point(pt) - (m_clientRect.at(alignment) + Point(m_alignmentOffset - m_visibleOffset));
+    uint32_t p   = paragraphAtY(local.y);
+    const PreparedText& prepared = m_paragraphs[p].prepared;
+    uint32_t grapheme            = prepared.caretToGrapheme(local - PointF(0.f, paragraphBaseline(p)));
+    Range<uint32_t> range        = m_document.paragraphRange(p);
+    return std::min(range.min + prepared.graphemeToCharacter(grapheme), range.max);
 }
 
 static bool char_is_alphanum(char32_t ch) {
@@ -277,25 +391,19 @@ static bool char_is_alphanum(char32_t ch) {
 }
 
 void TextEditor::selectWordAtCursor() {
-    std::u32string text = utf8ToUtf32(m_text);
-    normalizeCursor(text.size());
-    const int cursorPos = cursor;
-    for (int i = cursorPos;; i--) {
-        if (i < 0 || !char_is_alphanum(text[i])) {
-            cursor = i + 1;
-            break;
-        }
-    }
-    for (int i = cursorPos;; i++) {
-        if (i >= text.size() || !char_is_alphanum(text[i])) {
-            selectedLength = i - cursor;
-            break;
-        }
-    }
-    selectedLength = -selectedLength;
-    cursor         = cursor - selectedLength;
+    normalizeCursor();
+    const uint32_t p            = m_document.paragraphAt(cursor);
+    const Range<uint32_t> range = m_document.paragraphRange(p);
+    const std::u32string& text  = m_document.paragraph(p);
+    uint32_t begin              = cursor - range.min;
+    uint32_t end                = begin;
+    while (begin > 0 && char_is_alphanum(text[begin - 1]))
+        --begin;
+    while (end < text.size() && char_is_alphanum(text[end]))
+        ++end;
+    cursor         = range.min + end;
+    selectedLength = -int32_t(end - begin);
     selectionChanged();
-    normalizeCursor(text.size());
 }
 
 void TextEditor::onEvent(Event& event) {
@@ -303,13 +411,11 @@ void TextEditor::onEvent(Event& event) {
 
     if (isDisabled())
         return;
-    const Rectangle textRect = m_clientRect;
-    std::u32string text;
     if (event.doubleClicked()) {
         selectWordAtCursor();
         event.stopPropagation();
     } else if (event.tripleClicked()) {
-        selectAll(utf8ToUtf32(m_text));
+        selectAll();
         event.stopPropagation();
     } else if (auto e = event.as<EventFocused>()) {
         if (e->keyboard) {
@@ -319,24 +425,22 @@ void TextEditor::onEvent(Event& event) {
     }
     switch (const auto [flag, offset, mods] = event.dragged(m_mouseSelection); flag) {
     case DragEvent::Started: {
-        text = utf8ToUtf32(m_text);
         resetBlinking();
         focus();
         cursor         = caretToOffset(Point(*event.as<EventMouse>()->downPoint));
         selectedLength = 0;
         selectionChanged();
-        normalizeCursor(text.size());
+        normalizeCursor();
         m_startCursorDragging = caretToOffset(Point(*event.as<EventMouse>()->downPoint));
         event.stopPropagation();
     } break;
     case DragEvent::Dragging: {
-        text = utf8ToUtf32(m_text);
         resetBlinking();
         const int endCursor = caretToOffset(Point(event.as<EventMouse>()->point));
         selectedLength      = m_startCursorDragging - endCursor;
         cursor              = endCursor;
         selectionChanged();
-        normalizeCursor(text.size());
+        normalizeCursor();
         invalidate();
         event.stopPropagation();
     } break;
@@ -348,64 +452,60 @@ void TextEditor::onEvent(Event& event) {
     }
 
     if (event.type() == EventType::KeyPressed || event.type() == EventType::CharacterTyped) {
-        text = utf8ToUtf32(m_text);
-
         resetBlinking();
-        normalizeCursor(text.size());
+        normalizeCursor();
         if (auto ch = event.as<EventCharacterTyped>()) {
-            typeCharacter(text, ch->character);
+            typeCharacter(ch->character);
             event.stopPropagation();
         } else {
             switch (auto e = event.as<EventKeyPressed>(); e->key) {
             case KeyCode::A:
                 if ((e->mods & KeyModifiers::Regular) == KeyModifiers::ControlOrCommand) {
-                    selectAll(text);
-                    makeCursorVisible(m_cachedText.size());
+                    selectAll();
+                    makeCursorVisible();
                     event.stopPropagation();
                 }
                 break;
             case KeyCode::V:
                 if ((e->mods & KeyModifiers::Regular) == KeyModifiers::ControlOrCommand) {
-                    pasteFromClipboard(text);
+                    pasteFromClipboard();
                     event.stopPropagation();
-                    setTextInternal(utf32ToUtf8(normalizeCompose(text)));
                 }
                 break;
             case KeyCode::X:
                 if ((e->mods & KeyModifiers::Regular) == KeyModifiers::ControlOrCommand) {
-                    cutToClipboard(text);
+                    cutToClipboard();
                     event.stopPropagation();
-                    setTextInternal(utf32ToUtf8(normalizeCompose(text)));
                 }
                 break;
             case KeyCode::C:
                 if ((e->mods & KeyModifiers::Regular) == KeyModifiers::ControlOrCommand) {
-                    copyToClipboard(text);
+                    copyToClipboard();
                     event.stopPropagation();
                 }
                 break;
             case KeyCode::Up:
                 if (m_multiline) {
                     moveCursor(MoveCursor::Up, (e->mods & KeyModifiers::Regular) == KeyModifiers::Shift);
-                    makeCursorVisible(m_cachedText.size());
+                    makeCursorVisible();
                     event.stopPropagation();
                 }
                 break;
             case KeyCode::Down:
                 if (m_multiline) {
                     moveCursor(MoveCursor::Down, (e->mods & KeyModifiers::Regular) == KeyModifiers::Shift);
-                    makeCursorVisible(m_cachedText.size());
+                    makeCursorVisible();
                     event.stopPropagation();
                 }
                 break;
             case KeyCode::Left:
                 moveCursor(MoveCursor::Left, (e->mods & KeyModifiers::Regular) == KeyModifiers::Shift);
-                makeCursorVisible(m_cachedText.size());
+                makeCursorVisible();
                 event.stopPropagation();
                 break;
             case KeyCode::Right:
                 moveCursor(MoveCursor::Right, (e->mods & KeyModifiers::Regular) == KeyModifiers::Shift);
-                makeCursorVisible(m_cachedText.size());
+                makeCursorVisible();
                 event.stopPropagation();
                 break;
             case KeyCode::Home:
@@ -413,51 +513,55 @@ void TextEditor::onEvent(Event& event) {
                                ? MoveCursor::TextBeginning
                                : MoveCursor::LineBeginning,
                            (e->mods & KeyModifiers::Regular) == KeyModifiers::Shift);
-                makeCursorVisible(m_cachedText.size());
+                makeCursorVisible();
                 event.stopPropagation();
                 break;
             case KeyCode::End:
                 moveCursor((e->mods & KeyModifiers::Regular) == KeyModifiers::Control ? MoveCursor::TextEnd
                                                                                       : MoveCursor::LineEnd,
                            (e->mods & KeyModifiers::Regular) == KeyModifiers::Shift);
-                makeCursorVisible(m_cachedText.size());
+                makeCursorVisible();
                 event.stopPropagation();
                 break;
             case KeyCode::Backspace:
                 if (selectedLength) {
-                    deleteSelection(text);
+                    deleteSelection();
                 } else {
                     // delete one codepoint
                     if (cursor > 0) {
-                        text.erase(cursor - 1, 1);
                         cursor = cursor - 1; // no need to align
                         selectionChanged();
+                        replaceText({ cursor, cursor + 1 }, {});
                     }
                 }
                 event.stopPropagation();
-                setTextInternal(utf32ToUtf8(normalizeCompose(text)));
                 break;
             case KeyCode::Del:
                 if (selectedLength) {
-                    deleteSelection(text);
+                    deleteSelection();
                 } else {
-                    // delete whole grapheme
-                    if (cursor < text.size()) {
-                        auto endOfGrapheme =
-                            std::upper_bound(m_preparedText.graphemeBoundaries.begin(),
-                                             m_preparedText.graphemeBoundaries.end(), cursor);
-                        if (endOfGrapheme != m_preparedText.graphemeBoundaries.end())
-                            text.erase(cursor, *endOfGrapheme - cursor);
+                    // delete whole grapheme, or the line feed at the end of a paragraph
+                    if (cursor < m_document.size()) {
+                        updateLayout();
+                        const uint32_t p            = m_document.paragraphAt(cursor);
+                        const Range<uint32_t> range = m_document.paragraphRange(p);
+                        uint32_t end                = cursor + 1;
+                        if (cursor < range.max) {
+                            const PreparedText& prepared = m_paragraphs[p].prepared;
+                            end = std::min(range.min + prepared.graphemeToCharacter(
+                                                           prepared.characterToGrapheme(cursor - range.min) + 1),
+                                           range.max);
+                        }
                         selectionChanged();
+                        replaceText({ cursor, end }, {});
                     }
                 }
                 event.stopPropagation();
-                setTextInternal(utf32ToUtf8(normalizeCompose(text)));
                 break;
             case KeyCode::Enter:
             case KeyCode::NumEnter:
                 if (m_multiline) {
-                    typeCharacter(text, '\n');
+                    typeCharacter('\n');
                     event.stopPropagation();
                 } else {
                     if (m_onEnter.trigger())
@@ -468,19 +572,20 @@ void TextEditor::onEvent(Event& event) {
                 break;
             }
         }
-        normalizeCursor(text.size());
+        normalizeCursor();
     }
 }
 
 void TextEditor::selectAll() {
-    std::u32string t = utf8ToUtf32(m_text);
-    selectAll(t);
+    cursor         = m_document.size();
+    selectedLength = -int32_t(m_document.size());
+    selectionChanged();
 }
 
 void TextEditor::deleteSelection() {
-    std::u32string t = utf8ToUtf32(m_text);
-    deleteSelection(t);
-    setTextInternal(utf32ToUtf8(t));
+    if (selectedLength) {
+        replaceSelection({});
+    }
 }
 
 constexpr std::u32string_view internalNewLine = U"\n";
@@ -503,26 +608,30 @@ static std::u32string newLinesToInternal(std::u32string text) {
 }
 
 void TextEditor::pasteFromClipboard() {
-    std::u32string t = utf8ToUtf32(m_text);
-    pasteFromClipboard(t);
-    setTextInternal(utf32ToUtf8(t));
+    if (auto t = Clipboard::getText()) {
+        pasteText(*t);
+    }
 }
 
-void TextEditor::copyToClipboard() {
-    std::u32string t = utf8ToUtf32(m_text);
-    copyToClipboard(t);
+void TextEditor::pasteText(std::string_view text) {
+    // A single-line editor has nowhere to put a line break
+    std::u32string t32 = newLinesConvert(utf8ToUtf32(text), m_multiline ? internalNewLine : U" ");
+    replaceSelection(normalizeCompose(std::move(t32)));
 }
 
-void TextEditor::cutToClipboard() {
-    std::u32string t = utf8ToUtf32(m_text);
-    cutToClipboard(t);
-    setTextInternal(utf32ToUtf8(t));
+void TextEditor::copyToClipboard() {
+    if (selectedLength) {
+        if (m_passwordChar == 0)
+            Clipboard::setText(
+                utf32ToUtf8(newLinesToNative(normalizeCompose(m_document.text(this->selection())))));
+    }
 }
 
-void TextEditor::selectAll(const std::u32string& text) {
-    cursor         = text.size();
-    selectedLength = -text.size();
-    selectionChanged();
+void TextEditor::cutToClipboard() {
+    if (selectedLength) {
+        copyToClipboard();
+        deleteSelection();
+    }
 }
 
 void TextEditor::selectionChanged() {
@@ -532,88 +641,95 @@ void TextEditor::selectionChanged() {
 
 void TextEditor::onSelectionChanged() {}
 
-void TextEditor::deleteSelection(std::u32string& text) {
-    if (selectedLength) {
-        const Range<int32_t> selection = this->selection();
-        text.erase(selection.min, selection.distance());
-        cursor         = selection.min;
-        selectedLength = 0;
-        selectionChanged();
+void TextEditor::editText(Range<uint32_t> range, std::u32string_view text) {
+    if (m_textIsValidUtf8) {
+        // Byte offsets come from the paragraph the edit starts in, not from a scan of m_text
+        const uint32_t begin = m_document.utf8Offset(range.min);
+        const uint32_t end   = m_document.utf8Offset(range.max);
+        m_text.replace(begin, end - begin, utf32ToUtf8(text));
+    }
+    TextDocument::Change change = m_document.replace(range, text);
+    if (!m_textIsValidUtf8) {
+        m_text            = utf32ToUtf8(m_document.text());
+        m_textIsValidUtf8 = true;
+    }
+    if (m_paragraphs.size() >= change.first + change.removed) {
+        m_paragraphs.erase(m_paragraphs.begin() + change.first,
+                           m_paragraphs.begin() + change.first + change.removed);
+        m_paragraphs.insert(m_paragraphs.begin() + change.first, change.inserted, ParagraphLayout{});
+        m_validTops = std::min(m_validTops, change.first);
     }
 }
 
-void TextEditor::pasteFromClipboard(std::u32string& text) {
-    if (auto t = Clipboard::getText()) {
-        deleteSelection(text);
-        std::u32string t32 = utf8ToUtf32(*t);
-        t32                = newLinesToInternal(std::move(t32));
-        text.insert(cursor, t32);
-        cursor         = cursor + t32.size();
+void TextEditor::replaceText(Range<uint32_t> range, std::u32string_view text) {
+    range.max = std::min(range.max, m_document.size());
+    range.min = std::min(range.min, range.max);
+    if (range.empty() && text.empty())
+        return;
+    const uint32_t first = m_document.paragraphAt(range.min);
+    editText(range, text);
+
+    // Combining marks typed after their base (dead keys, IME) compose with it
+    const uint32_t last = m_document.paragraphAt(range.min + text.size());
+    for (uint32_t i = first; i <= last; ++i) {
+        std::u32string composed = normalizeCompose(m_document.paragraph(i));
+        if (composed == m_document.paragraph(i))
+            continue;
+        const Range<uint32_t> paragraph = m_document.paragraphRange(i);
+        if (cursor >= paragraph.max) {
+            cursor = cursor + composed.size() - paragraph.distance();
+        } else if (cursor > paragraph.min) {
+            const size_t before = normalizeCompose(m_document.text({ paragraph.min, cursor })).size();
+            cursor              = paragraph.min + std::min(before, composed.size());
+        }
         selectedLength = 0;
         selectionChanged();
+        editText(paragraph, composed);
     }
-}
+    normalizeCursor();
 
-void TextEditor::copyToClipboard(const std::u32string& text) {
-    if (selectedLength) {
-        const Range<int32_t> selection = this->selection();
-        if (m_passwordChar == 0)
-            Clipboard::setText(utf32ToUtf8(
-                newLinesToNative(normalizeCompose(text.substr(selection.min, selection.distance())))));
-    }
+    bindings->notify(&m_text);
+    updateState();
 }
 
-void TextEditor::cutToClipboard(std::u32string& text) {
-    if (selectedLength) {
-        const Range<int32_t> selection = this->selection();
-        if (m_passwordChar == 0)
-            Clipboard::setText(utf32ToUtf8(
-                newLinesToNative(normalizeCompose(text.substr(selection.min, selection.distance())))));
-        deleteSelection(text);
-    }
+void TextEditor::replaceSelection(std::u32string_view text) {
+    const Range<uint32_t> selection = this->selection();
+    cursor                          = selection.min + text.size();
+    selectedLength                  = 0;
+    selectionChanged();
+    replaceText(selection, text);
 }
 
-void TextEditor::updateGraphemes() {
-    m_preparedText = fonts->prepare(
-        m_cachedFont, TextWithOptions{ m_text.empty() ? utf8ToUtf32(m_placeholder) : m_cachedText,
-                                       m_multiline ? TextOptions::Default : TextOptions::SingleLine });
+void TextEditor::onTextChanged() {
+    m_document.assign(utf8ToUtf32(m_text));
+    m_textIsValidUtf8 = utf8Validate(m_text) == UtfValidation::Valid;
+    onShapingChanged();
+}
 
-    m_preparedText.updateCaretData();
+void TextEditor::onShapingChanged() {
+    m_paragraphs.clear();
+    updateState();
 }
 
 void TextEditor::updateState() {
     invalidate();
-    std::u32string text32 = utf8ToUtf32(m_text);
-
-    if (m_passwordChar) {
-        std::fill(text32.begin(), text32.end(), m_passwordChar);
-    }
-    if (text32 != m_cachedText || m_cachedFont != font()) {
-        m_cachedText = std::move(text32);
+    if (m_cachedFont != font()) {
         m_cachedFont = font();
-        updateGraphemes();
+        m_paragraphs.clear();
     }
-    makeCursorVisible(m_cachedText.size());
-}
-
-void TextEditor::setTextInternal(std::string text) {
-    if (text != m_text) {
-        m_text = std::move(text);
-        bindings->notify(&m_text);
-        updateState();
+    if (m_document.empty() && !m_paragraphs.empty()) {
+        // The placeholder may have changed
+        m_paragraphs.front().shaped = false;
     }
+    makeCursorVisible();
 }
 
 void TextEditor::onLayoutUpdated() {
     updateState();
 }
 
-void TextEditor::typeCharacter(std::u32string& text, char32_t character) {
-    deleteSelection(text);
-    text.insert(text.begin() + cursor, character);
-    cursor = cursor + 1; // no need to align
-    selectionChanged();
-    setTextInternal(utf32ToUtf8(normalizeCompose(text)));
+void TextEditor::typeCharacter(char32_t character) {
+    replaceSelection(std::u32string_view(&character, 1));
 }
 
 PasswordEditor::PasswordEditor(Construction construction, ArgumentsView<PasswordEditor> args)
@@ -0,0 +1,379 @@
+/*
+ * Brisk
+ *
+ * Cross-platform application framework
+ * --------------------------------------------------------------
+ *
+ * Copyright (C) 2025 Brisk Developers
+ *
+ * This file is part of the Brisk library.
+ *
+ * Brisk is dual-licensed under the GNU General Public License, version 2 (GPL-2.0+),
+ * and a commercial license. You may use, modify, and distribute this software under
+ * the terms of the GPL-2.0+ license if you comply with its conditions.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you do not wish to be bound by the GPL-2.0+ license, you must purchase a commercial
+ * license. For commercial licensing options, please visit: https://brisklib.com
+ */
+#include <brisk/widgets/VirtualList.hpp>
+#include <bit>
+
+namespace Brisk {
+
+namespace Internal {
+
+static size_t lowestBit(size_t i) noexcept {
+    return i & (~i + 1);
+}
+
+void RowOffsets::reset(size_t count, float estimatedHeight) {
+    m_estimatedHeight = estimatedHeight;
+    m_heights.assign(count, -1.f);
+    m_deltas.assign(count + 1, 0.f);
+}
+
+size_t RowOffsets::size() const noexcept {
+    return m_heights.size();
+}
+
+float RowOffsets::estimatedHeight() const noexcept {
+    return m_estimatedHeight;
+}
+
+bool RowOffsets::setHeight(size_t index, float height) {
+    BRISK_ASSERT(index < m_heights.size());
+    const float delta = height - this->height(index);
+    m_heights[index]  = height;
+    if (delta == 0.f)
+        return false;
+    for (size_t i = index + 1; i < m_deltas.size(); i += lowestBit(i)) {
+        m_deltas[i] += delta;
+    }
+    return true;
+}
+
+float RowOffsets::height(size_t index) const noexcept {
+    return m_heights[index] < 0.f ? m_estimatedHeight : m_heights[index];
+}
+
+bool RowOffsets::isMeasured(size_t index) const noexcept {
+    return m_heights[index] >= 0.f;
+}
+
+float RowOffsets::offset(size_t index) const noexcept {
+    BRISK_ASSERT(index <= m_heights.size());
+    float result = index * m_estimatedHeight;
+    for (size_t i = index; i > 0; i -= lowestBit(i)) {
+        result += m_deltas[i];
+    }
+    return result;
+}
+
+float RowOffsets::total() const noexcept {
+    return offset(m_heights.size());
+}
+
+size_t RowOffsets::indexAt(float offset) const noexcept {
+    if (m_heights.empty())
+        return 0;
+    // Descend the Fenwick tree, each node covers `step` rows
+    size_t index = 0;
+    float sum    = 0.f;
+    for (size_t step = std::bit_floor(m_heights.size()); step > 0; step >>= 1) {
+        const size_t next = index + step;
+        if (next > m_heights.size())
+            continue;
+        const float blockHeight = m_deltas[next] + step * m_estimatedHeight;
+        if (sum + blockHeight <= offset) {
+            index = next;
+            sum += blockHeight;
+        }
+    }
+    return std::min(index, m_heights.size() - 1);
+}
+
+} // namespace Internal
+
+VirtualList::VirtualList(Construction construction, size_t rowCount, RowFactory factory, RowBinder binder,
+                         ArgumentsView<VirtualList> args)
+    : Widget{ construction,
+              std::tuple{
+                  Arg::layout         = Layout::Vertical,
+                  Arg::overflowScroll = OverflowScrollBoth{ OverflowScroll::Disable, OverflowScroll::Enable },
+                  Arg::contentOverflow =
+                      ContentOverflowBoth{ ContentOverflow::Default, ContentOverflow::Allow },
+              } },
+      m_rowCount(rowCount), m_factory(std::move(factory)), m_binder(std::move(binder)) {
+    args.apply(this);
+    if (!widgets().empty()) {
+        BRISK_LOG_WARN("VirtualList: {} child widgets are ignored, rows are created by the factory",
+                       widgets().size());
+        clear();
+    }
+    // Spacers stand in for the rows above and below the materialized ones
+    apply(rcnew Widget{});
+    apply(rcnew Widget{});
+    listenSelection();
+}
+
+Rc<Widget> VirtualList::cloneThis() const {
+    auto result = rcnew VirtualList(*this);
+    Internal::fixClone(result.get());
+    result->m_pool.clear();
+    result->listenSelection();
+    return result;
+}
+
+void VirtualList::listenSelection() {
+    bindings->listen(
+        Value{ &m_selection }, lifetime() | [this]() {
+            updateSelected();
+        });
+}
+
+size_t VirtualList::numMaterialized() const noexcept {
+    return widgets().size() - 2;
+}
+
+Range<size_t> VirtualList::materializedRows() const noexcept {
+    return { m_first, m_first + numMaterialized() };
+}
+
+std::optional<size_t> VirtualList::rowIndex(const Widget* row) const noexcept {
+    const WidgetPtrs& w = widgets();
+    for (size_t i = 0; i < numMaterialized(); ++i) {
+        if (w[i + 1].get() == row)
+            return m_first + i;
+    }
+    return std::nullopt;
+}
+
+Widget* VirtualList::rowWidget(size_t index) const noexcept {
+    if (index < m_first || index >= m_first + numMaterialized())
+        return nullptr;
+    return widgets()[index - m_first + 1].get();
+}
+
+Rc<Widget> VirtualList::acquireRow(size_t index) {
+    Rc<Widget> row;
+    if (!m_pool.empty()) {
+        row = std::move(m_pool.back());
+        m_pool.pop_back();
+        m_binder(row.get(), index);
+    } else {
+        row = m_factory(index);
+    }
+    row->selected = m_selection.isSelected(index);
+    return row;
+}
+
+void VirtualList::releaseRow(size_t position) {
+    Rc<Widget> row = widgets()[position];
+    removeAt(position);
+    if (m_binder)
+        m_pool.push_back(std::move(row));
+}
+
+void VirtualList::updateRows() {
+    const float estimated = dp(m_estimatedRowHeight);
+    if (m_offsets.size() != m_rowCount || m_offsets.estimatedHeight() != estimated) {
+        while (numMaterialized() > 0) {
+            releaseRow(numMaterialized());
+        }
+        m_first = 0;
+        m_offsets.reset(m_rowCount, estimated);
+    }
+
+    // Before the first layout the viewport height is the best guess for the list height
+    const int height    = m_rect.height() > 0 ? m_rect.height() : viewportSize().height;
+    const int scroll    = scrollOffset(Orientation::Vertical);
+    m_builtScrollOffset = scroll;
+    m_builtHeight       = m_rect.height();
+
+    size_t first        = 0;
+    size_t last         = 0;
+    if (m_rowCount > 0) {
+        const float overscan = std::max(height * 0.5f, estimated);
+        first                = m_offsets.indexAt(scroll - overscan);
+        last                 = m_offsets.indexAt(scroll + height + overscan) + 1;
+    }
+
+    const size_t oldFirst = m_first;
+    const size_t oldLast  = m_first + numMaterialized();
+    if (first >= oldLast || last <= oldFirst) {
+        while (numMaterialized() > 0) {
+            releaseRow(numMaterialized());
+        }
+        for (size_t i = first; i < last; ++i) {
+            insertChild(widgets().end() - 1, acquireRow(i));
+        }
+    } else {
+        for (size_t i = last; i < oldLast; ++i) {
+            releaseRow(numMaterialized());
+        }
+        for (size_t i = oldFirst; i < first; ++i) {
+            releaseRow(1);
+        }
+        for (size_t i = oldFirst; i-- > first;) {
+            insertChild(widgets().begin() + 1, acquireRow(i));
+        }
+        for (size_t i = std::max(oldLast, first); i < last; ++i) {
+            insertChild(widgets().end() - 1, acquireRow(i));
+        }
+    }
+    m_first = first;
+    updateSpacers();
+}
+
+void VirtualList::updateSpacers() {
+    const size_t last         = m_first + numMaterialized();
+    const float below         = m_offsets.total() - m_offsets.offset(last);
+    widgets().front()->height = Length{ m_offsets.offset(m_first), LengthUnit::DevicePixels };
+    widgets().back()->height  = Length{ below, LengthUnit::DevicePixels };
+}
+
+void VirtualList::updateSelected() {
+    for (size_t i = 0; i < numMaterialized(); ++i) {
+        widgets()[i + 1]->selected = m_selection.isSelected(m_first + i);
+    }
+}
+
+void VirtualList::refreshRows() {
+    if (m_binder) {
+        for (size_t i = 0; i < numMaterialized(); ++i) {
+            m_binder(widgets()[i + 1].get(), m_first + i);
+        }
+        updateSelected();
+    } else {
+        while (numMaterialized() > 0) {
+            releaseRow(numMaterialized());
+        }
+        updateRows();
+    }
+}
+
+void VirtualList::scrollToRow(size_t index) {
+    if (index >= m_offsets.size())
+        return;
+    const int top    = std::lround(m_offsets.offset(index));
+    const int bottom = std::lround(m_offsets.offset(index + 1));
+    int scroll       = scrollOffset(Orientation::Vertical);
+    if (top < scroll)
+        scroll = top;
+    else if (bottom > scroll + m_rect.height())
+        scroll = bottom - m_rect.height();
+    setScrollOffset(Orientation::Vertical, scroll);
+    // The offset is based on estimated heights, correct it once the row has been laid out
+    m_revealRow = index;
+    requestRebuild();
+}
+
+Selection<size_t>& VirtualList::selection() noexcept {
+    return m_selection;
+}
+
+void VirtualList::setSelection(Selection<size_t> selection) {
+    m_selection = std::move(selection);
+    bindings->notify(&m_selection);
+}
+
+void VirtualList::onRowCountChanged() {
+    requestRebuild();
+}
+
+void VirtualList::rebuild(bool force) {
+    Widget::rebuild(force);
+    updateRows();
+}
+
+void VirtualList::attachedToTree() {
+    Widget::attachedToTree();
+    requestRebuild();
+}
+
+void VirtualList::onLayoutUpdated() {
+    Widget::onLayoutUpdated();
+    const WidgetPtrs& w = widgets();
+    bool changed        = false;
+    float shift         = 0.f;
+    for (size_t i = 0; i < numMaterialized(); ++i) {
+        const Rectangle rect = w[i + 1]->rect();
+        // Distance to the next row includes the gap between rows
+        const float height   = w[i + 2]->rect().y1 - rect.y1;
+        const float previous = m_offsets.height(m_first + i);
+        if (m_offsets.setHeight(m_first + i, height)) {
+            changed = true;
+            if (rect.y2 <= m_rect.y1)
+                shift += height - previous;
+        }
+    }
+    if (Widget* row = m_revealRow ? rowWidget(*m_revealRow) : nullptr) {
+        const Rectangle rect = row->rect();
+        if (rect.y1 < m_rect.y1)
+            shift = rect.y1 - m_rect.y1;
+        else if (rect.y2 > m_rect.y2)
+            shift = std::min(rect.y2 - m_rect.y2, rect.y1 - m_rect.y1);
+        else
+            shift = 0.f;
+        m_revealRow.reset();
+    }
+    if (shift != 0.f) {
+        // Keep the visible rows in place when rows above them turn out to differ from the estimate
+        setScrollOffset(Orientation::Vertical, scrollOffset(Orientation::Vertical) + std::lround(shift));
+    }
+    if (changed || scrollOffset(Orientation::Vertical) != m_builtScrollOffset ||
+        m_rect.height() != m_builtHeight) {
+        requestRebuild();
+    }
+}
+
+void VirtualList::onEvent(Event& event) {
+    Widget::onEvent(event);
+    if (!m_selectable)
+        return;
+    auto pressed = event.as<EventMouseButtonPressed>();
+    if (pressed && pressed->button == MouseButton::Left) {
+        for (size_t i = 0; i < numMaterialized(); ++i) {
+            if (!widgets()[i + 1]->rect().contains(Point(pressed->point)))
+                continue;
+            const size_t index = m_first + i;
+            if (pressed->mods && KeyModifiers::Shift)
+                m_selection.selectRange(index);
+            else if (pressed->mods && KeyModifiers::Control)
+                m_selection.toggle(index);
+            else
+                m_selection.set(index);
+            bindings->notify(&m_selection);
+            event.stopPropagation();
+            break;
+        }
+    }
+}
+
+void VirtualTable::onChildAdded(Widget* w) {
+    VirtualList::onChildAdded(w);
+    if (TableRow* row = dynamicCast<TableRow*>(w)) {
+        row->bindColumns(columns);
+    }
+}
+
+void VirtualTable::releaseRow(size_t position) {
+    // Bound again by onChildAdded once the row is reused
+    if (TableRow* row = dynamicCast<TableRow*>(widgets()[position].get())) {
+        row->unbindColumns(columns);
+    }
+    VirtualList::releaseRow(position);
+}
+
+Rc<Widget> VirtualTable::cloneThis() const {
+    auto result = rcnew VirtualTable(*this);
+    Internal::fixClone(result.get());
+    result->m_pool.clear();
+    result->listenSelection();
+    return result;
+}
+
+} // namespace Brisk
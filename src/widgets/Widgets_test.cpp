@@ -19,6 +19,8 @@
  * license. For commercial licensing options, please visit: https://brisklib.com
  */
 #include <brisk/widgets/Widgets.hpp>
+#include <brisk/widgets/TextDocument.hpp>
+#include <brisk/widgets/VirtualList.hpp>
 #include <catch2/catch_all.hpp>
 #include <brisk/graphics/Palette.hpp>
 #include <brisk/gui/Icons.hpp>
@@ -37,6 +39,55 @@ TEST_CASE("Text") {
     CHECK(w->text.get() == "Initialize");
 }
 
+TEST_CASE("TextDocument") {
+    TextDocument doc;
+    CHECK(doc.empty());
+    CHECK(doc.paragraphCount() == 1);
+
+    TextDocument::Change change = doc.insert(0, U"abc\ndef\nghi");
+    CHECK(change.first == 0);
+    CHECK(change.removed == 1);
+    CHECK(change.inserted == 3);
+    CHECK(doc.size() == 11);
+    CHECK(doc.paragraphCount() == 3);
+    CHECK(doc.paragraph(1) == U"def");
+    CHECK(doc.paragraphStart(2) == 8);
+    CHECK(doc.paragraphRange(1).min == 4);
+    CHECK(doc.paragraphRange(1).max == 7);
+    CHECK(doc.paragraphAt(3) == 0);
+    CHECK(doc.paragraphAt(4) == 1);
+    CHECK(doc.paragraphAt(11) == 2);
+    CHECK(doc.at(3) == U'\n');
+    CHECK(doc.text({ 2, 9 }) == U"c\ndef\ng");
+
+    // Editing inside a paragraph touches only that paragraph
+    change = doc.replace({ 5, 6 }, U"EE");
+    CHECK(change.first == 1);
+    CHECK(change.removed == 1);
+    CHECK(change.inserted == 1);
+    CHECK(doc.text() == U"abc\ndEEf\nghi");
+    CHECK(doc.paragraphStart(2) == 9);
+
+    // Removing a line feed joins paragraphs
+    change = doc.erase({ 3, 4 });
+    CHECK(change.first == 0);
+    CHECK(change.removed == 2);
+    CHECK(change.inserted == 1);
+    CHECK(doc.paragraphCount() == 2);
+    CHECK(doc.text() == U"abcdEEf\nghi");
+
+    // UTF-8 offsets count the bytes of each codepoint and of the line feeds
+    doc.assign(U"a\u00E9\nb\U0001F600c");
+    CHECK(doc.utf8Offset(2) == 3);
+    CHECK(doc.utf8Offset(3) == 4);
+    CHECK(doc.utf8Offset(5) == 9);
+    CHECK(doc.utf8Offset(6) == 10);
+
+    doc.assign(U"");
+    CHECK(doc.empty());
+    CHECK(doc.paragraphCount() == 1);
+}
+
 class Row : public Widget {
     BRISK_DYNAMIC_CLASS(Row, Widget)
 public:
@@ -49,6 +100,267 @@ public:
           } {}
 };
 
+TEST_CASE("RowOffsets") {
+    Internal::RowOffsets offsets;
+    offsets.reset(1000, 10.f);
+    CHECK(offsets.total() == 10000.f);
+    CHECK(offsets.indexAt(-5.f) == 0);
+    CHECK(offsets.indexAt(15.f) == 1);
+    CHECK(offsets.indexAt(1e9f) == 999);
+
+    CHECK(offsets.setHeight(1, 30.f));
+    CHECK(!offsets.setHeight(1, 30.f));
+    CHECK(offsets.isMeasured(1));
+    CHECK(!offsets.isMeasured(2));
+    CHECK(offsets.offset(2) == 40.f);
+    CHECK(offsets.total() == 10020.f);
+    CHECK(offsets.indexAt(39.f) == 1);
+    CHECK(offsets.indexAt(40.f) == 2);
+}
+
+TEST_CASE("VirtualList") {
+    WidgetTree tree;
+    tree.disableTransitions();
+    pixelRatio() = 1.f;
+    tree.setViewportRectangle({ 0, 0, 200, 100 });
+
+    int created = 0;
+    Rc<VirtualList> list =
+        rcnew VirtualList{ 100'000,
+                           [&](size_t index) -> Rc<Widget> {
+                               ++created;
+                               return rcnew Widget{ height = 20 };
+                           },
+                           [](Widget* row, size_t index) {}, estimatedRowHeight = 10.f, height = 100 };
+    tree.setRoot(rcnew Widget{ layout = Layout::Vertical, list });
+    for (int i = 0; i < 3; ++i)
+        tree.update();
+
+    Range<size_t> rows = list->materializedRows();
+    CHECK(rows.min == 0);
+    CHECK(rows.max < 20);
+    REQUIRE(list->rowWidget(0));
+    CHECK(list->rowWidget(0)->rect().height() == 20);
+    CHECK(list->scrollSize(Orientation::Vertical) > 900'000);
+
+    list->scrollToRow(50'000);
+    for (int i = 0; i < 3; ++i)
+        tree.update();
+    rows = list->materializedRows();
+    CHECK(rows.min <= 50'000);
+    CHECK(rows.max > 50'000);
+    REQUIRE(list->rowWidget(50'000));
+    Rectangle rowRect = list->rowWidget(50'000)->rect();
+    CHECK(list->rect().intersection(rowRect) == rowRect);
+    CHECK(list->rowIndex(list->rowWidget(50'000)) == 50'000);
+    // Rows are recycled instead of being created for every index
+    CHECK(created < 40);
+
+    Selection<size_t> selection;
+    selection.set(50'000);
+    selection.selectRange(50'002);
+    CHECK(selection.selection.size() == 3);
+    list->setSelection(std::move(selection));
+    tree.update();
+    CHECK(list->rowWidget(50'001)->isSelected());
+    CHECK(!list->rowWidget(49'999)->isSelected());
+
+    // Changes made outside the list are picked up once notified
+    list->selection().set(49'999);
+    bindings->notify(&list->selection());
+    tree.update();
+    CHECK(list->rowWidget(49'999)->isSelected());
+    CHECK(!list->rowWidget(50'001)->isSelected());
+
+    Rc<VirtualList> withChildren = rcnew VirtualList{ 10, [](size_t) -> Rc<Widget> {
+                                                         return rcnew Widget{};
+                                                     },
+                                                      nullptr, rcnew Widget{} };
+    CHECK(withChildren->widgets().size() == 2);
+}
+
+TEST_CASE("VirtualTable") {
+    WidgetTree tree;
+    tree.disableTransitions();
+    pixelRatio() = 1.f;
+    tree.setViewportRectangle({ 0, 0, 400, 100 });
+
+    // Rows from 500 on have a wider first column
+    auto cellWidth = [](size_t index) {
+        return index >= 500 ? 120 : 60;
+    };
+    Rc<VirtualTable> table = rcnew VirtualTable{
+        1000,
+        [&](size_t index) -> Rc<Widget> {
+            return rcnew TableRow{
+                rcnew TableCell{ rcnew Widget{ width = cellWidth(index), height = 20 } },
+                rcnew TableCell{ rcnew Widget{ width = 30, height = 20 } },
+            };
+        },
+        [&](Widget* row, size_t index) {
+            row->widgets()[0]->widgets()[0]->width = cellWidth(index);
+        },
+        estimatedRowHeight = 20.f,
+        height             = 100,
+    };
+    tree.setRoot(rcnew Widget{ layout = Layout::Vertical, table });
+    auto update = [&]() {
+        for (int i = 0; i < 3; ++i)
+            tree.update();
+    };
+    auto columnWidth = [&](size_t index) {
+        REQUIRE(table->rowWidget(index));
+        return table->rowWidget(index)->widgets()[0]->rect().width();
+    };
+    update();
+    CHECK(columnWidth(0) == 60);
+
+    table->scrollToRow(900);
+    update();
+    CHECK(columnWidth(900) == 120);
+
+    // Rows left in the pool were bound to wide rows and must not widen the column
+    table->rowCount = 2;
+    update();
+    CHECK(table->materializedRows().max == 2);
+    CHECK(columnWidth(0) == 60);
+    CHECK(columnWidth(1) == 60);
+}
+
+namespace {
+// Feeds keyboard input to a focused TextEditor
+struct EditorInput {
+    InputQueue input;
+    WidgetTree tree{ &input };
+    Rc<TextEditor> editor;
+
+    explicit EditorInput(bool multiline) {
+        tree.disableTransitions();
+        pixelRatio() = 1.f;
+        tree.setViewportRectangle({ 0, 0, 400, 200 });
+        editor = rcnew TextEditor{ Arg::multiline = multiline, autofocus = true, width = 400 };
+        tree.setRoot(rcnew Widget{ layout = Layout::Vertical, editor });
+        for (int i = 0; i < 2; ++i)
+            tree.update();
+        REQUIRE(editor->hasFocus());
+    }
+
+    void type(std::u32string_view text) {
+        for (char32_t ch : text) {
+            input.addEvent(EventCharacterTyped{ .character = ch });
+        }
+        tree.update();
+    }
+
+    void press(KeyCode key, KeyModifiers mods = KeyModifiers::None, int times = 1) {
+        for (int i = 0; i < times; ++i) {
+            input.addEvent(EventKeyPressed{ EventKey{ EventInput{ {}, mods }, key } });
+        }
+        tree.update();
+    }
+};
+} // namespace
+
+TEST_CASE("TextEditor typing") {
+    EditorInput e(true);
+    e.type(U"abc");
+    CHECK(e.editor->text.get() == "abc");
+    CHECK(e.editor->cursor == 3);
+
+    e.press(KeyCode::Enter);
+    e.type(U"de");
+    CHECK(e.editor->text.get() == "abc\nde");
+    CHECK(e.editor->cursor == 6);
+
+    // Backspace joins the paragraphs once it reaches the line break
+    e.press(KeyCode::Backspace, KeyModifiers::None, 2);
+    CHECK(e.editor->text.get() == "abc\n");
+    CHECK(e.editor->cursor == 4);
+    e.press(KeyCode::Backspace);
+    CHECK(e.editor->text.get() == "abc");
+    CHECK(e.editor->cursor == 3);
+
+    // Del at the end of a paragraph removes the line break
+    e.press(KeyCode::Enter);
+    e.type(U"d");
+    e.press(KeyCode::Left, KeyModifiers::None, 2);
+    CHECK(e.editor->cursor == 3);
+    e.press(KeyCode::Del);
+    CHECK(e.editor->text.get() == "abcd");
+    CHECK(e.editor->cursor == 3);
+
+    // A combining mark composes with the character before it
+    e.press(KeyCode::End);
+    e.type(U"e\u0301");
+    CHECK(e.editor->text.get() == "abcd\u00E9");
+    CHECK(e.editor->cursor == 5);
+    e.press(KeyCode::Backspace);
+    CHECK(e.editor->text.get() == "abcd");
+    CHECK(e.editor->cursor == 4);
+
+    // Single-line editors leave Enter to onEnter
+    EditorInput single(false);
+    single.type(U"ab");
+    single.press(KeyCode::Enter);
+    CHECK(single.editor->text.get() == "ab");
+    CHECK(single.editor->cursor == 2);
+}
+
+TEST_CASE("TextEditor cursor between paragraphs") {
+    EditorInput e(true);
+    e.editor->text   = "abcdef\nab\nabcd";
+    e.editor->cursor = 6;
+
+    // The cursor keeps its horizontal position where the paragraph is long enough
+    e.press(KeyCode::Down);
+    CHECK(e.editor->cursor == 9);
+    e.press(KeyCode::Down);
+    CHECK(e.editor->cursor == 12);
+    e.press(KeyCode::Down);
+    CHECK(e.editor->cursor == 12);
+    e.press(KeyCode::Up);
+    CHECK(e.editor->cursor == 9);
+    e.press(KeyCode::Up);
+    CHECK(e.editor->cursor == 2);
+    e.press(KeyCode::Up);
+    CHECK(e.editor->cursor == 2);
+
+    e.press(KeyCode::Down, KeyModifiers::Shift);
+    CHECK(e.editor->cursor == 9);
+    CHECK(e.editor->selection().min == 2);
+    CHECK(e.editor->selection().max == 9);
+    CHECK(e.editor->text.get() == "abcdef\nab\nabcd");
+}
+
+TEST_CASE("TextEditor paste and cut") {
+    EditorInput single(false);
+    single.editor->pasteText("one\ntwo\r\nthree");
+    CHECK(single.editor->text.get() == "one two three");
+    CHECK(single.editor->cursor == 13);
+
+    EditorInput e(true);
+    e.editor->pasteText("hello\r\nworld");
+    CHECK(e.editor->text.get() == "hello\nworld");
+    CHECK(e.editor->cursor == 11);
+
+    // Replaces the selection
+    e.press(KeyCode::Left, KeyModifiers::Shift, 5);
+    e.editor->pasteText("brisk");
+    CHECK(e.editor->text.get() == "hello\nbrisk");
+    CHECK(e.editor->cursor == 11);
+
+    e.press(KeyCode::Left, KeyModifiers::Shift, 6);
+    e.press(KeyCode::X, KeyModifiers::ControlOrCommand);
+    CHECK(e.editor->text.get() == "hello");
+    CHECK(e.editor->cursor == 5);
+    CHECK(e.editor->selectedLength == 0);
+
+    // Nothing to cut without a selection
+    e.press(KeyCode::X, KeyModifiers::ControlOrCommand);
+    CHECK(e.editor->text.get() == "hello");
+    CHECK(e.editor->cursor == 5);
+}
+
 class Container : public Widget {
     BRISK_DYNAMIC_CLASS(Container, Widget)
 public:
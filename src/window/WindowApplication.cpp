@@ -78,6 +78,9 @@ WindowApplication::WindowApplication() : m_separateUiThread(separateUiThread) {
 
     PlatformWindow::initialize();
 
+    // Windows are repainted once the glyphs are ready, see GuiWindow::update
+    fonts->setAsyncColorGlyphs(true);
+
     if (m_separateUiThread) {
         m_uiThread = std::thread(&WindowApplication::uiThreadBody, this);
         m_uiThreadStarted.acquire();